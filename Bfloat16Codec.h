@@ -0,0 +1,244 @@
+//-----------------------------------------------------------------------------
+//
+//  Bulk bfloat16 <-> float32 conversion.
+//
+//  bfloat16 is just the upper 16 bits of a float32, so decoding is a shift.
+//  Encoding either truncates or rounds to nearest with ties to even, which is
+//  what the AVX-512 BF16 vcvtneps2bf16 instruction and most ML hardware do.
+//  Either way NaN's stay NaN (quieted), rather than truncating a NaN with only
+//  low payload bits into infinity.
+//
+//  vcvtneps2bf16 treats float32 denormals as zero, so those lanes are patched
+//  with the integer result to keep every path bit-identical to the scalar one.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+enum class Bfloat16Rounding
+{
+    NearestEven,
+    TowardZero, // Truncate
+};
+
+namespace Bfloat16CodecDetails
+{
+    constexpr uint32_t float32AbsoluteMask      = 0x7FFFFFFF;
+    constexpr uint32_t float32InfinityBits      = 0x7F800000;
+    constexpr uint32_t float32MinimumNormalBits = 0x00800000;
+    constexpr uint32_t float32QuietNanMask      = 0x00400000;
+    constexpr uint32_t bfloat16Shift            = 16;
+    constexpr uint32_t nearestEvenRoundingBias  = 0x7FFF; // Plus the lowest kept bit for ties to even.
+}
+
+inline uint16_t ConvertFloat32ToBfloat16Bits(float value, Bfloat16Rounding rounding = Bfloat16Rounding::NearestEven) noexcept
+{
+    using namespace Bfloat16CodecDetails;
+
+    uint32_t const bits = std::bit_cast<uint32_t>(value);
+    if ((bits & float32AbsoluteMask) > float32InfinityBits)
+    {
+        return uint16_t((bits | float32QuietNanMask) >> bfloat16Shift);
+    }
+
+    // Rounding up past the largest finite value carries into the exponent, yielding infinity as it should.
+    uint32_t const roundingBias = (rounding == Bfloat16Rounding::NearestEven)
+                                ? nearestEvenRoundingBias + ((bits >> bfloat16Shift) & 1)
+                                : 0;
+    return uint16_t((bits + roundingBias) >> bfloat16Shift);
+}
+
+inline float ConvertBfloat16BitsToFloat32(uint16_t value) noexcept
+{
+    return std::bit_cast<float>(uint32_t(value) << Bfloat16CodecDetails::bfloat16Shift);
+}
+
+#if BINUMS_X86
+
+namespace Bfloat16CodecDetails
+{
+    // Same logic as ConvertFloat32ToBfloat16Bits, just for 4 lanes.
+    // The result is sign extended from the upper 16 bits, ready for a saturating pack.
+    template <Bfloat16Rounding rounding>
+    BINUMS_TARGET("sse2")
+    inline __m128i ConvertFloat32ToBfloat16Sse2(__m128i bits) noexcept
+    {
+        __m128i rounded = bits;
+        if constexpr (rounding == Bfloat16Rounding::NearestEven)
+        {
+            __m128i const isLowestBitOdd = _mm_and_si128(_mm_srli_epi32(bits, bfloat16Shift), _mm_set1_epi32(1));
+            rounded = _mm_add_epi32(_mm_add_epi32(bits, _mm_set1_epi32(nearestEvenRoundingBias)), isLowestBitOdd);
+        }
+
+        __m128i const absoluteBits = _mm_and_si128(bits, _mm_set1_epi32(float32AbsoluteMask));
+        __m128i const isNan = _mm_cmpgt_epi32(absoluteBits, _mm_set1_epi32(float32InfinityBits));
+        __m128i const nan = _mm_or_si128(bits, _mm_set1_epi32(float32QuietNanMask));
+        __m128i const result = _mm_or_si128(_mm_and_si128(isNan, nan), _mm_andnot_si128(isNan, rounded));
+        return _mm_srai_epi32(result, bfloat16Shift);
+    }
+
+    template <Bfloat16Rounding rounding>
+    BINUMS_TARGET("avx2")
+    inline __m256i ConvertFloat32ToBfloat16Avx2(__m256i bits) noexcept
+    {
+        __m256i rounded = bits;
+        if constexpr (rounding == Bfloat16Rounding::NearestEven)
+        {
+            __m256i const isLowestBitOdd = _mm256_and_si256(_mm256_srli_epi32(bits, bfloat16Shift), _mm256_set1_epi32(1));
+            rounded = _mm256_add_epi32(_mm256_add_epi32(bits, _mm256_set1_epi32(nearestEvenRoundingBias)), isLowestBitOdd);
+        }
+
+        __m256i const absoluteBits = _mm256_and_si256(bits, _mm256_set1_epi32(float32AbsoluteMask));
+        __m256i const isNan = _mm256_cmpgt_epi32(absoluteBits, _mm256_set1_epi32(float32InfinityBits));
+        __m256i const nan = _mm256_or_si256(bits, _mm256_set1_epi32(float32QuietNanMask));
+        __m256i const result = _mm256_blendv_epi8(rounded, nan, isNan);
+        return _mm256_srai_epi32(result, bfloat16Shift);
+    }
+} // namespace Bfloat16CodecDetails
+
+BINUMS_TARGET("avx512f,avx512bf16")
+inline void ConvertFloat32ToBfloat16ArrayAvx512Bf16(float const* input, /*out*/ uint16_t* output, size_t count) noexcept
+{
+    using namespace Bfloat16CodecDetails;
+
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        __m512 const value = _mm512_loadu_ps(input + i);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + i), (__m256i)_mm512_cvtneps_pbh(value));
+
+        // Overwrite the denormal lanes, which the instruction flushed to zero. Only those lanes are
+        // shifted and narrowed, and the masked store leaves the rest as they are.
+        __m512i const bits = _mm512_castps_si512(value);
+        __m512i const absoluteBits = _mm512_and_si512(bits, _mm512_set1_epi32(float32AbsoluteMask));
+        __mmask16 const isDenormal = _mm512_cmplt_epu32_mask(_mm512_sub_epi32(absoluteBits, _mm512_set1_epi32(1)), _mm512_set1_epi32(float32MinimumNormalBits - 1));
+        if (isDenormal)
+        {
+            __m512i const isLowestBitOdd = _mm512_and_si512(_mm512_maskz_srli_epi32(isDenormal, bits, bfloat16Shift), _mm512_set1_epi32(1));
+            __m512i const rounded = _mm512_add_epi32(_mm512_add_epi32(bits, _mm512_set1_epi32(nearestEvenRoundingBias)), isLowestBitOdd);
+            _mm512_mask_cvtepi32_storeu_epi16(output + i, isDenormal, _mm512_maskz_srli_epi32(isDenormal, rounded, bfloat16Shift));
+        }
+    }
+    for (; i < count; ++i)
+    {
+        output[i] = ConvertFloat32ToBfloat16Bits(input[i], Bfloat16Rounding::NearestEven);
+    }
+}
+
+template <Bfloat16Rounding rounding>
+BINUMS_TARGET("avx2")
+inline void ConvertFloat32ToBfloat16ArrayAvx2(float const* input, /*out*/ uint16_t* output, size_t count) noexcept
+{
+    using namespace Bfloat16CodecDetails;
+
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        __m256i const low = ConvertFloat32ToBfloat16Avx2<rounding>(_mm256_loadu_si256(reinterpret_cast<__m256i const*>(input + i)));
+        __m256i const high = ConvertFloat32ToBfloat16Avx2<rounding>(_mm256_loadu_si256(reinterpret_cast<__m256i const*>(input + i + 8)));
+        // The pack interleaves 128-bit halves, so restore the element order afterward.
+        __m256i const packed = _mm256_permute4x64_epi64(_mm256_packs_epi32(low, high), 0b11'01'10'00);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + i), packed);
+    }
+    for (; i < count; ++i)
+    {
+        output[i] = ConvertFloat32ToBfloat16Bits(input[i], rounding);
+    }
+}
+
+template <Bfloat16Rounding rounding>
+BINUMS_TARGET("sse2")
+inline void ConvertFloat32ToBfloat16ArraySse2(float const* input, /*out*/ uint16_t* output, size_t count) noexcept
+{
+    using namespace Bfloat16CodecDetails;
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i const low = ConvertFloat32ToBfloat16Sse2<rounding>(_mm_loadu_si128(reinterpret_cast<__m128i const*>(input + i)));
+        __m128i const high = ConvertFloat32ToBfloat16Sse2<rounding>(_mm_loadu_si128(reinterpret_cast<__m128i const*>(input + i + 4)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), _mm_packs_epi32(low, high));
+    }
+    for (; i < count; ++i)
+    {
+        output[i] = ConvertFloat32ToBfloat16Bits(input[i], rounding);
+    }
+}
+
+BINUMS_TARGET("sse2")
+inline void ConvertBfloat16ToFloat32ArraySse2(uint16_t const* input, /*out*/ float* output, size_t count) noexcept
+{
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        // Interleaving zeros below each value is the 16-bit shift.
+        __m128i const value = _mm_loadu_si128(reinterpret_cast<__m128i const*>(input + i));
+        __m128i const zero = _mm_setzero_si128();
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), _mm_unpacklo_epi16(zero, value));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i + 4), _mm_unpackhi_epi16(zero, value));
+    }
+    for (; i < count; ++i)
+    {
+        output[i] = ConvertBfloat16BitsToFloat32(input[i]);
+    }
+}
+
+#endif // BINUMS_X86
+
+inline void ConvertFloat32ToBfloat16Array(
+    float const* input,
+    /*out*/ uint16_t* output,
+    size_t count,
+    Bfloat16Rounding rounding = Bfloat16Rounding::NearestEven
+    ) noexcept
+{
+#if BINUMS_X86
+    CpuFeatures const& cpuFeatures = GetCpuFeatures();
+    if (rounding == Bfloat16Rounding::NearestEven)
+    {
+        if (cpuFeatures.avx512bf16)
+        {
+            return ConvertFloat32ToBfloat16ArrayAvx512Bf16(input, /*out*/ output, count);
+        }
+        if (cpuFeatures.avx2)
+        {
+            return ConvertFloat32ToBfloat16ArrayAvx2<Bfloat16Rounding::NearestEven>(input, /*out*/ output, count);
+        }
+        if (cpuFeatures.sse2)
+        {
+            return ConvertFloat32ToBfloat16ArraySse2<Bfloat16Rounding::NearestEven>(input, /*out*/ output, count);
+        }
+    }
+    else
+    {
+        if (cpuFeatures.avx2)
+        {
+            return ConvertFloat32ToBfloat16ArrayAvx2<Bfloat16Rounding::TowardZero>(input, /*out*/ output, count);
+        }
+        if (cpuFeatures.sse2)
+        {
+            return ConvertFloat32ToBfloat16ArraySse2<Bfloat16Rounding::TowardZero>(input, /*out*/ output, count);
+        }
+    }
+#endif
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        output[i] = ConvertFloat32ToBfloat16Bits(input[i], rounding);
+    }
+}
+
+inline void ConvertBfloat16ToFloat32Array(uint16_t const* input, /*out*/ float* output, size_t count) noexcept
+{
+#if BINUMS_X86
+    if (GetCpuFeatures().sse2)
+    {
+        return ConvertBfloat16ToFloat32ArraySse2(input, /*out*/ output, count);
+    }
+#endif
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        output[i] = ConvertBfloat16BitsToFloat32(input[i]);
+    }
+}
@@ -50,8 +50,6 @@ std::string GetFormatted(char const* formatString, ...)
 // The format string is compatible with printf (not std::format).
 void AppendFormatted(/*inout*/ std::string& s, char const* formatString, ...)
 {
-    std::string formattedMessage;
-
     va_list argList;
     va_start(argList, formatString);
     char buffer[1000];
@@ -98,121 +96,41 @@ using namespace std::literals::string_view_literals;
 
 ////////////////////////////////////////////////////////////////////////////////
 
-using Fixed24f12i12 = FixedNumber<int24_t, 12, 12>;
-using Fixed32f16i16 = FixedNumber<int32_t, 16, 16>;
-using Fixed32f24i8  = FixedNumber<int32_t, 8, 24>;
-
-union NumberUnion
-{
-    uint8_t         buffer[8];
-    uint8_t         ui8;
-    uint16_t        ui16;
-    uint32_t        ui32;
-    uint64_t        ui64;
-    int8_t          i8;
-    int16_t         i16;
-    int32_t         i32;
-    int64_t         i64;
-    float8m3e4s1_t  f3e4s1;
-    float8m2e5s1_t  f2e5s1;
-    float16_t       f16;
-    float16m7e8s1_t f16m7e8s1;
-    float32_t       f32;
-    float64_t       f64;
-    Fixed24f12i12   x24f12i12;
-    Fixed32f16i16   x32f16i16;
-    Fixed32f24i8    x32f24i8;
-
-    NumberUnion() : ui64(0) {}
-};
-
-enum class ElementType : uint32_t
-{
-    Undefined = 0,
-    Float32 = 1,    // starting from bit 0 - mantissa:23 exponent:8 sign:1
-    Uint8 = 2,
-    Int8 = 3,
-    Uint16 = 4,
-    Int16 = 5,
-    Int32 = 6,
-    Int64 = 7,
-    StringChar8 = 8,
-    Bool8 = 9,
-    Float16m10e5s1 = 10, // mantissa:10 exponent:5 sign:1
-    Float16 = Float16m10e5s1,
-    Float64 = 11,   // mantissa:52 exponent:11 sign:1
-    Uint32 = 12,
-    Uint64 = 13,
-    Complex64 = 14,
-    Complex128 = 15,
-    Float16m7e8s1 = 16,   // mantissa:7 exponent:8 sign:1
-    Bfloat16 = Float16m7e8s1,
-    Fixed24f12i12 = 17, // TODO: Make naming more consistent. Fixed24f12i12 vs Fixed12_12
-    Fixed32f16i16 = 18,
-    Fixed32f24i8 = 19,
-    Float8m2e5s1 = 20, // mantissa:2 exponent:5 sign:1
-    Float8m3e4s1 = 21, // mantissa:3 exponent:4 sign:1
-    Total = 22,
-};
-
-enum class NumericOperationType : uint32_t
-{
-    None,       // Invalid value
-    Nothing,    // No result, taking N outputs, returning 0 outputs
-    Nop,            // No operation, taking N inputs, returning N outputs (identity)
-    Identity = Nop,
-    Add,
-    Subtract,
-    Multiply,
-    Divide,
-    Dot,
-    Truncate,
-    Total
-};
-
-enum class NumericPrintingFlags : uint32_t
+struct NumericOperationOptions
 {
-    ShowNumericType = 1 << 0,
-    ShowNumericValue = 1 << 1,
-    ShowBinaryValue = 1 << 2,
-
-    ShowRawHex = 0 << 4,
-    ShowRawBinary = 1 << 4,
-    ShowRawDecimal = 2 << 4,
-    ShowRawOctal = 3 << 4,
-    ShowDataMask = 3 << 4,
-
-    ShowFloatDecimal = 0 << 6,
-    ShowFloatHex = 1 << 6,
-    ShowFloatMask = 1 << 6,
+    // Add, multiply, and dot accumulate in this type, rounding to the result type at the end.
+    // Undefined accumulates in the result type itself.
+    ElementType accumulatorElementType = ElementType::Undefined;
 
-    HideRawFields = 0 << 7,
-    ShowRawFields = 1 << 7,
-    ShowRawFieldsMask = 1 << 7,
+    // Round the accumulation to the result type after every block of this many operands
+    // (products for dot), or 0 to round only at the end.
+    uint32_t accumulationBlockSize = 0;
 
-    ShowRawBinaryFields = ShowRawBinary | ShowRawFields,
+    // How add, subtract, and dot sum float types. Integer and fixed point sums are exact
+    // (or wrap), so they are always sequential.
+    SummationMode summationMode = SummationMode::Sequential;
 
-    Default = ShowBinaryValue | ShowNumericValue | ShowNumericType,
+    // Threads that add, multiply, and dot reduce their chunks on, or 0 for every hardware thread.
+    // The chunks are fixed size, so the result is the same for any count (see ParallelReduction.h).
+    uint32_t threadCount = 0;
 };
 
-inline constexpr NumericPrintingFlags operator ~ (NumericPrintingFlags lhs) { return NumericPrintingFlags(~uint32_t(lhs)); }
-inline constexpr NumericPrintingFlags operator & (NumericPrintingFlags lhs, NumericPrintingFlags rhs) { return NumericPrintingFlags(uint32_t(lhs) & uint32_t(rhs)); }
-inline constexpr NumericPrintingFlags operator | (NumericPrintingFlags lhs, NumericPrintingFlags rhs) { return NumericPrintingFlags(uint32_t(lhs) & uint32_t(rhs)); }
-inline constexpr bool operator == (NumericPrintingFlags lhs, uint32_t rhs) { return uint32_t(lhs) == rhs; }
-inline constexpr bool operator != (NumericPrintingFlags lhs, uint32_t rhs) { return uint32_t(lhs) != rhs; }
-
-struct NumberUnionAndType
+// How to parse operands read from the input stream, per the options before "stream".
+struct StreamOperandFormat
 {
-    NumberUnion numberUnion;
-    ElementType elementType;
+    ElementType elementType = ElementType::Undefined;
     NumericPrintingFlags printingFlags = NumericPrintingFlags::Default;
+    bool parseAsRawData = false;
 };
 
 struct NumericOperationAndRange
 {
     NumericOperationType numericOperationType;
-    Range range;
+    SizeRange range;
     ElementType outputElementType;
+    NumericOperationOptions options;
+    bool isStreamed; // Further operands follow from the input stream.
+    StreamOperandFormat streamFormat;
 };
 
 // TODO: Utilize nested operands instead of single operator lists.
@@ -277,12 +195,12 @@ const char* g_elementTypeNames[] =
     "fixed12_12",   // Fixed24f12i12 = 17,
     "fixed16_16",   // Fixed32f16i16 = 18,
     "fixed8_24",    // Fixed32f24i8 = 19,
-    "float8f3e4s1", // Float8f3e4s1 = 20,
-    "float8f2e5s1", // Float8f2e5s1 = 21,
+    "float8e4m3",   // Float8f3e4s1 = 20,
+    "float8e5m2",   // Float8f2e5s1 = 21,
 };
 static_assert(int(ElementType::Total) == 22 && std::size(g_elementTypeNames) == 22);
 
-const static uint8_t g_byteSizeOfElementType[] =
+constexpr static uint8_t g_byteSizeOfElementType[] =
 {
     0,  // Undefined = 0,
     4,  // Float32 = 1,
@@ -309,7 +227,7 @@ const static uint8_t g_byteSizeOfElementType[] =
 };
 static_assert(int(ElementType::Total) == 22 && std::size(g_byteSizeOfElementType) == 22);
 
-const static uint8_t g_isFractionalElementType[] =
+constexpr static uint8_t g_isFractionalElementType[] =
 {
     false, // Undefined = 0,
     true , // Float32 = 1,
@@ -467,7 +385,7 @@ std::string_view GetTypeNameFromElementType(ElementType dataType) noexcept
     return g_elementTypeNames[index < std::size(g_elementTypeNames) ? index : 0];
 }
 
-bool IsFractionalElementType(ElementType dataType) noexcept
+constexpr bool IsFractionalElementType(ElementType dataType) noexcept
 {
     size_t index = static_cast<size_t>(dataType);
     return g_isFractionalElementType[index < std::size(g_isFractionalElementType) ? index : 0];
@@ -485,6 +403,240 @@ NumberSubstructure const& GetElementTypeSubstructure(ElementType dataType) noexc
     return g_elementTypeSubstructures[index < std::size(g_elementTypeSubstructures) ? index : 0];
 }
 
+////////////////////////////////////////////////////////////////////////////////
+
+// Consecutive operands of the same type and printing flags, packed as an array of that type.
+struct NumberRun
+{
+    ElementType elementType;
+    NumericPrintingFlags printingFlags;
+    size_t beginIndex; // Of the first operand within the list.
+    size_t count;
+    void const* data;
+    std::string_view sourcePath; // Of the file the operands are mapped from, else empty.
+};
+
+// Operands stored as structure-of-arrays: every run of operands sharing a type and printing
+// flags is a typed, packed array (4 bytes per float32 rather than a 16 byte NumberUnionAndType),
+// with the runs as the only per-type metadata. Most lists are homogeneous, so they are a single
+// run the array casts and kernels can take whole. Each run starts on a cache line boundary.
+// Runs can also refer to arrays held elsewhere, like mapped files, rather than copy them.
+class NumberList
+{
+public:
+    static constexpr size_t runAlignment = 64;
+
+    explicit NumberList(std::pmr::memory_resource* memoryResource = std::pmr::get_default_resource())
+    :   bytes_(AlignedAllocator<uint8_t, runAlignment>(memoryResource)),
+        runs_(memoryResource)
+    {
+    }
+
+    size_t size() const noexcept { return count_; }
+    bool empty() const noexcept { return count_ == 0; }
+
+    void clear() noexcept
+    {
+        bytes_.clear();
+        runs_.clear();
+        count_ = 0;
+        isNewRunRequired_ = false;
+    }
+
+    // Start a new run at the next operand even if the type and flags match, like at each
+    // operation so that its operands begin aligned.
+    void BreakRun() noexcept
+    {
+        isNewRunRequired_ = true;
+    }
+
+    void Append(ElementType elementType, NumericPrintingFlags printingFlags, void const* data, size_t count)
+    {
+        if (size_t(elementType) >= size_t(ElementType::Total))
+        {
+            throw std::invalid_argument("Element type is out of range.");
+        }
+
+        if (runs_.empty()
+        ||  isNewRunRequired_
+        ||  runs_.back().elementType != elementType
+        ||  runs_.back().printingFlags != printingFlags
+        ||  runs_.back().externalData != nullptr)
+        {
+            size_t const byteOffset = (bytes_.size() + runAlignment - 1) & ~(runAlignment - 1);
+            bytes_.resize(byteOffset);
+            runs_.push_back({.elementType = elementType, .printingFlags = printingFlags, .beginIndex = count_, .count = 0, .byteOffset = byteOffset, .externalData = nullptr, .sourcePath = {}});
+            isNewRunRequired_ = false;
+        }
+
+        uint8_t const* dataBytes = reinterpret_cast<uint8_t const*>(data);
+        bytes_.insert(bytes_.end(), dataBytes, dataBytes + count * g_byteSizeOfElementType[size_t(elementType)]);
+        runs_.back().count += count;
+        count_ += count;
+    }
+
+    void Append(NumberUnionAndType const& number)
+    {
+        Append(number.elementType, number.printingFlags, &number.numberUnion, 1);
+    }
+
+    // Append a run referring to the data in place rather than copying it, so the data must outlive
+    // the list. The source path (if any) is kept for printing, and must outlive it too.
+    void AppendExternal(ElementType elementType, NumericPrintingFlags printingFlags, void const* data, size_t count, std::string_view sourcePath)
+    {
+        if (size_t(elementType) >= size_t(ElementType::Total))
+        {
+            throw std::invalid_argument("Element type is out of range.");
+        }
+
+        runs_.push_back({
+            .elementType = elementType,
+            .printingFlags = printingFlags,
+            .beginIndex = count_,
+            .count = count,
+            .byteOffset = 0,
+            .externalData = data,
+            .sourcePath = sourcePath,
+        });
+        count_ += count;
+        isNewRunRequired_ = false;
+    }
+
+    // Call function(NumberRun const&) for each run within [begin, end), trimmed to the range.
+    template <typename Function>
+    void ForEachRun(size_t begin, size_t end, Function&& function) const
+    {
+        assert(begin <= end && end <= count_);
+
+        auto run = std::upper_bound(
+            runs_.begin(),
+            runs_.end(),
+            begin,
+            [](size_t index, StoredRun const& storedRun) { return index < storedRun.beginIndex; }
+        );
+        if (run != runs_.begin())
+        {
+            --run;
+        }
+
+        for (; run != runs_.end() && run->beginIndex < end; ++run)
+        {
+            size_t const runBegin = std::max(begin, run->beginIndex);
+            size_t const runEnd = std::min(end, run->beginIndex + run->count);
+            if (runBegin >= runEnd)
+            {
+                continue;
+            }
+
+            size_t const elementByteSize = g_byteSizeOfElementType[size_t(run->elementType)];
+            uint8_t const* runData = (run->externalData != nullptr)
+                ? reinterpret_cast<uint8_t const*>(run->externalData)
+                : bytes_.data() + run->byteOffset;
+            NumberRun const numberRun =
+            {
+                .elementType = run->elementType,
+                .printingFlags = run->printingFlags,
+                .beginIndex = runBegin,
+                .count = runEnd - runBegin,
+                .data = runData + (runBegin - run->beginIndex) * elementByteSize,
+                .sourcePath = run->sourcePath,
+            };
+            function(numberRun);
+        }
+    }
+
+    // The operand at the index, unpacked.
+    NumberUnionAndType operator [](size_t index) const
+    {
+        NumberUnionAndType number;
+        ForEachRun(
+            index,
+            index + 1,
+            [&](NumberRun const& run)
+            {
+                number.elementType = run.elementType;
+                number.printingFlags = run.printingFlags;
+                std::memcpy(&number.numberUnion, run.data, g_byteSizeOfElementType[size_t(run.elementType)]);
+            }
+        );
+        return number;
+    }
+
+private:
+    struct StoredRun
+    {
+        ElementType elementType;
+        NumericPrintingFlags printingFlags;
+        size_t beginIndex;
+        size_t count;
+        size_t byteOffset; // Within bytes_, unless the data is external.
+        void const* externalData;
+        std::string_view sourcePath;
+    };
+
+    std::vector<uint8_t, AlignedAllocator<uint8_t, runAlignment>> bytes_;
+    std::pmr::vector<StoredRun> runs_;
+    size_t count_ = 0;
+    bool isNewRunRequired_ = false;
+};
+
+// A range of operands within a NumberList.
+class NumberListView
+{
+public:
+    NumberListView(NumberList const& list) : list_(&list), begin_(0), end_(list.size()) {}
+    NumberListView(NumberList const& list, size_t begin, size_t end) : list_(&list), begin_(begin), end_(end) {}
+
+    size_t size() const noexcept { return end_ - begin_; }
+    bool empty() const noexcept { return begin_ == end_; }
+    NumberUnionAndType front() const { return (*list_)[begin_]; }
+    NumberUnionAndType operator [](size_t index) const { return (*list_)[begin_ + index]; }
+
+    // The run's beginIndex is within the list, not the view.
+    template <typename Function>
+    void ForEachRun(Function&& function) const
+    {
+        list_->ForEachRun(begin_, end_, std::forward<Function>(function));
+    }
+
+    NumberListView GetSubview(size_t begin, size_t end) const
+    {
+        return NumberListView(*list_, begin, end);
+    }
+
+    // The operands as one array if they are a single run of the given type (e.g. already the
+    // computation type), else nullptr. Runs of the same type can still be apart, such as when
+    // their printing flags differ or one is mapped from a file.
+    void const* GetSingleRunData(ElementType elementType) const
+    {
+        void const* data = nullptr;
+        size_t runCount = 0;
+        ForEachRun(
+            [&](NumberRun const& run)
+            {
+                data = (run.elementType == elementType) ? run.data : nullptr;
+                ++runCount;
+            }
+        );
+        return (runCount == 1) ? data : nullptr;
+    }
+
+private:
+    NumberList const* list_;
+    size_t begin_;
+    size_t end_;
+};
+
+void AppendNumberList(/*inout*/ NumberList& list, NumberListView numbers)
+{
+    numbers.ForEachRun(
+        [&](NumberRun const& run)
+        {
+            list.Append(run.elementType, run.printingFlags, run.data, run.count);
+        }
+    );
+}
+
 // Read data type and cast to double.
 // The caller passes a data pointer of the given type.
 /*static*/ double ReadToDouble(ElementType dataType, const void* data)
@@ -501,7 +653,7 @@ NumberSubstructure const& GetElementTypeSubstructure(ElementType dataType) noexc
     case ElementType::Int64:            value = double(*reinterpret_cast<const int64_t*>(data));    break;
     case ElementType::StringChar8:      value = 0; /* no numeric value for strings */               break;
     case ElementType::Bool8:            value = *reinterpret_cast<const bool*>(data);               break;
-    case ElementType::Float16:          value = *reinterpret_cast<const float16_t*>(data);          break;
+    case ElementType::Float16:          value = ConvertFloat16BitsToFloat32ViaTable(*reinterpret_cast<const uint16_t*>(data)); break;
     case ElementType::Bfloat16:         value = *reinterpret_cast<const bfloat16_t*>(data);         break;
     case ElementType::Float64:          value = *reinterpret_cast<const double*>(data);             break;
     case ElementType::Uint32:           value = *reinterpret_cast<const uint32_t*>(data);           break;
@@ -511,6 +663,8 @@ NumberSubstructure const& GetElementTypeSubstructure(ElementType dataType) noexc
     case ElementType::Fixed24f12i12:    value = *reinterpret_cast<const Fixed24f12i12*>(data);      break;
     case ElementType::Fixed32f16i16:    value = *reinterpret_cast<const Fixed32f16i16*>(data);      break;
     case ElementType::Fixed32f24i8:     value = *reinterpret_cast<const Fixed32f24i8*>(data);       break;
+    case ElementType::Float8m3e4s1:     value = *reinterpret_cast<const float8m3e4s1_t*>(data);     break;
+    case ElementType::Float8m2e5s1:     value = *reinterpret_cast<const float8m2e5s1_t*>(data);     break;
     default:                            assert(false);                                              break;
     }
 
@@ -533,7 +687,7 @@ NumberSubstructure const& GetElementTypeSubstructure(ElementType dataType) noexc
     case ElementType::Int64:            value = int64_t(*reinterpret_cast<const int64_t*>(data));       break;
     case ElementType::StringChar8:      value = int64_t(0); /* no numeric value for strings */          break;
     case ElementType::Bool8:            value = int64_t(*reinterpret_cast<const bool*>(data));          break;
-    case ElementType::Float16:          value = int64_t(*reinterpret_cast<const float16_t*>(data));     break;
+    case ElementType::Float16:          value = int64_t(ConvertFloat16BitsToFloat32ViaTable(*reinterpret_cast<const uint16_t*>(data))); break;
     case ElementType::Bfloat16:         value = int64_t(*reinterpret_cast<const bfloat16_t*>(data));    break;
     case ElementType::Float64:          value = int64_t(*reinterpret_cast<const double*>(data));        break;
     case ElementType::Uint32:           value = int64_t(*reinterpret_cast<const uint32_t*>(data));      break;
@@ -543,6 +697,8 @@ NumberSubstructure const& GetElementTypeSubstructure(ElementType dataType) noexc
     case ElementType::Fixed24f12i12:    value = int64_t(*reinterpret_cast<const Fixed24f12i12*>(data)); break;
     case ElementType::Fixed32f16i16:    value = int64_t(*reinterpret_cast<const Fixed32f16i16*>(data)); break;
     case ElementType::Fixed32f24i8:;    value = int64_t(*reinterpret_cast<const Fixed32f24i8*>(data));  break;
+    case ElementType::Float8m3e4s1:     value = int64_t(double(*reinterpret_cast<const float8m3e4s1_t*>(data))); break;
+    case ElementType::Float8m2e5s1:     value = int64_t(double(*reinterpret_cast<const float8m2e5s1_t*>(data))); break;
     default:                            assert(false);                                              break;
     }
 
@@ -575,6 +731,8 @@ NumberSubstructure const& GetElementTypeSubstructure(ElementType dataType) noexc
     case ElementType::Fixed24f12i12:    value = int64_t(*reinterpret_cast<const int24_t*>(data));   break;
     case ElementType::Fixed32f16i16:    value = int64_t(*reinterpret_cast<const int32_t*>(data));   break;
     case ElementType::Fixed32f24i8:;    value = int64_t(*reinterpret_cast<const int32_t*>(data));   break;
+    case ElementType::Float8m3e4s1:     value = int64_t(*reinterpret_cast<const int8_t*>(data));    break;
+    case ElementType::Float8m2e5s1:     value = int64_t(*reinterpret_cast<const int8_t*>(data));    break;
     default:                            assert(false);                                              break;
     }
 
@@ -595,7 +753,7 @@ void WriteFromDouble(ElementType dataType, double value, /*out*/ void* data)
     case ElementType::Int64:            *reinterpret_cast<int64_t*>(data) = int64_t(value);         break;
     case ElementType::StringChar8:      /* no change value for strings */                           break;
     case ElementType::Bool8:            *reinterpret_cast<bool*>(data) = bool(value);               break;
-    case ElementType::Float16:          *reinterpret_cast<uint16_t*>(data) = half_float::detail::float2half<std::round_to_nearest, float>(float(value)); break;
+    case ElementType::Float16:          *reinterpret_cast<uint16_t*>(data) = ConvertFloat32ToFloat16Bits(float(value)); break;
     case ElementType::Bfloat16:         *reinterpret_cast<bfloat16_t*>(data) = bfloat16_t(float(value)); break;
     case ElementType::Float64:          *reinterpret_cast<double*>(data) = value;                   break;
     case ElementType::Uint32:           *reinterpret_cast<uint32_t*>(data) = uint32_t(value);       break;
@@ -605,10 +763,12 @@ void WriteFromDouble(ElementType dataType, double value, /*out*/ void* data)
     case ElementType::Fixed24f12i12:    *reinterpret_cast<Fixed24f12i12*>(data) = float(value);     break;
     case ElementType::Fixed32f16i16:    *reinterpret_cast<Fixed32f16i16*>(data) = float(value);     break;
     case ElementType::Fixed32f24i8:;    *reinterpret_cast<Fixed32f24i8*>(data) = float(value);      break;
+    case ElementType::Float8m3e4s1:     *reinterpret_cast<float8m3e4s1_t*>(data) = value;           break;
+    case ElementType::Float8m2e5s1:     *reinterpret_cast<float8m2e5s1_t*>(data) = value;           break;
     default:                            assert(false);                                              break;
     }
 
-    // Use half_float::detail::float2half explicitly rather than the half constructor.
+    // Use ConvertFloat32ToFloat16Bits (round to nearest) rather than the half constructor.
     // Otherwise values do not round-trip as expected.
     //
     // e.g. If you print float16 0x2C29, you get 0.0650024, but if you try to parse
@@ -630,7 +790,7 @@ void WriteFromInt64(ElementType dataType, int64_t value, /*out*/ void* data)
     case ElementType::Int64:         *reinterpret_cast<int64_t*>(data) = int64_t(value);                break;
     case ElementType::StringChar8:   /* no change value for strings */                                  break;
     case ElementType::Bool8:         *reinterpret_cast<bool*>(data) = bool(value);                      break;
-    case ElementType::Float16:       *reinterpret_cast<float16_t*>(data) = float16_t(float(value));     break;
+    case ElementType::Float16:       *reinterpret_cast<uint16_t*>(data) = ConvertFloat32ToFloat16Bits(float(value)); break;
     case ElementType::Bfloat16:      *reinterpret_cast<bfloat16_t*>(data) = bfloat16_t(float(value));   break;
     case ElementType::Float64:       *reinterpret_cast<double*>(data) = double(value);                  break;
     case ElementType::Uint32:        *reinterpret_cast<uint32_t*>(data) = uint32_t(value);              break;
@@ -640,74 +800,369 @@ void WriteFromInt64(ElementType dataType, int64_t value, /*out*/ void* data)
     case ElementType::Fixed24f12i12: *reinterpret_cast<Fixed24f12i12*>(data) = float(value);            break;
     case ElementType::Fixed32f16i16: *reinterpret_cast<Fixed32f16i16*>(data) = float(value);            break;
     case ElementType::Fixed32f24i8:  *reinterpret_cast<Fixed32f24i8*>(data) = float(value);             break;
+    case ElementType::Float8m3e4s1:  *reinterpret_cast<float8m3e4s1_t*>(data) = double(value);          break;
+    case ElementType::Float8m2e5s1:  *reinterpret_cast<float8m2e5s1_t*>(data) = double(value);          break;
     default:                         assert(false);                                                     break;
     }
 }
 
-// Just copy a single element from the input to output.
-void CastElementType(ElementType dataType, void const* inputData, /*out*/ void* outputData)
+// Floating point types whose raw bits have a FloatDefinition, which ConvertRawFloatType can
+// convert between directly.
+constexpr bool IsRawFloatElementType(ElementType dataType) noexcept
 {
     switch (dataType)
     {
-    case ElementType::Float32:       *reinterpret_cast<uint32_t*>(outputData)   = *reinterpret_cast<const uint32_t*>(inputData);    break;
-    case ElementType::Uint8:         *reinterpret_cast<uint8_t*>(outputData)    = *reinterpret_cast<const uint8_t*>(inputData);     break;
-    case ElementType::Int8:          *reinterpret_cast<uint8_t*>(outputData)    = *reinterpret_cast<const uint8_t*>(inputData);     break;
-    case ElementType::Uint16:        *reinterpret_cast<uint16_t*>(outputData)   = *reinterpret_cast<const uint16_t*>(inputData);    break;
-    case ElementType::Int16:         *reinterpret_cast<uint16_t*>(outputData)   = *reinterpret_cast<const uint16_t*>(inputData);    break;
-    case ElementType::Int32:         *reinterpret_cast<uint32_t*>(outputData)   = *reinterpret_cast<const uint32_t*>(inputData);    break;
-    case ElementType::Int64:         *reinterpret_cast<uint64_t*>(outputData)   = *reinterpret_cast<const uint64_t*>(inputData);    break;
-    case ElementType::StringChar8:   /* no change value for strings */                                                              break;
-    case ElementType::Bool8:         *reinterpret_cast<uint8_t*>(outputData)    = *reinterpret_cast<const uint8_t*>(inputData);     break;
-    case ElementType::Float16:       *reinterpret_cast<uint16_t*>(outputData)   = *reinterpret_cast<const uint16_t*>(inputData);    break;
-    case ElementType::Bfloat16:      *reinterpret_cast<uint16_t*>(outputData)   = *reinterpret_cast<const uint16_t*>(inputData);    break;
-    case ElementType::Float64:       *reinterpret_cast<uint64_t*>(outputData)   = *reinterpret_cast<const uint64_t*>(inputData);    break;
-    case ElementType::Uint32:        *reinterpret_cast<uint32_t*>(outputData)   = *reinterpret_cast<const uint32_t*>(inputData);    break;
-    case ElementType::Uint64:        *reinterpret_cast<uint64_t*>(outputData)   = *reinterpret_cast<const uint64_t*>(inputData);    break;
-    case ElementType::Complex64:     throw std::invalid_argument("Complex64 type is not supported.");
-    case ElementType::Complex128:    throw std::invalid_argument("Complex128 type is not supported.");
-    case ElementType::Fixed24f12i12: *reinterpret_cast<Fixed24f12i12*>(outputData) = *reinterpret_cast<const Fixed24f12i12*>(inputData);  break;
-    case ElementType::Fixed32f16i16: *reinterpret_cast<uint32_t*>(outputData)   = *reinterpret_cast<const uint32_t*>(inputData);    break;
-    case ElementType::Fixed32f24i8:  *reinterpret_cast<uint32_t*>(outputData)   = *reinterpret_cast<const uint32_t*>(inputData);    break;
-    default:                         assert(false);                                                                                 break;
+    case ElementType::Float8m3e4s1:
+    case ElementType::Float8m2e5s1:
+    case ElementType::Float16:
+    case ElementType::Bfloat16:
+    case ElementType::Float32:
+    case ElementType::Float64:
+        return true;
+    default:
+        return false;
     }
 }
 
-// Cast copy a single element from the input type to output type.
-void CastElementType(
-    ElementType inputDataType,
-    ElementType outputDataType,
-    void const* inputData,
-    /*out*/ void* outputData
-)
+////////////////////////////////////////////////////////////////////////////////
+// Element casting.
+//
+// Deciding the conversion via the ReadTo*/WriteFrom* switches (plus whether each
+// side is fractional) costs more than the conversion itself, and the branches are
+// unpredictable for mixed types. Instead, compile time tables indexed by the
+// (input, output) pair hold a function specialized for each, which CastElementType
+// calls for a single element and CastElementTypeArray calls for a tight loop.
+
+// Storage type of each element type, or void if there is no typed storage.
+template <ElementType DataType> struct ElementTypeStorage               { using type = void; };
+template <> struct ElementTypeStorage<ElementType::Float32>             { using type = float32_t; };
+template <> struct ElementTypeStorage<ElementType::Uint8>               { using type = uint8_t; };
+template <> struct ElementTypeStorage<ElementType::Int8>                { using type = int8_t; };
+template <> struct ElementTypeStorage<ElementType::Uint16>              { using type = uint16_t; };
+template <> struct ElementTypeStorage<ElementType::Int16>               { using type = int16_t; };
+template <> struct ElementTypeStorage<ElementType::Int32>               { using type = int32_t; };
+template <> struct ElementTypeStorage<ElementType::Int64>               { using type = int64_t; };
+template <> struct ElementTypeStorage<ElementType::Bool8>               { using type = bool; };
+template <> struct ElementTypeStorage<ElementType::Float16>             { using type = float16_t; };
+template <> struct ElementTypeStorage<ElementType::Float64>             { using type = float64_t; };
+template <> struct ElementTypeStorage<ElementType::Uint32>              { using type = uint32_t; };
+template <> struct ElementTypeStorage<ElementType::Uint64>              { using type = uint64_t; };
+template <> struct ElementTypeStorage<ElementType::Bfloat16>            { using type = bfloat16_t; };
+template <> struct ElementTypeStorage<ElementType::Fixed24f12i12>       { using type = Fixed24f12i12; };
+template <> struct ElementTypeStorage<ElementType::Fixed32f16i16>       { using type = Fixed32f16i16; };
+template <> struct ElementTypeStorage<ElementType::Fixed32f24i8>        { using type = Fixed32f24i8; };
+template <> struct ElementTypeStorage<ElementType::Float8m3e4s1>        { using type = float8m3e4s1_t; };
+template <> struct ElementTypeStorage<ElementType::Float8m2e5s1>        { using type = float8m2e5s1_t; };
+
+template <ElementType DataType>
+using ElementTypeStorageType = typename ElementTypeStorage<DataType>::type;
+
+// FloatDefinition of the raw bits of each type where IsRawFloatElementType is true.
+template <ElementType DataType> struct ElementTypeRawFloatDefinition    { using type = void; };
+template <> struct ElementTypeRawFloatDefinition<ElementType::Float8m3e4s1> { using type = FloatNumberDetails::Float8f3e4s1Definition; };
+template <> struct ElementTypeRawFloatDefinition<ElementType::Float8m2e5s1> { using type = FloatNumberDetails::Float8f2e5s1Definition; };
+template <> struct ElementTypeRawFloatDefinition<ElementType::Float16>      { using type = FloatNumberDetails::Float16f10e5s1Definition; };
+template <> struct ElementTypeRawFloatDefinition<ElementType::Bfloat16>     { using type = FloatNumberDetails::Float16f7e8s1Definition; };
+template <> struct ElementTypeRawFloatDefinition<ElementType::Float32>      { using type = FloatNumberDetails::Float32Definition; };
+template <> struct ElementTypeRawFloatDefinition<ElementType::Float64>      { using type = FloatNumberDetails::Float64Definition; };
+
+template <ElementType DataType>
+using ElementTypeRawFloatDefinitionType = typename ElementTypeRawFloatDefinition<DataType>::type;
+
+// Strings have no storage type but are still castable (reading as zero, writing nothing).
+template <ElementType DataType>
+constexpr bool IsCastableElementType = !std::is_void_v<ElementTypeStorageType<DataType>> || DataType == ElementType::StringChar8;
+
+// Typed equivalents of ReadToDouble, ReadToInt64, WriteFromDouble, and WriteFromInt64.
+// These must produce the same results as the switch statements above.
+template <typename T> double ReadElementToDouble(T const& value) noexcept { return double(value); }
+template <typename T> int64_t ReadElementToInt64(T const& value) noexcept { return int64_t(value); }
+template <typename T> void WriteElementFromDouble(double value, /*out*/ T& data) noexcept { data = T(value); }
+template <typename T> void WriteElementFromInt64(int64_t value, /*out*/ T& data) noexcept { data = T(value); }
+
+template <> double ReadElementToDouble(float16_t const& value) noexcept { return ConvertFloat16BitsToFloat32ViaTable(CastReferenceAs<uint16_t>(value)); }
+template <> int64_t ReadElementToInt64(float16_t const& value) noexcept { return int64_t(ConvertFloat16BitsToFloat32ViaTable(CastReferenceAs<uint16_t>(value))); }
+template <> int64_t ReadElementToInt64(float8m3e4s1_t const& value) noexcept { return int64_t(double(value)); }
+template <> int64_t ReadElementToInt64(float8m2e5s1_t const& value) noexcept { return int64_t(double(value)); }
+
+template <> void WriteElementFromDouble(double value, /*out*/ float32_t& data) noexcept { data = float(value); }
+template <> void WriteElementFromDouble(double value, /*out*/ bfloat16_t& data) noexcept { data = bfloat16_t(float(value)); }
+template <> void WriteElementFromDouble(double value, /*out*/ Fixed24f12i12& data) noexcept { data = float(value); }
+template <> void WriteElementFromDouble(double value, /*out*/ Fixed32f16i16& data) noexcept { data = float(value); }
+template <> void WriteElementFromDouble(double value, /*out*/ Fixed32f24i8& data) noexcept { data = float(value); }
+template <> void WriteElementFromDouble(double value, /*out*/ float16_t& data) noexcept { CastReferenceAs<uint16_t>(data) = ConvertFloat32ToFloat16Bits(float(value)); }
+
+template <> void WriteElementFromInt64(int64_t value, /*out*/ float16_t& data) noexcept { CastReferenceAs<uint16_t>(data) = ConvertFloat32ToFloat16Bits(float(value)); }
+template <> void WriteElementFromInt64(int64_t value, /*out*/ bfloat16_t& data) noexcept { data = bfloat16_t(float(value)); }
+template <> void WriteElementFromInt64(int64_t value, /*out*/ Fixed24f12i12& data) noexcept { data = float(value); }
+template <> void WriteElementFromInt64(int64_t value, /*out*/ Fixed32f16i16& data) noexcept { data = float(value); }
+template <> void WriteElementFromInt64(int64_t value, /*out*/ Fixed32f24i8& data) noexcept { data = float(value); }
+template <> void WriteElementFromInt64(int64_t value, /*out*/ float8m3e4s1_t& data) noexcept { data = double(value); }
+template <> void WriteElementFromInt64(int64_t value, /*out*/ float8m2e5s1_t& data) noexcept { data = double(value); }
+
+// Same logic as the ReadTo*/WriteFrom* switches, but resolved at compile time.
+template <ElementType InputDataType, ElementType OutputDataType>
+void CastElement(ElementTypeStorageType<InputDataType> const& input, /*out*/ ElementTypeStorageType<OutputDataType>& output) noexcept
+{
+    if constexpr (IsFractionalElementType(InputDataType))
+    {
+        double value = ReadElementToDouble(input);
+        if constexpr (IsFractionalElementType(OutputDataType))
+        {
+            WriteElementFromDouble(value, /*out*/ output);
+        }
+        else
+        {
+            WriteElementFromInt64(static_cast<int64_t>(value), /*out*/ output);
+        }
+    }
+    else // !IsFractionalElementType(InputDataType)
+    {
+        int64_t value = ReadElementToInt64(input);
+        if constexpr (IsFractionalElementType(OutputDataType))
+        {
+            WriteElementFromDouble(static_cast<double>(value), /*out*/ output);
+        }
+        else
+        {
+            WriteElementFromInt64(value, /*out*/ output);
+        }
+    }
+}
+
+// Widen to float32 a block at a time, then to float64, which is exact.
+template <typename InputType, typename ConvertFunction>
+void CastArrayToFloat64ThroughFloat32(void const* inputData, /*out*/ void* outputData, size_t count, ConvertFunction convert)
+{
+    InputType const* input = reinterpret_cast<InputType const*>(inputData);
+    double* output = reinterpret_cast<double*>(outputData);
+    float block[256];
+    for (size_t i = 0; i < count; i += std::size(block))
+    {
+        size_t const blockCount = std::min(count - i, std::size(block));
+        convert(input + i, /*out*/ block, blockCount);
+        std::copy(block, block + blockCount, output + i);
+    }
+}
+
+constexpr bool IsFloat8ElementType(ElementType dataType) noexcept
+{
+    return dataType == ElementType::Float8m3e4s1 || dataType == ElementType::Float8m2e5s1;
+}
+
+// float32 <-> float64 is a single hardware conversion, which the plain loop vectorizes.
+constexpr bool IsHardwareFloatElementType(ElementType dataType) noexcept
+{
+    return dataType == ElementType::Float32 || dataType == ElementType::Float64;
+}
+
+// Float types other than float32 <-> float64 convert between their raw bits, rounding once.
+template <ElementType InputDataType, ElementType OutputDataType>
+constexpr bool IsRawFloatCast =
+    IsRawFloatElementType(InputDataType) && IsRawFloatElementType(OutputDataType)
+&&  !(IsHardwareFloatElementType(InputDataType) && IsHardwareFloatElementType(OutputDataType));
+
+template <ElementType InputDataType, ElementType OutputDataType>
+void CastElementTypeKernel(void const* inputData, /*out*/ void* outputData)
+{
+    using InputType = ElementTypeStorageType<InputDataType>;
+    using OutputType = ElementTypeStorageType<OutputDataType>;
+
+    if constexpr (OutputDataType == ElementType::StringChar8)
+    {
+        // No change value for strings.
+    }
+    else if constexpr (InputDataType == OutputDataType)
+    {
+        memcpy(outputData, inputData, sizeof(OutputType));
+    }
+    else if constexpr (IsRawFloatCast<InputDataType, OutputDataType>)
+    {
+        using InputDefinition = ElementTypeRawFloatDefinitionType<InputDataType>;
+        using OutputDefinition = ElementTypeRawFloatDefinitionType<OutputDataType>;
+        using InputBitsType = typename InputDefinition::baseIntegerType;
+        using OutputBitsType = typename OutputDefinition::baseIntegerType;
+        *reinterpret_cast<OutputBitsType*>(outputData) = FloatNumberDetails::ConvertRawFloatType<InputDefinition, OutputDefinition>(
+            *reinterpret_cast<InputBitsType const*>(inputData)
+        );
+    }
+    else if constexpr (InputDataType == ElementType::StringChar8)
+    {
+        // No numeric value for strings, which read as zero.
+        CastElement<ElementType::Int64, OutputDataType>(int64_t(0), /*out*/ *reinterpret_cast<OutputType*>(outputData));
+    }
+    else
+    {
+        CastElement<InputDataType, OutputDataType>(*reinterpret_cast<InputType const*>(inputData), /*out*/ *reinterpret_cast<OutputType*>(outputData));
+    }
+}
+
+template <ElementType InputDataType, ElementType OutputDataType>
+void CastElementTypeArrayKernel(void const* inputData, /*out*/ void* outputData, size_t count)
 {
-    if (inputDataType == outputDataType)
+    using InputType = ElementTypeStorageType<InputDataType>;
+    using OutputType = ElementTypeStorageType<OutputDataType>;
+
+    if constexpr (OutputDataType == ElementType::StringChar8)
+    {
+        // No change value for strings.
+    }
+    else if constexpr (InputDataType == OutputDataType)
+    {
+        memcpy(outputData, inputData, count * sizeof(OutputType));
+    }
+    else if constexpr (InputDataType == ElementType::Float32 && OutputDataType == ElementType::Float16)
+    {
+        ConvertFloat32ToFloat16Array(reinterpret_cast<float const*>(inputData), /*out*/ reinterpret_cast<uint16_t*>(outputData), count);
+    }
+    else if constexpr (InputDataType == ElementType::Float16 && OutputDataType == ElementType::Float32)
+    {
+        ConvertFloat16ToFloat32Array(reinterpret_cast<uint16_t const*>(inputData), /*out*/ reinterpret_cast<float*>(outputData), count);
+    }
+    else if constexpr (InputDataType == ElementType::Float16 && OutputDataType == ElementType::Float64)
+    {
+        CastArrayToFloat64ThroughFloat32<uint16_t>(inputData, /*out*/ outputData, count, &ConvertFloat16ToFloat32Array);
+    }
+    else if constexpr (InputDataType == ElementType::Float32 && OutputDataType == ElementType::Bfloat16)
     {
-        CastElementType(inputDataType, inputData, outputData);
+        ConvertFloat32ToBfloat16Array(reinterpret_cast<float const*>(inputData), /*out*/ reinterpret_cast<uint16_t*>(outputData), count);
     }
-    else if (IsFractionalElementType(inputDataType))
+    else if constexpr (InputDataType == ElementType::Bfloat16 && OutputDataType == ElementType::Float32)
+    {
+        ConvertBfloat16ToFloat32Array(reinterpret_cast<uint16_t const*>(inputData), /*out*/ reinterpret_cast<float*>(outputData), count);
+    }
+    else if constexpr (InputDataType == ElementType::Bfloat16 && OutputDataType == ElementType::Float64)
+    {
+        CastArrayToFloat64ThroughFloat32<uint16_t>(inputData, /*out*/ outputData, count, &ConvertBfloat16ToFloat32Array);
+    }
+    else if constexpr (InputDataType == ElementType::Float32 && IsFloat8ElementType(OutputDataType))
+    {
+        ConvertFloat32ToFloat8Array<typename OutputType::SelfDefinition>(reinterpret_cast<float const*>(inputData), /*out*/ reinterpret_cast<uint8_t*>(outputData), count);
+    }
+    else if constexpr (IsFloat8ElementType(InputDataType) && OutputDataType == ElementType::Float32)
+    {
+        ConvertFloat8ToFloat32Array<typename InputType::SelfDefinition>(reinterpret_cast<uint8_t const*>(inputData), /*out*/ reinterpret_cast<float*>(outputData), count);
+    }
+    else if constexpr (InputDataType == ElementType::Float64 && IsFloat8ElementType(OutputDataType))
+    {
+        ConvertFloat64ToFloat8Array<typename OutputType::SelfDefinition>(reinterpret_cast<double const*>(inputData), /*out*/ reinterpret_cast<uint8_t*>(outputData), count);
+    }
+    else if constexpr (IsFloat8ElementType(InputDataType) && OutputDataType == ElementType::Float64)
+    {
+        CastArrayToFloat64ThroughFloat32<uint8_t>(inputData, /*out*/ outputData, count, &ConvertFloat8ToFloat32Array<typename InputType::SelfDefinition>);
+    }
+    else if constexpr (IsRawFloatCast<InputDataType, OutputDataType>)
+    {
+        // Everything else between float types, like float8 <-> bfloat16 or float64 -> float16,
+        // is a single generic conversion.
+        using InputDefinition = ElementTypeRawFloatDefinitionType<InputDataType>;
+        using OutputDefinition = ElementTypeRawFloatDefinitionType<OutputDataType>;
+        ConvertRawFloatTypeArray<InputDefinition, OutputDefinition>(
+            reinterpret_cast<typename InputDefinition::baseIntegerType const*>(inputData),
+            /*out*/ reinterpret_cast<typename OutputDefinition::baseIntegerType*>(outputData),
+            count
+        );
+    }
+    else if constexpr (InputDataType == ElementType::StringChar8)
+    {
+        // No numeric value for strings, which read as zero.
+        OutputType* output = reinterpret_cast<OutputType*>(outputData);
+        for (size_t i = 0; i < count; ++i)
+        {
+            CastElement<ElementType::Int64, OutputDataType>(int64_t(0), /*out*/ output[i]);
+        }
+    }
+    else
+    {
+        InputType const* input = reinterpret_cast<InputType const*>(inputData);
+        OutputType* output = reinterpret_cast<OutputType*>(outputData);
+        for (size_t i = 0; i < count; ++i)
+        {
+            CastElement<InputDataType, OutputDataType>(input[i], /*out*/ output[i]);
+        }
+    }
+}
+
+void CastElementTypeUnsupported(void const* /*inputData*/, /*out*/ void* /*outputData*/)
+{
+    throw std::invalid_argument("Element type is not supported.");
+}
+
+void CastElementTypeArrayUnsupported(void const* /*inputData*/, /*out*/ void* /*outputData*/, size_t /*count*/)
+{
+    throw std::invalid_argument("Element type is not supported.");
+}
+
+using CastElementTypeFunction = void(*)(void const* inputData, /*out*/ void* outputData);
+using CastElementTypeArrayFunction = void(*)(void const* inputData, /*out*/ void* outputData, size_t count);
+
+struct CastElementTypeFunctionGetter
+{
+    template <ElementType InputDataType, ElementType OutputDataType>
+    static constexpr CastElementTypeFunction Get() noexcept
     {
-        double value = ReadToDouble(inputDataType, inputData);
-        if (IsFractionalElementType(outputDataType))
+        if constexpr (IsCastableElementType<InputDataType> && IsCastableElementType<OutputDataType>)
         {
-            WriteFromDouble(outputDataType, value, outputData);
+            return &CastElementTypeKernel<InputDataType, OutputDataType>;
         }
         else
         {
-            WriteFromInt64(outputDataType, static_cast<int64_t>(value), outputData);
+            return &CastElementTypeUnsupported;
         }
     }
-    else // !IsFractionalElementType(inputDataType)
+};
+
+struct CastElementTypeArrayFunctionGetter
+{
+    template <ElementType InputDataType, ElementType OutputDataType>
+    static constexpr CastElementTypeArrayFunction Get() noexcept
     {
-        int64_t value = ReadToInt64(inputDataType, inputData);
-        if (IsFractionalElementType(outputDataType))
+        if constexpr (IsCastableElementType<InputDataType> && IsCastableElementType<OutputDataType>)
         {
-            WriteFromDouble(outputDataType, static_cast<double>(value), outputData);
+            return &CastElementTypeArrayKernel<InputDataType, OutputDataType>;
         }
         else
         {
-            WriteFromInt64(outputDataType, value, outputData);
+            return &CastElementTypeArrayUnsupported;
         }
     }
+};
+
+template <typename FunctionGetter, size_t InputIndex, size_t... OutputIndices>
+constexpr auto MakeElementTypePairTableRow(std::index_sequence<OutputIndices...>) noexcept
+{
+    return std::array{FunctionGetter::template Get<ElementType(InputIndex), ElementType(OutputIndices)>()...};
+}
+
+// Every (input, output) pair of element types, from the getter's function for each pair.
+template <typename FunctionGetter, size_t... InputIndices>
+constexpr auto MakeElementTypePairTable(std::index_sequence<InputIndices...>) noexcept
+{
+    return std::array{MakeElementTypePairTableRow<FunctionGetter, InputIndices>(std::make_index_sequence<size_t(ElementType::Total)>())...};
+}
+
+// The indices are [input ElementType][output ElementType].
+constexpr auto g_castElementTypeFunctions = MakeElementTypePairTable<CastElementTypeFunctionGetter>(std::make_index_sequence<size_t(ElementType::Total)>());
+constexpr auto g_castElementTypeArrayFunctions = MakeElementTypePairTable<CastElementTypeArrayFunctionGetter>(std::make_index_sequence<size_t(ElementType::Total)>());
+static_assert(std::size(g_castElementTypeFunctions) == size_t(ElementType::Total));
+static_assert(std::size(g_castElementTypeArrayFunctions) == size_t(ElementType::Total));
+
+// Cast copy a single element from the input type to output type.
+void CastElementType(
+    ElementType inputDataType,
+    ElementType outputDataType,
+    void const* inputData,
+    /*out*/ void* outputData
+)
+{
+    size_t inputIndex = static_cast<size_t>(inputDataType);
+    size_t outputIndex = static_cast<size_t>(outputDataType);
+    if (inputIndex >= size_t(ElementType::Total) || outputIndex >= size_t(ElementType::Total))
+    {
+        throw std::invalid_argument("Element type is out of range.");
+    }
+
+    g_castElementTypeFunctions[inputIndex][outputIndex](inputData, /*out*/ outputData);
 }
 
 // Cast from input type to output type, returning direct reference to the output data.
@@ -737,6 +1192,26 @@ NumberUnionAndType CastNumberType(NumberUnionAndType const& input, ElementType o
     return output;
 }
 
+// Cast copy an array of elements from the input type to output type.
+// The input and output must not overlap.
+void CastElementTypeArray(
+    ElementType inputDataType,
+    ElementType outputDataType,
+    void const* inputData,
+    /*out*/ void* outputData,
+    size_t count
+)
+{
+    size_t inputIndex = static_cast<size_t>(inputDataType);
+    size_t outputIndex = static_cast<size_t>(outputDataType);
+    if (inputIndex >= size_t(ElementType::Total) || outputIndex >= size_t(ElementType::Total))
+    {
+        throw std::invalid_argument("Element type is out of range.");
+    }
+
+    g_castElementTypeArrayFunctions[inputIndex][outputIndex](inputData, /*out*/ outputData, count);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 std::string_view GetNumericOperationNameFromNumericOperationType(NumericOperationType numericOperationType) noexcept
@@ -1020,6 +1495,8 @@ void SprintAllNumericTypesToBinary(
     output = CastNumberType(input, ElementType::Int32); SprintNumericType(/*inout*/ stringOutput, ElementType::Int32, &output.numberUnion.i32, leftFlank, rightFlank, numericPrintingFlags, numberElementType);
     output = CastNumberType(input, ElementType::Int64); SprintNumericType(/*inout*/ stringOutput, ElementType::Int64, &output.numberUnion.i64, leftFlank, rightFlank, numericPrintingFlags, numberElementType);
 
+    output = CastNumberType(input, ElementType::Float8m3e4s1); SprintNumericType(/*inout*/ stringOutput, ElementType::Float8m3e4s1, &output.numberUnion.f3e4s1, leftFlank, rightFlank, numericPrintingFlags, numberElementType);
+    output = CastNumberType(input, ElementType::Float8m2e5s1); SprintNumericType(/*inout*/ stringOutput, ElementType::Float8m2e5s1, &output.numberUnion.f2e5s1, leftFlank, rightFlank, numericPrintingFlags, numberElementType);
     output = CastNumberType(input, ElementType::Float16 ); SprintNumericType(/*inout*/ stringOutput, ElementType::Float16,  &output.numberUnion.f16, leftFlank, rightFlank, numericPrintingFlags, numberElementType);
     output = CastNumberType(input, ElementType::Bfloat16); SprintNumericType(/*inout*/ stringOutput, ElementType::Bfloat16, &output.numberUnion.f16m7e8s1, leftFlank, rightFlank, numericPrintingFlags, numberElementType);
     output = CastNumberType(input, ElementType::Float32 ); SprintNumericType(/*inout*/ stringOutput, ElementType::Float32,  &output.numberUnion.f32, leftFlank, rightFlank, numericPrintingFlags, numberElementType);
@@ -1055,6 +1532,8 @@ void SprintAllNumericTypesFromBinary(
     SprintNumericType(/*inout*/ stringOutput, ElementType::Int32,  &numberUnion.i32, leftFlank, rightFlank, numericPrintingFlags, originalElementType);
     SprintNumericType(/*inout*/ stringOutput, ElementType::Int64,  &numberUnion.i64, leftFlank, rightFlank, numericPrintingFlags, originalElementType);
 
+    SprintNumericType(/*inout*/ stringOutput, ElementType::Float8m3e4s1, &numberUnion.f3e4s1, leftFlank, rightFlank, numericPrintingFlags, originalElementType);
+    SprintNumericType(/*inout*/ stringOutput, ElementType::Float8m2e5s1, &numberUnion.f2e5s1, leftFlank, rightFlank, numericPrintingFlags, originalElementType);
     SprintNumericType(/*inout*/ stringOutput, ElementType::Float16,  &numberUnion.f16, leftFlank, rightFlank, numericPrintingFlags, originalElementType);
     SprintNumericType(/*inout*/ stringOutput, ElementType::Bfloat16, &numberUnion.f16m7e8s1,      leftFlank, rightFlank, numericPrintingFlags, originalElementType);
     SprintNumericType(/*inout*/ stringOutput, ElementType::Float32,  &numberUnion.f32, leftFlank, rightFlank, numericPrintingFlags, originalElementType);
@@ -1206,20 +1685,46 @@ void ParseNumber(
     }
 }
 
-void SprintAllNumbers(/*inout*/ std::string& stringOutput, Span<const NumberUnionAndType> numbers)
+void SprintAllNumbers(/*inout*/ std::string& stringOutput, NumberListView numbers)
 {
     constexpr std::string_view leftFlank = " (";
     constexpr std::string_view rightFlank = ")";
 
-    for (NumberUnionAndType const& number : numbers)
-    {
-        if (number.elementType != ElementType::Undefined)
+    numbers.ForEachRun(
+        [&](NumberRun const& run)
         {
-            stringOutput.append("    ");
-            AppendFormattedNumericValue(/*inout*/ stringOutput, number.elementType, &number.numberUnion, leftFlank, rightFlank, number.printingFlags);
-            stringOutput.append("\n");
+            if (run.elementType == ElementType::Undefined)
+            {
+                return;
+            }
+
+            // Files can hold billions of operands, so just name them.
+            if (!run.sourcePath.empty())
+            {
+                AppendFormatted(
+                    /*inout*/ stringOutput,
+                    "    %10s[%zu] from file %.*s\n",
+                    GetTypeNameFromElementType(run.elementType).data(),
+                    run.count,
+                    int(run.sourcePath.size()),
+                    run.sourcePath.data()
+                );
+                return;
+            }
+
+            // Copy each out to a full union, since the readers may read past a packed element.
+            size_t const elementByteSize = g_byteSizeOfElementType[size_t(run.elementType)];
+            uint8_t const* data = reinterpret_cast<uint8_t const*>(run.data);
+            for (size_t i = 0; i < run.count; ++i)
+            {
+                NumberUnion numberUnion;
+                std::memcpy(&numberUnion, data + i * elementByteSize, elementByteSize);
+                stringOutput.append("    ");
+                AppendFormattedNumericValue(/*inout*/ stringOutput, run.elementType, &numberUnion, leftFlank, rightFlank, run.printingFlags);
+                stringOutput.append("\n");
+            }
         }
-    }
+    );
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1238,317 +1743,980 @@ template<> Fixed24f12i12 Truncate(Fixed24f12i12 t) { t.Truncate(); return t; }
 template<> Fixed32f16i16 Truncate(Fixed32f16i16 t) { t.Truncate(); return t; }
 template<> Fixed32f24i8 Truncate(Fixed32f24i8 t) { t.Truncate(); return t; }
 
+template<typename T> void AddInPlace(/*inout*/ T& a, T b) { a += b; }
+template<typename T> void SubtractInPlace(/*inout*/ T& a, T b) { a -= b; }
+template<typename T> void MultiplyInPlace(/*inout*/ T& a, T b) { a *= b; }
+template<typename T> void DivideInPlace(/*inout*/ T& a, T b) { a /= b; }
+
+// float16 math decodes via the lookup table and computes in float32, rounding each result to
+// nearest even. float32 has enough bits that the double rounding is still correct, whereas the
+// half operators convert with half2float_impl and then truncate the result.
+float ReadFloat16(float16_t value) noexcept { return ConvertFloat16BitsToFloat32ViaTable(CastReferenceAs<uint16_t>(value)); }
+void WriteFloat16(float value, /*out*/ float16_t& data) noexcept { CastReferenceAs<uint16_t>(data) = ConvertFloat32ToFloat16Bits(value); }
+template<> void AddInPlace(/*inout*/ float16_t& a, float16_t b) { WriteFloat16(ReadFloat16(a) + ReadFloat16(b), /*out*/ a); }
+template<> void SubtractInPlace(/*inout*/ float16_t& a, float16_t b) { WriteFloat16(ReadFloat16(a) - ReadFloat16(b), /*out*/ a); }
+template<> void MultiplyInPlace(/*inout*/ float16_t& a, float16_t b) { WriteFloat16(ReadFloat16(a) * ReadFloat16(b), /*out*/ a); }
+template<> void DivideInPlace(/*inout*/ float16_t& a, float16_t b) { WriteFloat16(ReadFloat16(a) / ReadFloat16(b), /*out*/ a); }
+template<> float16_t Truncate(float16_t t) { WriteFloat16(std::trunc(ReadFloat16(t)), /*out*/ t); return t; }
+template<> float8m3e4s1_t Truncate(float8m3e4s1_t t) { return float8m3e4s1_t(std::trunc(float(t))); }
+template<> float8m2e5s1_t Truncate(float8m2e5s1_t t) { return float8m2e5s1_t(std::trunc(float(t))); }
+
 ////////////////////////////////////////////////////////////////////////////////
 
-struct INumericOperationPerformer
+// Each operation is a plain loop over an array of a single type, after the operands
+// are cast to that type, so the element math inlines rather than going through a
+// virtual call per operation and a type switch per operand. Constants are float
+// literals since the float8 types are ambiguous between their float and double
+// constructors for an int.
+
+template <typename T>
+T AddArray(T const* values, size_t count)
 {
-    virtual void Add(Span<const NumberUnionAndType> numbers, _Out_ NumberUnionAndType& finalResult) = 0;
-    virtual void Subtract(Span<const NumberUnionAndType> numbers, _Out_ NumberUnionAndType& finalResult) = 0;
-    virtual void Multiply(Span<const NumberUnionAndType> numbers, _Out_ NumberUnionAndType& finalResult) = 0;
-    virtual void Divide(Span<const NumberUnionAndType> numbers, _Out_ NumberUnionAndType& finalResult) = 0;
-    virtual void Dot(Span<const NumberUnionAndType> numbers, _Out_ NumberUnionAndType& finalResult) = 0;
-    virtual void Truncate(Span<const NumberUnionAndType> numbers, _Out_ Span<NumberUnionAndType> results) = 0;
-};
+    T result = T(0.0f);
+    for (size_t i = 0; i < count; ++i)
+    {
+        AddInPlace(/*inout*/ result, values[i]);
+    }
+    return result;
+}
 
 template <typename T>
-class NumericOperationPerformer : public INumericOperationPerformer
+T SubtractArray(T const* values, size_t count)
 {
-    void Add(Span<const NumberUnionAndType> numbers, _Out_ NumberUnionAndType& finalResult) override
+    if (count == 0)
     {
-        T result = T(0);
-        NumberUnionAndType intermediate = finalResult; // Intermediate needed for casting.
+        return T(0.0f);
+    }
 
-        for (NumberUnionAndType const& n : numbers)
-        {
-            result += CastNumberType<T>(n, /*inout*/ intermediate);
-        }
-        CastReferenceAs<T>(finalResult) = result;
+    T result = values[0];
+    for (size_t i = 1; i < count; ++i)
+    {
+        SubtractInPlace(/*inout*/ result, values[i]);
     }
+    return result;
+}
 
-    void Subtract(Span<const NumberUnionAndType> numbers, _Out_ NumberUnionAndType& finalResult) override
+template <typename T>
+T MultiplyArray(T const* values, size_t count)
+{
+    T result = T(1.0f);
+    for (size_t i = 0; i < count; ++i)
     {
-        T result = T(0);
-        NumberUnionAndType intermediate = finalResult;
+        MultiplyInPlace(/*inout*/ result, values[i]);
+    }
+    return result;
+}
 
-        if (!numbers.empty())
-        {
-            result = CastNumberType<T>(numbers.front(), /*inout*/ intermediate);
+template <typename T>
+T DivideArray(T const* values, size_t count)
+{
+    if (count == 0)
+    {
+        return T(0.0f);
+    }
 
-            numbers.PopFront();
-            for (NumberUnionAndType const& n : numbers)
-            {
-                result -= CastNumberType<T>(n, /*inout*/ intermediate);
-            }
-        }
-        CastReferenceAs<T>(finalResult) = result;
-    };
+    T result = values[0];
+    for (size_t i = 1; i < count; ++i)
+    {
+        DivideInPlace(/*inout*/ result, values[i]);
+    }
+    return result;
+}
+
+// Sum the products of each pair, plus the last value if there is an odd count.
+template <typename T>
+T DotArray(T const* values, size_t count)
+{
+    T result = T(0.0f);
+    size_t i = 0;
+    size_t const evenCount = count & ~size_t(1);
 
-    void Multiply(Span<const NumberUnionAndType> numbers, _Out_ NumberUnionAndType& finalResult) override
+    for (i = 0; i < evenCount; i += 2)
     {
-        T result = T(1);
-        NumberUnionAndType intermediate = finalResult;
+        T product = values[i];
+        MultiplyInPlace(/*inout*/ product, values[i + 1]);
+        AddInPlace(/*inout*/ result, product);
+    }
+    if (i < count)
+    {
+        AddInPlace(/*inout*/ result, values[i]);
+    }
+    return result;
+}
 
-        for (auto& n : numbers)
-        {
-            result *= CastNumberType<T>(n, /*inout*/ intermediate);
-        }
-        CastReferenceAs<T>(finalResult) = result;
-    };
+// The hardware float types have vectorized kernels (see DotProduct.h), which sum the products
+// in one fixed lane layout so every machine gets the same bits.
+template <> float32_t DotArray(float32_t const* values, size_t count)
+{
+    return DotInterleavedFloat32(values, count);
+}
+
+template <> float64_t DotArray(float64_t const* values, size_t count)
+{
+    return DotInterleavedFloat64(values, count);
+}
 
-    void Divide(Span<const NumberUnionAndType> numbers, _Out_ NumberUnionAndType& finalResult) override
+template <> float16_t DotArray(float16_t const* values, size_t count)
+{
+    float16_t result;
+    CastReferenceAs<uint16_t>(result) = DotInterleavedFloat16(reinterpret_cast<uint16_t const*>(values), count);
+    return result;
+}
+
+template <> bfloat16_t DotArray(bfloat16_t const* values, size_t count)
+{
+    bfloat16_t result;
+    result.value = DotInterleavedBfloat16(reinterpret_cast<uint16_t const*>(values), count);
+    return result;
+}
+
+// Flip the sign bit of every value, which negates any float type exactly.
+template <typename T>
+void NegateFloatArray(/*inout*/ T* values, size_t count)
+{
+    using Bits = std::conditional_t<sizeof(T) == 1, uint8_t,
+                 std::conditional_t<sizeof(T) == 2, uint16_t,
+                 std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>>>;
+    static_assert(sizeof(Bits) == sizeof(T));
+
+    for (size_t i = 0; i < count; ++i)
     {
-        T result = T(0);
-        NumberUnionAndType intermediate = finalResult;
+        CastReferenceAs<Bits>(values[i]) ^= Bits(1) << (sizeof(T) * 8 - 1);
+    }
+}
+
+// Sum in the given summation mode (see Summation.h). float32 and float64 have vectorized
+// kernels, and the emulated float types compute in float32, rounding every step to their
+// own precision like AddInPlace does.
+template <ElementType DataType>
+ElementTypeStorageType<DataType> SumArray(ElementTypeStorageType<DataType> const* values, size_t count, SummationMode summationMode)
+{
+    using T = ElementTypeStorageType<DataType>;
 
-        if (!numbers.empty())
+    if constexpr (!IsRawFloatElementType(DataType))
+    {
+        return AddArray(values, count);
+    }
+    else if (summationMode == SummationMode::Sequential)
+    {
+        return AddArray(values, count);
+    }
+    else if constexpr (DataType == ElementType::Float32)
+    {
+        return SumFloat32Array(values, count, summationMode);
+    }
+    else if constexpr (DataType == ElementType::Float64)
+    {
+        return SumFloat64Array(values, count, summationMode);
+    }
+    else
+    {
+        auto decode = [](T value) noexcept { return float(ReadElementToDouble(value)); };
+        auto round = [](float value) noexcept
         {
-            result = CastNumberType<T>(numbers.front(), /*inout*/ intermediate);
+            T rounded;
+            WriteElementFromDouble(value, /*out*/ rounded);
+            return float(ReadElementToDouble(rounded));
+        };
+
+        T result;
+        WriteElementFromDouble(SumArrayScalar<float>(values, count, summationMode, decode, round), /*out*/ result);
+        return result;
+    }
+}
 
-            numbers.PopFront();
-            for (NumberUnionAndType const& n : numbers)
+// Subtracting every later value is adding its negation, which is exact, so the values are
+// negated in place and then summed.
+template <ElementType DataType>
+ElementTypeStorageType<DataType> SubtractArray(/*inout*/ ElementTypeStorageType<DataType>* values, size_t count, SummationMode summationMode)
+{
+    if constexpr (IsRawFloatElementType(DataType))
+    {
+        if (summationMode != SummationMode::Sequential && count > 1)
+        {
+            NegateFloatArray(/*inout*/ values + 1, count - 1);
+            return SumArray<DataType>(values, count, summationMode);
+        }
+    }
+    return SubtractArray(values, count);
+}
+
+// Dot in the given summation mode. The products (and any odd last value) are packed into the
+// front of the values, then summed. Sequential keeps the fused kernels of DotArray.
+template <ElementType DataType>
+ElementTypeStorageType<DataType> DotArray(/*inout*/ ElementTypeStorageType<DataType>* values, size_t count, SummationMode summationMode)
+{
+    if constexpr (IsRawFloatElementType(DataType))
+    {
+        if (summationMode != SummationMode::Sequential)
+        {
+            size_t const productCount = count / 2;
+            for (size_t i = 0; i < productCount; ++i)
             {
-                result /= CastNumberType<T>(n, /*inout*/ intermediate);
+                auto product = values[i * 2];
+                MultiplyInPlace(/*inout*/ product, values[i * 2 + 1]);
+                values[i] = product;
             }
+            if (count & 1)
+            {
+                values[productCount] = values[count - 1];
+            }
+            return SumArray<DataType>(values, productCount + (count & 1), summationMode);
         }
-        CastReferenceAs<T>(finalResult) = result;
+    }
+    return DotArray(values, count);
+}
+
+// Combine the chunk sums in the summation mode. Compensated modes sum them with compensation,
+// in chunk order, and the rest as a tree.
+template <ElementType DataType>
+ElementTypeStorageType<DataType> CombineSumPartials(
+    /*inout*/ std::pmr::vector<ElementTypeStorageType<DataType>>& partials,
+    SummationMode summationMode
+)
+{
+    using T = ElementTypeStorageType<DataType>;
+
+    if (summationMode == SummationMode::Kahan || summationMode == SummationMode::Neumaier)
+    {
+        return SumArray<DataType>(partials.data(), partials.size(), summationMode);
+    }
+    return CombineInTreeOrder(/*inout*/ partials, [](T a, T b) { AddInPlace(/*inout*/ a, b); return a; });
+}
+
+template <ElementType DataType>
+ElementTypeStorageType<DataType> CombineProductPartials(/*inout*/ std::pmr::vector<ElementTypeStorageType<DataType>>& partials)
+{
+    using T = ElementTypeStorageType<DataType>;
+
+    return CombineInTreeOrder(/*inout*/ partials, [](T a, T b) { MultiplyInPlace(/*inout*/ a, b); return a; });
+}
+
+// Reduce the sum of each chunk across threads, and combine the chunk sums in the same summation mode.
+template <ElementType DataType, typename ReduceChunkFunction>
+ElementTypeStorageType<DataType> SumInChunks(
+    size_t count,
+    NumericOperationOptions const& options,
+    std::pmr::memory_resource* scratch,
+    ReduceChunkFunction reduceChunk
+)
+{
+    using T = ElementTypeStorageType<DataType>;
+
+    auto combineAll = [&](/*inout*/ std::pmr::vector<T>& partials) -> T
+    {
+        return CombineSumPartials<DataType>(/*inout*/ partials, options.summationMode);
     };
+    return ReduceInChunks<T>(count, options.threadCount, reduceChunk, combineAll, g_reductionChunkSize, /*threadPool*/ nullptr, scratch);
+}
+
+template <ElementType DataType, typename ReduceChunkFunction>
+ElementTypeStorageType<DataType> MultiplyInChunks(
+    size_t count,
+    NumericOperationOptions const& options,
+    std::pmr::memory_resource* scratch,
+    ReduceChunkFunction reduceChunk
+)
+{
+    using T = ElementTypeStorageType<DataType>;
 
-    void Dot(Span<const NumberUnionAndType> numbers, _Out_ NumberUnionAndType& finalResult) override
+    auto combineAll = [](/*inout*/ std::pmr::vector<T>& partials) -> T
     {
-        T result = T(0); 
-        size_t i = 0;
-        size_t numberCount = numbers.size();
-        size_t evenNumberCount = numbers.size() & ~size_t(1);
-        NumberUnionAndType intermediate1 = finalResult;
-        NumberUnionAndType intermediate2 = finalResult;
+        return CombineProductPartials<DataType>(/*inout*/ partials);
+    };
+    return ReduceInChunks<T>(count, options.threadCount, reduceChunk, combineAll, g_reductionChunkSize, /*threadPool*/ nullptr, scratch);
+}
 
-        for (i = 0; i < evenNumberCount; i += 2)
-        {
-            T product = CastNumberType<T>(numbers[i],     /*out*/ intermediate1)
-                      * CastNumberType<T>(numbers[i + 1], /*out*/ intermediate2);
-            result += product;
-        }
-        if (i < numberCount)
-        {
-            result += CastNumberType<T>(numbers[i], /*out*/ intermediate1);
-        }
-        CastReferenceAs<T>(finalResult) = result;
+template <typename T>
+void TruncateArray(/*inout*/ T* values, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        values[i] = ::Truncate(values[i]);
+    }
+}
+
+// Reduce an array of the result type in a wider (or narrower) accumulator type, a block at a time.
+// Each block is widened with the vectorized array casts and reduced with the accumulator type's own
+// kernels, then the running total is rounded to the result type if a block size was given.
+// Without a block size, the chunks are independent and reduced across threads instead.
+// The widened values go in scratch memory, a chunk's worth per thread.
+template <ElementType AccumulatorDataType>
+void AccumulateNumericOperationKernel(
+    NumericOperationType numericOperationType,
+    ElementType resultDataType,
+    void const* values,
+    size_t count,
+    NumericOperationOptions const& options,
+    std::pmr::memory_resource* scratch,
+    /*out*/ void* result
+)
+{
+    using A = ElementTypeStorageType<AccumulatorDataType>;
+    uint32_t const blockSize = options.accumulationBlockSize;
 
-    #if 0 // Experimental rounding.
-        constexpr uint64_t mantissaMaskLowBits = (0x1ui64 << 42) - 1;
-        constexpr uint64_t mantissaMaskHighBits = ~mantissaMaskLowBits;
-        constexpr uint64_t mantissaEvenBit = 0x1ui64 << 42;
-        constexpr uint64_t mantissaMaskRoundingBit = 1ui64 << (42 - 1);
+    // Dot reduces pairs, so its blocks count products rather than operands.
+    size_t const valuesPerOperand = (numericOperationType == NumericOperationType::Dot) ? 2 : 1;
+    size_t const resultByteSize = g_byteSizeOfElementType[size_t(resultDataType)];
+    uint8_t const* valueBytes = reinterpret_cast<uint8_t const*>(values);
 
-        // Round halves to evens
-        NumberUnion result;
-        result.f64 = double(0);
-        size_t i = 0;
-        size_t numberCount = numbers.size();
-        size_t evenNumberCount = numbers.size() & ~size_t(1);
+    auto reduceBlock = [&](size_t begin, size_t blockCount, /*out*/ A* blockValues) -> A
+    {
+        CastElementTypeArray(resultDataType, AccumulatorDataType, valueBytes + begin * resultByteSize, /*out*/ blockValues, blockCount);
 
-        for (i = 0; i < evenNumberCount; i += 2)
+        switch (numericOperationType)
         {
-            NumberUnion product;
-            product.f64 = double(CastAs<T>(numbers[i])) * double(CastAs<T>(numbers[i + 1]));
+        case NumericOperationType::Add:         return SumArray<AccumulatorDataType>(blockValues, blockCount, options.summationMode);
+        case NumericOperationType::Multiply:    return MultiplyArray(blockValues, blockCount);
+        case NumericOperationType::Dot:         return DotArray<AccumulatorDataType>(blockValues, blockCount, options.summationMode);
+        default: assert(false); return A(0.0f);
+        }
+    };
 
-            if ((product.ui64 & mantissaMaskLowBits) == mantissaMaskRoundingBit)
+    A total;
+    if (blockSize == 0)
+    {
+        // A single chunk runs on the calling thread, so it needs neither more buffers nor the pool.
+        size_t const chunkValueCount = std::min(count, g_reductionChunkSize);
+        uint32_t const chunkThreadCount = (count > g_reductionChunkSize) ? ThreadPool::GetShared().GetThreadCount(options.threadCount) : 1;
+        std::pmr::vector<A> chunkValues(chunkValueCount * chunkThreadCount, scratch);
+        auto reduceChunk = [&](size_t begin, size_t chunkCount, uint32_t threadIndex) -> A
+        {
+            return reduceBlock(begin, chunkCount, /*out*/ chunkValues.data() + threadIndex * chunkValueCount);
+        };
+        total = (numericOperationType == NumericOperationType::Multiply)
+              ? MultiplyInChunks<AccumulatorDataType>(count, options, scratch, reduceChunk)
+              : SumInChunks<AccumulatorDataType>(count, options, scratch, reduceChunk);
+    }
+    else
+    {
+        size_t const blockValueCount = blockSize * valuesPerOperand;
+        std::pmr::vector<A> blockValues(std::min(count, blockValueCount), scratch);
+        total = (numericOperationType == NumericOperationType::Multiply) ? A(1.0f) : A(0.0f);
+        for (size_t i = 0; i < count; i += blockValueCount)
+        {
+            size_t const blockCount = std::min(count - i, blockValueCount);
+            A const blockTotal = reduceBlock(i, blockCount, /*out*/ blockValues.data());
+            if (numericOperationType == NumericOperationType::Multiply)
             {
-                product.ui64 += (product.ui64 & mantissaEvenBit) ? -int64_t(mantissaMaskRoundingBit) : mantissaMaskRoundingBit;
+                MultiplyInPlace(/*inout*/ total, blockTotal);
             }
-            result.f64 += product.f64;
-            if ((result.ui64 & mantissaMaskLowBits) == mantissaMaskRoundingBit)
+            else
             {
-                result.ui64 += (result.ui64 & mantissaEvenBit) ? -int64_t(mantissaMaskRoundingBit) : mantissaMaskRoundingBit;
+                AddInPlace(/*inout*/ total, blockTotal);
             }
+
+            NumberUnion rounded;
+            CastElementType(AccumulatorDataType, resultDataType, &total, /*out*/ &rounded);
+            CastElementType(resultDataType, AccumulatorDataType, &rounded, /*out*/ &total);
         }
-        if (i < numberCount)
-        {
-            result.f64 += CastAs<T>(numbers[i]);
-            if ((result.ui64 & mantissaMaskLowBits) == mantissaMaskRoundingBit)
+    }
+
+    CastElementType(AccumulatorDataType, resultDataType, &total, /*out*/ result);
+}
+
+using AccumulateNumericOperationFunction = void(*)(
+    NumericOperationType numericOperationType,
+    ElementType resultDataType,
+    void const* values,
+    size_t count,
+    NumericOperationOptions const& options,
+    std::pmr::memory_resource* scratch,
+    /*out*/ void* result
+);
+
+struct AccumulateNumericOperationFunctionGetter
+{
+    template <ElementType DataType>
+    static constexpr AccumulateNumericOperationFunction Get() noexcept
+    {
+        return &AccumulateNumericOperationKernel<DataType>;
+    }
+};
+
+constexpr bool IsAccumulatingNumericOperation(NumericOperationType numericOperationType) noexcept
+{
+    return numericOperationType == NumericOperationType::Add
+        || numericOperationType == NumericOperationType::Multiply
+        || numericOperationType == NumericOperationType::Dot;
+}
+
+template <ElementType... DataTypes>
+struct ElementTypeList
+{
+};
+
+// Every element type that numeric operations compute in. Adding a type here
+// instantiates its kernels and registers them in the dispatch tables.
+using NumericOperationElementTypes = ElementTypeList<
+    ElementType::Float32,
+    ElementType::Float64,
+    ElementType::Float16,
+    ElementType::Bfloat16,
+    ElementType::Float8m3e4s1,
+    ElementType::Float8m2e5s1,
+    ElementType::Uint8,
+    ElementType::Uint16,
+    ElementType::Uint32,
+    ElementType::Uint64,
+    ElementType::Int8,
+    ElementType::Int16,
+    ElementType::Int32,
+    ElementType::Int64,
+    ElementType::Fixed24f12i12,
+    ElementType::Fixed32f16i16,
+    ElementType::Fixed32f24i8
+>;
+
+// Indexed by ElementType, with nullptr for types missing from the list.
+template <typename FunctionGetter, ElementType... DataTypes>
+constexpr auto MakeElementTypeFunctionTable(ElementTypeList<DataTypes...>) noexcept
+{
+    using Function = decltype(FunctionGetter::template Get<ElementType::Float32>());
+    std::array<Function, size_t(ElementType::Total)> table = {};
+    ((table[size_t(DataTypes)] = FunctionGetter::template Get<DataTypes>()), ...);
+    return table;
+}
+
+constexpr auto g_accumulateNumericOperationFunctions = MakeElementTypeFunctionTable<AccumulateNumericOperationFunctionGetter>(NumericOperationElementTypes{});
+
+// Cast every run of operands to the computation type, then apply the operation to the whole array,
+// appending the results to the list. Temporaries come from the scratch memory.
+template <ElementType DataType>
+void PerformNumericOperationKernel(
+    NumericOperationType numericOperationType,
+    NumberListView numbers,
+    NumericOperationOptions const& options,
+    NumericPrintingFlags printingFlags,
+    std::pmr::memory_resource* scratch,
+    /*inout*/ NumberList& results
+)
+{
+    using T = ElementTypeStorageType<DataType>;
+    static_assert(sizeof(T) <= sizeof(NumberUnion));
+    static_assert(sizeof(T) == g_byteSizeOfElementType[size_t(DataType)]);
+
+    ElementType const accumulatorDataType = options.accumulatorElementType;
+    bool const isAccumulatorType = accumulatorDataType != ElementType::Undefined && accumulatorDataType != DataType && IsAccumulatingNumericOperation(numericOperationType);
+
+    // Truncate and the non-sequential subtract and dot of float types rewrite the operands in place.
+    bool const isOperandArrayModified = !isAccumulatorType
+        && (numericOperationType == NumericOperationType::Truncate
+        || (IsRawFloatElementType(DataType) && options.summationMode != SummationMode::Sequential
+            && (numericOperationType == NumericOperationType::Subtract || numericOperationType == NumericOperationType::Dot)));
+
+    // Operands that are a single run already in the computation type (the common case, including
+    // mapped files) are read where they are, with no casting or copying, unless the operation
+    // modifies them. Otherwise each run is cast whole.
+    size_t const count = numbers.size();
+    T const* data = nullptr;
+    std::pmr::vector<T> values(scratch);
+    if (!isOperandArrayModified)
+    {
+        data = reinterpret_cast<T const*>(numbers.GetSingleRunData(DataType));
+    }
+    if (data == nullptr)
+    {
+        values.resize(count);
+        size_t valueIndex = 0;
+        numbers.ForEachRun(
+            [&](NumberRun const& run)
             {
-                result.ui64 += (result.ui64 & mantissaEvenBit) ? -int64_t(mantissaMaskRoundingBit) : mantissaMaskRoundingBit;
+                CastElementTypeArray(run.elementType, DataType, run.data, /*out*/ values.data() + valueIndex, run.count);
+                valueIndex += run.count;
             }
-        }
-        CastAs<T>(finalResult) = T(float(result.f64));
+        );
+        data = values.data();
+    }
 
-        // Round halves towards infinity
-        NumberUnion result;
-        result.f64 = double(0);
-        size_t i = 0;
-        size_t numberCount = numbers.size();
-        size_t evenNumberCount = numbers.size() & ~size_t(1);
+    T result = {};
 
-        for (i = 0; i < evenNumberCount; i += 2)
-        {
-            NumberUnion product;
-            product.f64 = double(CastAs<T>(numbers[i])) * double(CastAs<T>(numbers[i + 1]));
-            product.ui64 += (0x1ui64 << 41);
-            product.ui64 &= ~((0x1ui64 << 42) - 1);
-            result.f64 += product.f64;
-            result.ui64 += (0x1ui64 << 41);
-            result.ui64 &= ~((0x1ui64 << 42) - 1);
-        }
-        if (i < numberCount)
+    if (isAccumulatorType)
+    {
+        AccumulateNumericOperationFunction accumulateFunction = (size_t(accumulatorDataType) < g_accumulateNumericOperationFunctions.size())
+            ? g_accumulateNumericOperationFunctions[size_t(accumulatorDataType)]
+            : nullptr;
+        if (accumulateFunction == nullptr)
         {
-            result.f64 += CastAs<T>(numbers[i]);
-            result.ui64 += (0x1ui64 << 41);
-            result.ui64 &= ~((0x1ui64 << 42) - 1);
+            throw std::invalid_argument("Accumulator type is not supported.");
         }
-        CastAs<T>(finalResult) = T(float(result.f64));
-    #endif
+        accumulateFunction(numericOperationType, DataType, data, count, options, scratch, /*out*/ &result);
+        results.Append(DataType, printingFlags, &result, 1);
+        return;
     }
 
-    void Truncate(Span<const NumberUnionAndType> numbers, _Out_ Span<NumberUnionAndType> results) override
+    switch (numericOperationType)
     {
-        assert(numbers.size() == results.size());
-        const size_t count = numbers.size();
+    case NumericOperationType::Add:
+        result = SumInChunks<DataType>(
+            count,
+            options,
+            scratch,
+            [&](size_t begin, size_t chunkCount) { return SumArray<DataType>(data + begin, chunkCount, options.summationMode); }
+        );
+        break;
+    case NumericOperationType::Subtract:
+        result = isOperandArrayModified
+               ? SubtractArray<DataType>(values.data(), count, options.summationMode)
+               : SubtractArray(data, count);
+        break;
+    case NumericOperationType::Multiply:
+        result = MultiplyInChunks<DataType>(
+            count,
+            options,
+            scratch,
+            [&](size_t begin, size_t chunkCount) { return MultiplyArray(data + begin, chunkCount); }
+        );
+        break;
+    case NumericOperationType::Divide:      result = DivideArray(data, count); break;
+    case NumericOperationType::Dot:
+        // The chunk size is even, so no pair straddles two chunks.
+        result = SumInChunks<DataType>(
+            count,
+            options,
+            scratch,
+            [&](size_t begin, size_t chunkCount)
+            {
+                return isOperandArrayModified
+                     ? DotArray<DataType>(values.data() + begin, chunkCount, options.summationMode)
+                     : DotArray(data + begin, chunkCount);
+            }
+        );
+        break;
+    case NumericOperationType::Truncate:
+        TruncateArray(/*inout*/ values.data(), count);
+        results.Append(DataType, printingFlags, values.data(), count);
+        return;
+    case NumericOperationType::None:
+    default: assert(false); return;
+    }
 
-        for (size_t i = 0; i < count; ++i)
-        {
-            NumberUnionAndType intermediate = results[i];
-            T result = CastNumberType<T>(numbers[i], /*inout*/ intermediate);
-            result = ::Truncate(result);
-            CastReferenceAs<T>(results[i]) = result;
-        }
+    results.Append(DataType, printingFlags, &result, 1);
+}
+
+using PerformNumericOperationFunction = void(*)(
+    NumericOperationType numericOperationType,
+    NumberListView numbers,
+    NumericOperationOptions const& options,
+    NumericPrintingFlags printingFlags,
+    std::pmr::memory_resource* scratch,
+    /*inout*/ NumberList& results
+);
+
+struct PerformNumericOperationFunctionGetter
+{
+    template <ElementType DataType>
+    static constexpr PerformNumericOperationFunction Get() noexcept
+    {
+        return &PerformNumericOperationKernel<DataType>;
     }
 };
 
-// Declare singletons since they are stateless anyway.
-NumericOperationPerformer<float> g_numericOperationPerformerFloat32;
-NumericOperationPerformer<double> g_numericOperationPerformerFloat64;
-NumericOperationPerformer<float16_t> g_numericOperationPerformerFloat16;
-NumericOperationPerformer<float16m7e8s1_t> g_numericOperationPerformerFloat16m7e8s1;
-NumericOperationPerformer<uint8_t> g_numericOperationPerformerUint8;
-NumericOperationPerformer<uint16_t> g_numericOperationPerformerUint16;
-NumericOperationPerformer<uint32_t> g_numericOperationPerformerUint32;
-NumericOperationPerformer<uint64_t> g_numericOperationPerformerUint64;
-NumericOperationPerformer<int8_t> g_numericOperationPerformerInt8;
-NumericOperationPerformer<int16_t> g_numericOperationPerformerInt16;
-NumericOperationPerformer<int32_t> g_numericOperationPerformerInt32;
-NumericOperationPerformer<int64_t> g_numericOperationPerformerInt64;
-NumericOperationPerformer<Fixed24f12i12> g_numericOperationPerformerFixed24f12i12;
-NumericOperationPerformer<Fixed32f16i16> g_numericOperationPerformerFixed32f16i16;
-NumericOperationPerformer<Fixed32f24i8> g_numericOperationPerformerFixed32f24i8;
-
-ElementType GetPromotedOutputElementType(Span<const NumberUnionAndType> numbers)
+// Types without numeric operations (like strings) are nullptr.
+constexpr auto g_numericOperationFunctions = MakeElementTypeFunctionTable<PerformNumericOperationFunctionGetter>(NumericOperationElementTypes{});
+
+// Combine the results of add, multiply, or dot over consecutive fixed size chunks the same way the
+// chunked reductions do, like for chunks reduced one at a time as they are streamed in.
+template <ElementType DataType>
+void CombinePartialsKernel(
+    NumericOperationType numericOperationType,
+    NumericOperationOptions const& options,
+    void const* partials,
+    size_t count,
+    std::pmr::memory_resource* scratch,
+    /*out*/ void* result
+)
+{
+    using T = ElementTypeStorageType<DataType>;
+
+    T const* typedPartials = reinterpret_cast<T const*>(partials);
+    std::pmr::vector<T> values(typedPartials, typedPartials + count, scratch);
+    T const combined = (numericOperationType == NumericOperationType::Multiply)
+        ? CombineProductPartials<DataType>(/*inout*/ values)
+        : CombineSumPartials<DataType>(/*inout*/ values, options.summationMode);
+    std::memcpy(result, &combined, sizeof(T));
+}
+
+using CombinePartialsFunction = void(*)(
+    NumericOperationType numericOperationType,
+    NumericOperationOptions const& options,
+    void const* partials,
+    size_t count,
+    std::pmr::memory_resource* scratch,
+    /*out*/ void* result
+);
+
+struct CombinePartialsFunctionGetter
+{
+    template <ElementType DataType>
+    static constexpr CombinePartialsFunction Get() noexcept
+    {
+        return &CombinePartialsKernel<DataType>;
+    }
+};
+
+constexpr auto g_combinePartialsFunctions = MakeElementTypeFunctionTable<CombinePartialsFunctionGetter>(NumericOperationElementTypes{});
+
+ElementType GetPromotedOutputElementType(NumberListView numbers)
 {
     // Determine the output element type based on the priority of each pair of types.
     // If all data types are identical or there is only one, the result is simply the first input type.
+    // Only the runs need checking, not every operand.
 
     ElementType outputElementType = ElementType::Undefined;
-    if (!numbers.empty())
-    {
-        outputElementType = numbers.front().elementType;
-        numbers.PopFront();
-
-        for (auto& number : numbers)
+    numbers.ForEachRun(
+        [&](NumberRun const& run)
         {
-            ElementType inputElementType = number.elementType;
-            outputElementType = g_elementTypePriorityTable[size_t(inputElementType)] > g_elementTypePriorityTable[size_t(outputElementType)]
+            ElementType inputElementType = run.elementType;
+            outputElementType = (outputElementType == ElementType::Undefined || g_elementTypePriorityTable[size_t(inputElementType)] > g_elementTypePriorityTable[size_t(outputElementType)])
                 ? inputElementType
                 : outputElementType;
         }
-    }
+    );
 
     return outputElementType;
 }
 
+// Apply the operation to the numbers, replacing the results. The output element type is either
+// given or promoted from the operands, except that truncate keeps each run's own type.
+// Temporaries come from the scratch memory.
 void PerformNumericOperation(
     NumericOperationType numericOperationType,
-    Span<const NumberUnionAndType> numbers,
-    _Inout_ std::vector<NumberUnionAndType>& results // in for initial element type
+    NumberListView numbers,
+    NumericOperationOptions const& options,
+    ElementType outputElementType,
+    NumericPrintingFlags printingFlags,
+    std::pmr::memory_resource* scratch,
+    /*out*/ NumberList& results
 )
 {
-    size_t resultCount = 1;
+    results.clear();
+
     switch (numericOperationType)
     {
-    // case NumericOperationType::Add:
-    // case NumericOperationType::Subtract:
-    // case NumericOperationType::Multiply:
-    // case NumericOperationType::Divide:
-    //     resultCount = 1;
-    //     break;
+    case NumericOperationType::Nothing:
+        return;
 
     case NumericOperationType::Nop:
+        AppendNumberList(/*inout*/ results, numbers);
+        return;
+
     case NumericOperationType::Truncate:
-        resultCount = numbers.size();
+        if (outputElementType == ElementType::Undefined)
+        {
+            numbers.ForEachRun(
+                [&](NumberRun const& run)
+                {
+                    NumberListView runNumbers = numbers.GetSubview(run.beginIndex, run.beginIndex + run.count);
+                    NumberList runResults(scratch);
+                    PerformNumericOperation(numericOperationType, runNumbers, options, run.elementType, run.printingFlags, scratch, /*out*/ runResults);
+                    AppendNumberList(/*inout*/ results, runResults);
+                }
+            );
+            return;
+        }
         break;
 
-    case NumericOperationType::Nothing:
-        results.clear();
-        return;
-
     default:
         break;
     }
 
-    if (resultCount <= 0)
+    if (outputElementType == ElementType::Undefined)
+    {
+        outputElementType = GetPromotedOutputElementType(numbers);
+    }
+
+    // Choose the respective operation kernels based on data type.
+    size_t const elementTypeIndex = size_t(outputElementType);
+    if (elementTypeIndex >= g_numericOperationFunctions.size())
+    {
+        throw std::invalid_argument("Element type is out of range.");
+    }
+    PerformNumericOperationFunction performFunction = g_numericOperationFunctions[elementTypeIndex];
+    if (performFunction == nullptr)
     {
         return;
     }
 
-    results.resize(resultCount);
-    ElementType promotedElementType = GetPromotedOutputElementType(numbers);
-    for (size_t i = 0; i < resultCount; ++i)
+    performFunction(numericOperationType, numbers, options, printingFlags, scratch, /*inout*/ results);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Streamed operands are parsed and reduced this many at a time, so memory stays bounded however
+// long the stream is. The chunks line up with those of the chunked reductions, so their partials
+// combine the same, and are even so that dot's pairs never straddle chunks.
+constexpr size_t g_streamChunkOperandCount = g_reductionChunkSize;
+constexpr size_t g_streamReadByteSize = size_t(1) << 16;
+
+// Splits a file into tokens separated by whitespace or commas, reading a block at a time and
+// carrying a token split across reads over to the next.
+class StreamTokenReader
+{
+public:
+    StreamTokenReader(FILE* file, std::pmr::memory_resource* memoryResource)
+    :   file_(file),
+        buffer_(g_streamReadByteSize + 1, memoryResource) // Plus a null after a final token.
+    {
+    }
+
+    // The next token, null terminated and valid until the next call, or empty at the end.
+    std::string_view GetToken()
     {
-        auto& result = results[i];
-        result.numberUnion = {};
-        // Determine the output element type based on the inputs.
-        if (result.elementType == ElementType::Undefined)
+        while (true)
         {
-            result.elementType = (resultCount > 1) ? numbers[i].elementType : promotedElementType;
+            for (/*above*/; begin_ < end_ && IsSeparator(buffer_[begin_]); ++begin_)
+            { }
+
+            size_t tokenEnd = begin_;
+            for (/*above*/; tokenEnd < end_ && !IsSeparator(buffer_[tokenEnd]); ++tokenEnd)
+            { }
+
+            // A token is complete once its separator (or the end of the file) was read.
+            if (tokenEnd < end_ || (isEndOfFile_ && tokenEnd > begin_))
+            {
+                buffer_[tokenEnd] = '\0';
+                std::string_view token(buffer_.data() + begin_, tokenEnd - begin_);
+                begin_ = std::min(tokenEnd + 1, end_);
+                return token;
+            }
+            if (isEndOfFile_)
+            {
+                return {};
+            }
+
+            // Keep the partial token, and read more after it.
+            std::memmove(buffer_.data(), buffer_.data() + begin_, end_ - begin_);
+            end_ -= begin_;
+            begin_ = 0;
+            size_t const capacity = buffer_.size() - 1;
+            if (end_ >= capacity)
+            {
+                throw std::invalid_argument("Stream token is too long.");
+            }
+            size_t const readByteCount = fread(buffer_.data() + end_, 1, capacity - end_, file_);
+            end_ += readByteCount;
+            isEndOfFile_ = (readByteCount == 0);
         }
     }
 
-    INumericOperationPerformer* performer = &g_numericOperationPerformerFloat32;
+private:
+    static bool IsSeparator(char ch) noexcept
+    {
+        return ch == ' ' || ch == ',' || ch == '\n' || ch == '\r' || ch == '\t';
+    }
+
+    FILE* file_;
+    std::pmr::vector<char> buffer_;
+    size_t begin_ = 0;
+    size_t end_ = 0;
+    bool isEndOfFile_ = false;
+};
 
-    // Choose the respective operation performer based on data type.
-    switch (results.front().elementType)
+// Write out and clear the output so far, if there is somewhere to write it as it goes.
+void FlushOutput(EvaluationContext const& context, /*inout*/ std::string& stringOutput)
+{
+    if (context.outputStream != nullptr)
     {
-    case ElementType::Undefined:        return;
-    case ElementType::Float32:          performer = &g_numericOperationPerformerFloat32; break;
-    case ElementType::Uint8:            performer = &g_numericOperationPerformerUint8; break;
-    case ElementType::Int8:             performer = &g_numericOperationPerformerInt8; break;
-    case ElementType::Uint16:           performer = &g_numericOperationPerformerUint16; break;
-    case ElementType::Int16:            performer = &g_numericOperationPerformerInt16; break;
-    case ElementType::Int32:            performer = &g_numericOperationPerformerInt32; break;
-    case ElementType::Int64:            performer = &g_numericOperationPerformerInt64; break;
-    case ElementType::StringChar8:      return;
-    case ElementType::Bool8:            return;
-    case ElementType::Float16:          performer = &g_numericOperationPerformerFloat16; break;
-    case ElementType::Float64:          performer = &g_numericOperationPerformerFloat64; break;
-    case ElementType::Uint32:           performer = &g_numericOperationPerformerUint32; break;
-    case ElementType::Uint64:           performer = &g_numericOperationPerformerUint64; break;
-    case ElementType::Complex64:        return;
-    case ElementType::Complex128:       return;
-    case ElementType::Float16m7e8s1:    performer = &g_numericOperationPerformerFloat16m7e8s1; break;
-    case ElementType::Fixed24f12i12:    performer = &g_numericOperationPerformerFixed24f12i12; break;
-    case ElementType::Fixed32f16i16:    performer = &g_numericOperationPerformerFixed32f16i16; break;
-    case ElementType::Fixed32f24i8:     performer = &g_numericOperationPerformerFixed32f24i8; break;
-    default: assert(false);
+        std::fputs(stringOutput.c_str(), context.outputStream);
+        std::fflush(context.outputStream);
+        stringOutput.clear();
     }
+}
 
-    switch (numericOperationType)
+// Apply the operation to its command line operands followed by those read from the input stream,
+// in bounded memory. Element-wise operations print each chunk's results as they go. Add, multiply,
+// and dot reduce the operands in the same fixed size chunks as the chunked reductions, keeping only
+// each chunk's result, and combine them the same way at the end, so they give exactly what a single
+// evaluation of all the operands would (except for accumulation with a block size, whose blocks
+// restart at each chunk). Subtract and divide carry the running result into the next chunk as its
+// first operand instead, which is exact when they are sequential.
+int PerformStreamedNumericOperation(
+    NumericOperationAndRange const& operation,
+    NumberListView operands,
+    EvaluationContext& context,
+    /*inout*/ std::string& stringOutput
+)
+{
+    NumericOperationType const numericOperationType = operation.numericOperationType;
+    StreamOperandFormat const& streamFormat = operation.streamFormat;
+    _Null_terminated_ const char* numericOperationName = GetNumericOperationNameFromNumericOperationType(numericOperationType).data();
+    bool const isElementWise = !IsAccumulatingNumericOperation(numericOperationType)
+                            && numericOperationType != NumericOperationType::Subtract
+                            && numericOperationType != NumericOperationType::Divide;
+    bool const isCombiningPartials = IsAccumulatingNumericOperation(numericOperationType);
+    NumericPrintingFlags const printingFlags = operands.empty() ? streamFormat.printingFlags : operands.front().printingFlags;
+
+    if (context.inputStream == nullptr)
     {
-    case NumericOperationType::Nothing:     /*no output*/ break;
-    case NumericOperationType::Nop:         results.assign(numbers.begin(), numbers.end()); break;
-    case NumericOperationType::Add:         performer->Add(numbers, /*out*/ results.front()); break;
-    case NumericOperationType::Subtract:    performer->Subtract(numbers, /*out*/ results.front()); break;
-    case NumericOperationType::Multiply:    performer->Multiply(numbers, /*out*/ results.front()); break;
-    case NumericOperationType::Divide:      performer->Divide(numbers, /*out*/ results.front()); break;
-    case NumericOperationType::Dot:         performer->Dot(numbers, /*out*/ results.front()); break;
-    case NumericOperationType::Truncate:    performer->Truncate(numbers, /*out*/ MakeSpan(results)); break;
-    case NumericOperationType::None:
-    default: assert(false);
+        stringOutput.append("There is no input stream to read operands from");
+        return EXIT_FAILURE;
+    }
+
+    AppendFormatted(/*inout*/ stringOutput, "    %10s[] from stream\n", GetTypeNameFromElementType(streamFormat.elementType).data());
+    if (isElementWise)
+    {
+        AppendFormatted(/*inout*/ stringOutput, "Result from %s:\n", numericOperationName);
     }
+    FlushOutput(context, /*inout*/ stringOutput);
+
+    // Reductions compute in the type promoted from every operand, known up front since the stream's
+    // operands are all one type, and cast the operands to it as they come. Accumulating chunks
+    // compute in the accumulator type instead, and the combined result is rounded at the end.
+    ElementType resultElementType = operation.outputElementType;
+    if (resultElementType == ElementType::Undefined)
+    {
+        resultElementType = GetPromotedOutputElementType(operands);
+        if (resultElementType == ElementType::Undefined
+        ||  g_elementTypePriorityTable[size_t(streamFormat.elementType)] > g_elementTypePriorityTable[size_t(resultElementType)])
+        {
+            resultElementType = streamFormat.elementType;
+        }
+    }
+    NumericOperationOptions chunkOptions = operation.options;
+    ElementType chunkElementType = isElementWise ? operation.outputElementType : resultElementType;
+    if (isCombiningPartials && chunkOptions.accumulatorElementType != ElementType::Undefined && chunkOptions.accumulationBlockSize == 0)
+    {
+        chunkElementType = chunkOptions.accumulatorElementType;
+        chunkOptions.accumulatorElementType = ElementType::Undefined;
+    }
+
+    CombinePartialsFunction combinePartialsFunction = nullptr;
+    if (isCombiningPartials)
+    {
+        combinePartialsFunction = (size_t(chunkElementType) < g_combinePartialsFunctions.size())
+            ? g_combinePartialsFunctions[size_t(chunkElementType)]
+            : nullptr;
+        if (combinePartialsFunction == nullptr)
+        {
+            throw std::invalid_argument("Element type is not supported.");
+        }
+    }
+
+    // The chunks live as long as the operation, whereas the temporaries of evaluating each are
+    // rewound after it. Combined reductions need one result per chunk, in chunk order.
+    std::pmr::memory_resource* scratch = &context.GetScratch();
+    ScratchArena chunkScratch(g_streamChunkOperandCount * sizeof(double) * 2, scratch);
+    StreamTokenReader tokenReader(context.inputStream, scratch);
+    NumberList chunk(scratch);
+    NumberList chunkResults(scratch);
+    NumberList partials(scratch);
+
+    auto appendOperand = [&](NumberUnionAndType number)
+    {
+        if (!isElementWise && number.elementType != resultElementType)
+        {
+            NumberUnion cast;
+            CastElementType(number.elementType, resultElementType, &number.numberUnion, /*out*/ &cast);
+            number.numberUnion = cast;
+            number.elementType = resultElementType;
+        }
+        chunk.Append(number);
+    };
+
+    size_t commandLineIndex = 0;
+    bool isEndOfStream = false;
+    NumberUnionAndType carry = {};
+    for (bool isFirstChunk = true; !isEndOfStream || commandLineIndex < operands.size(); isFirstChunk = false)
+    {
+        chunk.clear();
+        if (!isFirstChunk && !isElementWise && !isCombiningPartials)
+        {
+            chunk.Append(carry);
+        }
+
+        // Fill the chunk from the command line operands first, then the stream.
+        size_t const chunkEnd = chunk.size() + g_streamChunkOperandCount;
+        for (/*above*/; chunk.size() < chunkEnd && commandLineIndex < operands.size(); ++commandLineIndex)
+        {
+            appendOperand(operands[commandLineIndex]);
+        }
+        while (chunk.size() < chunkEnd && !isEndOfStream)
+        {
+            std::string_view token = tokenReader.GetToken();
+            if (token.empty())
+            {
+                isEndOfStream = true;
+                break;
+            }
+            if (!isdigit(token.front()) && !(token.size() >= 2 && token.front() == '-' && isdigit(token[1])))
+            {
+                AppendFormatted(/*inout*/ stringOutput, "Expected a number in the stream: \"%.*s\"", int(token.size()), token.data());
+                return EXIT_FAILURE;
+            }
+
+            NumberUnionAndType number;
+            ParseNumber(token.data(), streamFormat.elementType, streamFormat.parseAsRawData, /*out*/ number);
+            number.printingFlags = streamFormat.printingFlags;
+            appendOperand(number);
+        }
+
+        // A stream ending right at a chunk boundary leaves a last empty chunk, which only matters
+        // if there were no operands at all.
+        if (chunk.empty() && !isFirstChunk)
+        {
+            break;
+        }
+
+        {
+            ScratchArenaScope chunkScratchScope(chunkScratch);
+            PerformNumericOperation(numericOperationType, NumberListView(chunk), chunkOptions, chunkElementType, printingFlags, &chunkScratch, /*out*/ chunkResults);
+        }
+
+        if (isElementWise)
+        {
+            SprintAllNumbers(/*inout*/ stringOutput, chunkResults);
+            FlushOutput(context, /*inout*/ stringOutput);
+        }
+        else if (!chunkResults.empty())
+        {
+            carry = chunkResults[0];
+            if (isCombiningPartials)
+            {
+                partials.Append(carry);
+            }
+        }
+    }
+
+    if (!isElementWise)
+    {
+        if (isCombiningPartials && !partials.empty())
+        {
+            ScratchArenaScope chunkScratchScope(chunkScratch);
+            combinePartialsFunction(
+                numericOperationType,
+                chunkOptions,
+                NumberListView(partials).GetSingleRunData(chunkElementType),
+                partials.size(),
+                &chunkScratch,
+                /*out*/ &carry.numberUnion
+            );
+        }
+        if (carry.elementType != resultElementType && carry.elementType != ElementType::Undefined)
+        {
+            NumberUnion rounded;
+            CastElementType(carry.elementType, resultElementType, &carry.numberUnion, /*out*/ &rounded);
+            carry.numberUnion = rounded;
+            carry.elementType = resultElementType;
+        }
+
+        AppendFormatted(/*inout*/ stringOutput, "Result from %s:\n", numericOperationName);
+        chunkResults.clear();
+        if (carry.elementType != ElementType::Undefined)
+        {
+            chunkResults.Append(carry);
+        }
+        SprintAllNumbers(/*inout*/ stringOutput, chunkResults);
+    }
+
+    return EXIT_SUCCESS;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void PrintUsage()
+void PrintUsage(/*inout*/ std::string& stringOutput)
 {
-    std::puts(
+    stringOutput.append(
         "Usage:\n"
         "   binums 12.75  // floating point value in various formats\n"
         "   binums 0b1101  // read binary integer\n"
@@ -1558,6 +2726,12 @@ void PrintUsage()
         "   binums int8 fields 13 -13  // see fields of numbers\n"
         "   binums uint32 add 1.5 3.25  // perform operation\n"
         "   binums float32 add float16 2 3  // read float16, compute in float32\n"
+        "   binums float16 accumulate float32 dot 1 2 3 4  // float16 inputs, float32 accumulation\n"
+        "   binums float32 sum kahan add 1e8 1 1 1 1  // compensated summation\n"
+        "   binums float16 add file weights.bin  // raw binary file of float16 operands\n"
+        "   binums float64 add stream < numbers.txt  // text numbers from stdin, in constant memory\n"
+        "   binums --serve  // evaluate each line of stdin, writing \"<exit code> <byte count>\\n<output>\"\n"
+        "   binums --serve /tmp/binums.sock  // the same for each client of a Unix domain socket\n"
         "   binums uint32 mul 3 2 add 3 2 subtract 3 2 dot 1 2 3 4\n"
         "   binums 0x1.5p5  // floating point hexadecimal\n"
         "   binums fixed12_12 sub 3.5 2  // fixed point arithmetic\n"
@@ -1568,12 +2742,21 @@ void PrintUsage()
         "   raw num - read input as raw bit data or as number (default)\n"
         "   fields nofields - show numeric component bitfields\n"
         "   add subtract multiply divide dot nop - apply operation to following numbers\n"
-        "   float16 bfloat16 float32 float64 - set floating point data type\n"
+        "   float8e4m3 float8e5m2 float16 bfloat16 float32 float64 - set floating point data type\n"
         "   uint8 uint16 uint32 uint64 int8 int16 int32 int64 - set integer data type\n"
         "   fixed12_12 fixed16_16 fixed8_24 - set fixed precision data type\n"
+        "   accumulate <type> - accumulate add/multiply/dot in another type (undefined = result type)\n"
+        "   block <count> - round the accumulation to the result type every count operands (0 = at end)\n"
+        "   sum sequential|pairwise|kahan|neumaier - float summation order for add/subtract/dot\n"
+        "       (past 65536 operands, sequential is front to back only within each chunk of that many,\n"
+        "       and a float32/float64/float16/bfloat16 dot sums in fixed interleaved lanes, alike on any CPU)\n"
+        "   threads <count> - threads for long add/multiply/dot, same result for any count (0 = all)\n"
+        "   file <path> - map a raw binary file of the current data type as operands (quote paths with spaces)\n"
+        "   stream - the operation also reads whitespace/comma separated numbers of the current data type from stdin, in chunks\n"
         "\n"
         "Dwayne Robinson, 2019-02-14..2022-11-17, No Copyright\n"
         "https://github.com/fdwr/BiNums\n"
+        "\n"
     );
 }
 
@@ -1615,10 +2798,39 @@ std::string_view GetIdentifier(std::string_view s)
     return {s.data() + i, j - i};
 }
 
+// A path extends to the next space, unless it is in double quotes (which are excluded).
+std::string_view GetPath(std::string_view s)
+{
+    size_t i = 0;
+    size_t const size = s.size();
+
+    // Skip whitespace.
+    for (/*above*/; i < size && s[i] == ' '; ++i)
+    { }
+
+    if (i < size && s[i] == '"')
+    {
+        size_t const j = s.find('"', i + 1);
+        return {s.data() + i, (j == s.npos) ? size - i : j + 1 - i};
+    }
+
+    size_t const j = std::min(s.find(' ', i), size);
+    return {s.data() + i, j - i};
+}
+
+bool ParseUint32(std::string_view s, /*out*/ uint32_t& value)
+{
+    auto [end, errorCode] = std::from_chars(s.data(), s.data() + s.size(), /*out*/ value);
+    return errorCode == std::errc{} && end == s.data() + s.size();
+}
+
+// Parse the operations and their operands. Operands from files are mapped rather than copied into
+// the numbers, so they refer to the mapped files, which must outlive them.
 int ParseOperations(
     std::string_view operationString,
-    _Out_ std::vector<NumericOperationAndRange>& operations,
-    _Out_ std::vector<NumberUnionAndType>& numbers,
+    _Out_ std::pmr::vector<NumericOperationAndRange>& operations,
+    _Out_ NumberList& numbers,
+    _Out_ std::pmr::vector<MappedFile>& mappedFiles,
     /*out*/ std::string& errorMessage
 )
 {
@@ -1627,9 +2839,16 @@ int ParseOperations(
     ElementType preferredElementType = ElementType::Undefined;
     NumericPrintingFlags numericPrintingFlags = NumericPrintingFlags::Default;
     bool isWithinParentheses = false;
+    NumericOperationOptions numericOperationOptions;
+    bool isAccumulatorTypeExpected = false;
+    bool isBlockSizeExpected = false;
+    bool isSummationModeExpected = false;
+    bool isThreadCountExpected = false;
+    bool isStreamUsed = false;
 
     operations.clear();
     numbers.clear();
+    mappedFiles.clear();
     char const* end = operationString.data() + operationString.size();
 
     while (!operationString.empty())
@@ -1639,9 +2858,42 @@ int ParseOperations(
         operationString = std::string_view{paramEnd, size_t(end - paramEnd)};
 
         NumericOperationAndRange numericOperationAndRange = {};
+        std::optional<ElementType> parsedElementType;
 
+        if (isBlockSizeExpected)
+        {
+            if (!ParseUint32(param, /*out*/ numericOperationOptions.accumulationBlockSize))
+            {
+                errorMessage = GetFormatted("Expected a block size after \"block\": \"%.*s\"", int(param.size()), param.data());
+                return EXIT_FAILURE;
+            }
+            isBlockSizeExpected = false;
+        }
+        else if (isThreadCountExpected)
+        {
+            if (!ParseUint32(param, /*out*/ numericOperationOptions.threadCount))
+            {
+                errorMessage = GetFormatted("Expected a thread count after \"threads\": \"%.*s\"", int(param.size()), param.data());
+                return EXIT_FAILURE;
+            }
+            isThreadCountExpected = false;
+        }
+        else if (isSummationModeExpected)
+        {
+            switch (Hash(param))
+            {
+            case Hash("sequential"):    numericOperationOptions.summationMode = SummationMode::Sequential; break;
+            case Hash("pairwise"):      numericOperationOptions.summationMode = SummationMode::Pairwise; break;
+            case Hash("kahan"):         numericOperationOptions.summationMode = SummationMode::Kahan; break;
+            case Hash("neumaier"):      numericOperationOptions.summationMode = SummationMode::Neumaier; break;
+            default:
+                errorMessage = GetFormatted("Expected a summation mode after \"sum\": \"%.*s\"", int(param.size()), param.data());
+                return EXIT_FAILURE;
+            }
+            isSummationModeExpected = false;
+        }
         // Check if ordinary number or operator.
-        if ((!param.empty() && isdigit(param.front()))
+        else if ((!param.empty() && isdigit(param.front()))
         ||  (param.size() >= 2 && param.front() == '-' && isdigit(param[1])))
         {
             auto value = param.begin();
@@ -1649,7 +2901,7 @@ int ParseOperations(
             {
                 ParseNumber(&*value, preferredElementType, parseAsRawData, /*out*/ numberUnionAndType);
                 numberUnionAndType.printingFlags = numericPrintingFlags;
-                numbers.push_back(numberUnionAndType);
+                numbers.Append(numberUnionAndType);
                 value = std::find(value, param.end(), ',');
                 if (value == param.end())
                 {
@@ -1702,6 +2954,83 @@ int ParseOperations(
                 numericOperationAndRange.numericOperationType = NumericOperationType::Truncate;
                 break;
 
+            case Hash("accumulate"):
+                isAccumulatorTypeExpected = true;
+                break;
+
+            case Hash("block"):
+                isBlockSizeExpected = true;
+                break;
+
+            case Hash("sum"):
+                isSummationModeExpected = true;
+                break;
+
+            case Hash("threads"):
+                isThreadCountExpected = true;
+                break;
+
+            case Hash("stream"):
+                if (operations.empty() || isStreamUsed)
+                {
+                    errorMessage = GetFormatted(operations.empty() ? "Expected an operation before \"stream\"" : "Only one operation can read the stream");
+                    return EXIT_FAILURE;
+                }
+                // The stream's operands are one type, so the computation type is known before reading them.
+                if (preferredElementType == ElementType::Undefined || g_byteSizeOfElementType[size_t(preferredElementType)] == 0)
+                {
+                    errorMessage = "Expected a data type before \"stream\"";
+                    return EXIT_FAILURE;
+                }
+                operations.back().isStreamed = true;
+                operations.back().streamFormat = {.elementType = preferredElementType, .printingFlags = numericPrintingFlags, .parseAsRawData = parseAsRawData};
+                isStreamUsed = true;
+                break;
+
+            case Hash("file"):
+                {
+                    // Paths are not identifiers, so read straight from the string.
+                    std::string_view quotedPath = GetPath(operationString);
+                    operationString = std::string_view{quotedPath.data() + quotedPath.size(), size_t(end - (quotedPath.data() + quotedPath.size()))};
+                    std::string_view path = quotedPath;
+                    if (path.size() >= 2 && path.front() == '"' && path.back() == '"')
+                    {
+                        path = path.substr(1, path.size() - 2);
+                    }
+                    if (path.empty() || path.front() == '"')
+                    {
+                        errorMessage = GetFormatted("Expected a path after \"file\": \"%.*s\"", int(quotedPath.size()), quotedPath.data());
+                        return EXIT_FAILURE;
+                    }
+
+                    size_t const elementByteSize = g_byteSizeOfElementType[size_t(preferredElementType)];
+                    if (preferredElementType == ElementType::Undefined || elementByteSize == 0)
+                    {
+                        errorMessage = GetFormatted("Expected a data type before \"file\": \"%.*s\"", int(path.size()), path.data());
+                        return EXIT_FAILURE;
+                    }
+
+                    MappedFile& mappedFile = mappedFiles.emplace_back();
+                    std::pmr::string pathString(path, mappedFiles.get_allocator().resource());
+                    if (mappedFile.Open(pathString.c_str(), /*out*/ errorMessage) != EXIT_SUCCESS)
+                    {
+                        return EXIT_FAILURE;
+                    }
+                    if (mappedFile.size() % elementByteSize != 0)
+                    {
+                        errorMessage = GetFormatted(
+                            "File size %zu is not a multiple of the %s size: \"%.*s\"",
+                            mappedFile.size(),
+                            GetTypeNameFromElementType(preferredElementType).data(),
+                            int(path.size()),
+                            path.data()
+                        );
+                        return EXIT_FAILURE;
+                    }
+                    numbers.AppendExternal(preferredElementType, numericPrintingFlags, mappedFile.data(), mappedFile.size() / elementByteSize, path);
+                }
+                break;
+
             case Hash("raw"):
                 parseAsRawData = true;
                 break;
@@ -1712,83 +3041,97 @@ int ParseOperations(
                 break;
 
             case Hash("undefined"):
-                preferredElementType = ElementType::Undefined;
+                parsedElementType = ElementType::Undefined;
                 break;
 
             case Hash("i8"):
             case Hash("int8"):
-                preferredElementType = ElementType::Int8;
+                parsedElementType = ElementType::Int8;
                 break;
 
             case Hash("ui8"):
             case Hash("uint8"):
-                preferredElementType = ElementType::Uint8;
+                parsedElementType = ElementType::Uint8;
                 break;
 
             case Hash("i16"):
             case Hash("int16"):
-                preferredElementType = ElementType::Int16;
+                parsedElementType = ElementType::Int16;
                 break;
 
             case Hash("ui16"):
             case Hash("uint16"):
-                preferredElementType = ElementType::Uint16;
+                parsedElementType = ElementType::Uint16;
                 break;
 
             case Hash("i32"):
             case Hash("int32"):
             case Hash("int"):
-                preferredElementType = ElementType::Int32;
+                parsedElementType = ElementType::Int32;
                 break;
 
             case Hash("ui32"):
             case Hash("uint32"):
             case Hash("uint"):
-                preferredElementType = ElementType::Uint32;
+                parsedElementType = ElementType::Uint32;
                 break;
 
             case Hash("i64"):
             case Hash("int64"):
-                preferredElementType = ElementType::Int64;
+                parsedElementType = ElementType::Int64;
                 break;
 
             case Hash("ui64"):
             case Hash("uint64"):
-                preferredElementType = ElementType::Uint64;
+                parsedElementType = ElementType::Uint64;
                 break;
 
             case Hash("f16"):
             case Hash("float16"):
-                preferredElementType = ElementType::Float16;
+                parsedElementType = ElementType::Float16;
                 break;
 
             case Hash("f16m7e8s1"):
             case Hash("bfloat16"):
-                preferredElementType = ElementType::Float16m7e8s1;
+                parsedElementType = ElementType::Float16m7e8s1;
+                break;
+
+            case Hash("f8m3e4s1"):
+            case Hash("float8m3e4s1"):
+            case Hash("float8f3e4s1"):
+            case Hash("float8e4m3"):
+                parsedElementType = ElementType::Float8m3e4s1;
+                break;
+
+            case Hash("f8m2e5s1"):
+            case Hash("float8m2e5s1"):
+            case Hash("float8f2e5s1"):
+            case Hash("float8e5m2"):
+                parsedElementType = ElementType::Float8m2e5s1;
                 break;
 
             case Hash("f32"):
             case Hash("float32"):
             case Hash("float"):
-                preferredElementType = ElementType::Float32;
+                parsedElementType = ElementType::Float32;
                 break;
 
             case Hash("f64"):
             case Hash("float64"):
             case Hash("double"):
-                preferredElementType = ElementType::Float64;
+                parsedElementType = ElementType::Float64;
                 break;
 
             case Hash("fixed12_12"):
-                preferredElementType = ElementType::Fixed24f12i12;
+                parsedElementType = ElementType::Fixed24f12i12;
                 break;
 
             case Hash("fixed16_16"):
-                preferredElementType = ElementType::Fixed32f16i16;
+                parsedElementType = ElementType::Fixed32f16i16;
                 break;
 
             case Hash("fixed8_24"):
-                preferredElementType = ElementType::Fixed32f24i8;
+                parsedElementType = ElementType::Fixed32f24i8;
                 break;
 
             case Hash("bin"):
@@ -1863,6 +3206,25 @@ int ParseOperations(
             }
         }
 
+        // A data type either applies to the following numbers or is the accumulator type.
+        if (parsedElementType)
+        {
+            if (isAccumulatorTypeExpected)
+            {
+                numericOperationOptions.accumulatorElementType = *parsedElementType;
+                isAccumulatorTypeExpected = false;
+            }
+            else
+            {
+                preferredElementType = *parsedElementType;
+            }
+        }
+        else if (isAccumulatorTypeExpected && param != "accumulate")
+        {
+            errorMessage = GetFormatted("Expected a data type after \"accumulate\": \"%.*s\"", int(param.size()), param.data());
+            return EXIT_FAILURE;
+        }
+
         // Append any new numeric operations.
         if (numericOperationAndRange.numericOperationType != NumericOperationType::None)
         {
@@ -1871,7 +3233,7 @@ int ParseOperations(
                 errorMessage = GetFormatted("Operations are not supported inside parentheses");
             }
 
-            const uint32_t numberCount = static_cast<uint32_t>(numbers.size());
+            size_t const numberCount = numbers.size();
             if (!operations.empty())
             {
                 operations.back().range.end = numberCount;
@@ -1879,7 +3241,9 @@ int ParseOperations(
             numericOperationAndRange.range.begin = numberCount;
             numericOperationAndRange.range.end = numberCount;
             numericOperationAndRange.outputElementType = preferredElementType;
+            numericOperationAndRange.options = numericOperationOptions;
             operations.push_back(numericOperationAndRange);
+            numbers.BreakRun();
         }
     }
 
@@ -1889,7 +3253,18 @@ int ParseOperations(
         return EXIT_FAILURE;
     }
 
-    const uint32_t numberCount = static_cast<uint32_t>(numbers.size());
+    if (isAccumulatorTypeExpected || isBlockSizeExpected || isSummationModeExpected || isThreadCountExpected)
+    {
+        errorMessage = GetFormatted(
+            isAccumulatorTypeExpected ? "Expected a data type after \"accumulate\"" :
+            isBlockSizeExpected ? "Expected a block size after \"block\"" :
+            isSummationModeExpected ? "Expected a summation mode after \"sum\"" :
+            "Expected a thread count after \"threads\""
+        );
+        return EXIT_FAILURE;
+    }
+
+    size_t const numberCount = numbers.size();
     if (!operations.empty())
     {
         operations.back().range.end = numberCount;
@@ -1913,19 +3288,26 @@ std::string ConcatenateCommandLineParameters(int argc, char* argv[])
     return commandLine;
 }
 
-int MainImplementation(std::string_view commandLine, /*out*/ std::string& stringOutput)
+// Evaluate the command line, drawing every temporary from the context's scratch arena. Reusing the
+// context (and the output string) across calls makes evaluation allocation free once warmed up.
+int MainImplementation(std::string_view commandLine, /*out*/ std::string& stringOutput, EvaluationContext& context)
 {
     if (commandLine.empty())
     {
-        PrintUsage();
+        PrintUsage(/*inout*/ stringOutput);
         return EXIT_SUCCESS;
     }
 
-    std::vector<NumericOperationAndRange> operations;
-    std::vector<NumberUnionAndType> numbers;
+    // Declared first so the arena is rewound only once everything using it is gone.
+    ScratchArenaScope scratchScope(context.GetScratch());
+    std::pmr::memory_resource* scratch = &context.GetScratch();
+
+    std::pmr::vector<NumericOperationAndRange> operations(scratch);
+    std::pmr::vector<MappedFile> mappedFiles(scratch);
+    NumberList numbers(scratch);
 
     std::string errorMessage;
-    int exitCode = ParseOperations(commandLine, /*out*/ operations, /*out*/ numbers, /*out*/ stringOutput);
+    int exitCode = ParseOperations(commandLine, /*out*/ operations, /*out*/ numbers, /*out*/ mappedFiles, /*out*/ stringOutput);
     if (exitCode != EXIT_SUCCESS)
     {
         return exitCode;
@@ -1933,32 +3315,42 @@ int MainImplementation(std::string_view commandLine, /*out*/ std::string& string
 
     if (!operations.empty())
     {
-        // Process every operation in order.
+        // Process every operation in order, reusing the results list.
+        NumberList operationResults(scratch);
         for (auto& operation : operations)
         {
             _Null_terminated_ const char* numericOperationName = GetNumericOperationNameFromNumericOperationType(operation.numericOperationType).data();
 
             // Print the operands.
             AppendFormatted(/*inout*/ stringOutput, "Operands to %s:\n", numericOperationName);
-            Span<const NumberUnionAndType> span(numbers.data() + operation.range.begin, numbers.data() + operation.range.end);
-            SprintAllNumbers(/*inout*/ stringOutput, span);
+            NumberListView operands(numbers, operation.range.begin, operation.range.end);
+            SprintAllNumbers(/*inout*/ stringOutput, operands);
+
+            if (operation.isStreamed)
+            {
+                exitCode = PerformStreamedNumericOperation(operation, operands, context, /*inout*/ stringOutput);
+                if (exitCode != EXIT_SUCCESS)
+                {
+                    return exitCode;
+                }
+                stringOutput.append("\n");
+                continue;
+            }
 
             // Process the values.
-            std::vector<NumberUnionAndType> operationResults(1);
-            operationResults.front().elementType = operation.outputElementType;
-            operationResults.front().printingFlags = span.empty() ? NumericPrintingFlags::Default : span.front().printingFlags;
-            PerformNumericOperation(operation.numericOperationType, span, /*inout*/ operationResults);
+            NumericPrintingFlags const printingFlags = operands.empty() ? NumericPrintingFlags::Default : operands.front().printingFlags;
+            PerformNumericOperation(operation.numericOperationType, operands, operation.options, operation.outputElementType, printingFlags, scratch, /*out*/ operationResults);
 
             // Print the result.
             AppendFormatted(/*inout*/ stringOutput, "Result from %s:\n", numericOperationName);
-            SprintAllNumbers(/*inout*/ stringOutput, MakeSpan(operationResults));
+            SprintAllNumbers(/*inout*/ stringOutput, operationResults);
             stringOutput.append("\n");
         }
     }
     else if (numbers.size() == 1)
     {
         // If exactly one number is given, show it in possible formats.
-        auto& numberUnion = numbers.front();
+        NumberUnionAndType numberUnion = numbers[0];
         double valueFloat = ReadToDouble(numberUnion.elementType, &numberUnion.numberUnion);
         int64_t valueInteger = ReadRawBitValue(numberUnion.elementType, &numberUnion.numberUnion);
 
@@ -1974,8 +3366,368 @@ int MainImplementation(std::string_view commandLine, /*out*/ std::string& string
     else if (!numbers.empty())
     {
         // If multiple numbers are given, print them all.
-        SprintAllNumbers(/*inout*/ stringOutput, Span<const NumberUnionAndType>(numbers.data(), numbers.size()));
+        SprintAllNumbers(/*inout*/ stringOutput, numbers);
     }
 
     return EXIT_SUCCESS;
 }
+
+int MainImplementation(std::string_view commandLine, /*out*/ std::string& stringOutput)
+{
+    EvaluationContext context;
+    return MainImplementation(commandLine, /*out*/ stringOutput, context);
+}
+
+// Parse the command line without evaluating it, counting its operations and operands, such as to
+// check it or to time the parser alone. Any parse error goes to the error message.
+int ParseCommandLine(
+    std::string_view commandLine,
+    EvaluationContext& context,
+    /*out*/ size_t& operationCount,
+    /*out*/ size_t& operandCount,
+    /*out*/ std::string& errorMessage
+)
+{
+    ScratchArenaScope scratchScope(context.GetScratch());
+    std::pmr::memory_resource* scratch = &context.GetScratch();
+
+    std::pmr::vector<NumericOperationAndRange> operations(scratch);
+    std::pmr::vector<MappedFile> mappedFiles(scratch);
+    NumberList numbers(scratch);
+
+    int exitCode = ParseOperations(commandLine, /*out*/ operations, /*out*/ numbers, /*out*/ mappedFiles, /*out*/ errorMessage);
+    operationCount = operations.size();
+    operandCount = numbers.size();
+    return exitCode;
+}
+
+// Evaluate one served line, replacing the output. Exceptions like unsupported types are reported to
+// the client rather than end the server. Each thread serving lines needs its own context.
+int ServeCommandLine(std::string_view line, EvaluationContext& context, /*out*/ std::string& stringOutput)
+{
+    while (!line.empty() && line.back() == '\r')
+    {
+        line.remove_suffix(1);
+    }
+
+    stringOutput.clear();
+    try
+    {
+        return MainImplementation(line, /*out*/ stringOutput, context);
+    }
+    catch (std::exception const& exception)
+    {
+        stringOutput.append(exception.what());
+        return EXIT_FAILURE;
+    }
+}
+
+// Evaluate each line of the input as a command line, until the input ends, writing each response
+// as a header line of the exit code and output byte count, then exactly that many bytes of output.
+// Clients can then read whole responses without scanning them for a terminator. The line, output,
+// and context are reused throughout, so a warmed up server allocates nothing per request. Operands
+// cannot be streamed, as the input carries the requests.
+int ServeCommandLines(FILE* input, FILE* output, EvaluationContext& context)
+{
+    context.inputStream = nullptr;
+    context.outputStream = nullptr;
+
+    std::string line;
+    std::string stringOutput;
+    char readBuffer[4096];
+    while (true)
+    {
+        // Read a whole line, however many reads it spans.
+        line.clear();
+        bool isEndOfInput = true;
+        while (fgets(readBuffer, sizeof(readBuffer), input) != nullptr)
+        {
+            isEndOfInput = false;
+            line.append(readBuffer);
+            if (!line.empty() && line.back() == '\n')
+            {
+                break;
+            }
+        }
+        if (isEndOfInput)
+        {
+            break;
+        }
+        if (!line.empty() && line.back() == '\n')
+        {
+            line.pop_back();
+        }
+
+        int const exitCode = ServeCommandLine(line, context, /*out*/ stringOutput);
+        fprintf(output, "%d %zu\n", exitCode, stringOutput.size());
+        fwrite(stringOutput.data(), 1, stringOutput.size(), output);
+        if (fflush(output) != 0)
+        {
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// C interface, see BiNums.h.
+
+static_assert(uint32_t(BINUMS_ELEMENT_TYPE_UNDEFINED) == uint32_t(ElementType::Undefined));
+static_assert(uint32_t(BINUMS_ELEMENT_TYPE_FLOAT32) == uint32_t(ElementType::Float32));
+static_assert(uint32_t(BINUMS_ELEMENT_TYPE_UINT8) == uint32_t(ElementType::Uint8));
+static_assert(uint32_t(BINUMS_ELEMENT_TYPE_INT8) == uint32_t(ElementType::Int8));
+static_assert(uint32_t(BINUMS_ELEMENT_TYPE_UINT16) == uint32_t(ElementType::Uint16));
+static_assert(uint32_t(BINUMS_ELEMENT_TYPE_INT16) == uint32_t(ElementType::Int16));
+static_assert(uint32_t(BINUMS_ELEMENT_TYPE_INT32) == uint32_t(ElementType::Int32));
+static_assert(uint32_t(BINUMS_ELEMENT_TYPE_INT64) == uint32_t(ElementType::Int64));
+static_assert(uint32_t(BINUMS_ELEMENT_TYPE_BOOL8) == uint32_t(ElementType::Bool8));
+static_assert(uint32_t(BINUMS_ELEMENT_TYPE_FLOAT16) == uint32_t(ElementType::Float16));
+static_assert(uint32_t(BINUMS_ELEMENT_TYPE_FLOAT64) == uint32_t(ElementType::Float64));
+static_assert(uint32_t(BINUMS_ELEMENT_TYPE_UINT32) == uint32_t(ElementType::Uint32));
+static_assert(uint32_t(BINUMS_ELEMENT_TYPE_UINT64) == uint32_t(ElementType::Uint64));
+static_assert(uint32_t(BINUMS_ELEMENT_TYPE_BFLOAT16) == uint32_t(ElementType::Bfloat16));
+static_assert(uint32_t(BINUMS_ELEMENT_TYPE_FIXED12_12) == uint32_t(ElementType::Fixed24f12i12));
+static_assert(uint32_t(BINUMS_ELEMENT_TYPE_FIXED16_16) == uint32_t(ElementType::Fixed32f16i16));
+static_assert(uint32_t(BINUMS_ELEMENT_TYPE_FIXED8_24) == uint32_t(ElementType::Fixed32f24i8));
+static_assert(uint32_t(BINUMS_ELEMENT_TYPE_FLOAT8E4M3) == uint32_t(ElementType::Float8m3e4s1));
+static_assert(uint32_t(BINUMS_ELEMENT_TYPE_FLOAT8E5M2) == uint32_t(ElementType::Float8m2e5s1));
+static_assert(uint32_t(BINUMS_OPERATION_ADD) == uint32_t(NumericOperationType::Add));
+static_assert(uint32_t(BINUMS_OPERATION_SUBTRACT) == uint32_t(NumericOperationType::Subtract));
+static_assert(uint32_t(BINUMS_OPERATION_MULTIPLY) == uint32_t(NumericOperationType::Multiply));
+static_assert(uint32_t(BINUMS_OPERATION_DIVIDE) == uint32_t(NumericOperationType::Divide));
+static_assert(uint32_t(BINUMS_OPERATION_DOT) == uint32_t(NumericOperationType::Dot));
+static_assert(uint32_t(BINUMS_SUMMATION_MODE_SEQUENTIAL) == uint32_t(SummationMode::Sequential));
+static_assert(uint32_t(BINUMS_SUMMATION_MODE_PAIRWISE) == uint32_t(SummationMode::Pairwise));
+static_assert(uint32_t(BINUMS_SUMMATION_MODE_KAHAN) == uint32_t(SummationMode::Kahan));
+static_assert(uint32_t(BINUMS_SUMMATION_MODE_NEUMAIER) == uint32_t(SummationMode::Neumaier));
+
+struct BINUMS_CONTEXT
+{
+    BINUMS_CONTEXT()
+    {
+        // The host's stdin is not the library's to read.
+        evaluationContext.inputStream = nullptr;
+    }
+
+    EvaluationContext evaluationContext;
+    std::string output;
+};
+
+// Exceptions cannot cross into C. The arguments are checked beforehand, so invalid arguments
+// thrown from within are unsupported types.
+template <typename Function>
+static BINUMS_STATUS CallReturningStatus(Function&& function) noexcept
+{
+    try
+    {
+        return function();
+    }
+    catch (std::bad_alloc const&)
+    {
+        return BINUMS_STATUS_OUT_OF_MEMORY;
+    }
+    catch (std::invalid_argument const&)
+    {
+        return BINUMS_STATUS_UNSUPPORTED;
+    }
+    catch (...)
+    {
+        return BINUMS_STATUS_FAILURE;
+    }
+}
+
+// Call the function with the given context, or a temporary one if null.
+template <typename Function>
+static BINUMS_STATUS CallWithContext(BINUMS_CONTEXT* context, Function&& function) noexcept
+{
+    return CallReturningStatus(
+        [&]() -> BINUMS_STATUS
+        {
+            if (context != nullptr)
+            {
+                return function(*context);
+            }
+            BINUMS_CONTEXT temporaryContext;
+            return function(temporaryContext);
+        }
+    );
+}
+
+// Only the types in BINUMS_ELEMENT_TYPE, not the internal ones between them (StringChar8 and the
+// complex types).
+static bool IsDefinedElementType(BINUMS_ELEMENT_TYPE elementType) noexcept
+{
+    switch (elementType)
+    {
+    case BINUMS_ELEMENT_TYPE_FLOAT32:
+    case BINUMS_ELEMENT_TYPE_UINT8:
+    case BINUMS_ELEMENT_TYPE_INT8:
+    case BINUMS_ELEMENT_TYPE_UINT16:
+    case BINUMS_ELEMENT_TYPE_INT16:
+    case BINUMS_ELEMENT_TYPE_INT32:
+    case BINUMS_ELEMENT_TYPE_INT64:
+    case BINUMS_ELEMENT_TYPE_BOOL8:
+    case BINUMS_ELEMENT_TYPE_FLOAT16:
+    case BINUMS_ELEMENT_TYPE_FLOAT64:
+    case BINUMS_ELEMENT_TYPE_UINT32:
+    case BINUMS_ELEMENT_TYPE_UINT64:
+    case BINUMS_ELEMENT_TYPE_BFLOAT16:
+    case BINUMS_ELEMENT_TYPE_FIXED12_12:
+    case BINUMS_ELEMENT_TYPE_FIXED16_16:
+    case BINUMS_ELEMENT_TYPE_FIXED8_24:
+    case BINUMS_ELEMENT_TYPE_FLOAT8E4M3:
+    case BINUMS_ELEMENT_TYPE_FLOAT8E5M2:
+        return true;
+    default:
+        return false;
+    }
+}
+
+extern "C" BINUMS_STATUS BiNumsCreateContext(BINUMS_CONTEXT** context)
+{
+    if (context == nullptr)
+    {
+        return BINUMS_STATUS_INVALID_ARGUMENT;
+    }
+    *context = nullptr;
+    return CallReturningStatus(
+        [&]() -> BINUMS_STATUS
+        {
+            *context = new BINUMS_CONTEXT;
+            return BINUMS_STATUS_SUCCESS;
+        }
+    );
+}
+
+extern "C" void BiNumsDestroyContext(BINUMS_CONTEXT* context)
+{
+    delete context;
+}
+
+extern "C" BINUMS_STATUS BiNumsEvaluate(
+    BINUMS_CONTEXT* context,
+    char const* commandLine,
+    size_t commandLineByteSize,
+    char* output,
+    size_t outputByteCapacity,
+    size_t* outputByteSize
+)
+{
+    if ((commandLine == nullptr && commandLineByteSize > 0)
+    ||  (output == nullptr && outputByteCapacity > 0)
+    ||  outputByteSize == nullptr)
+    {
+        return BINUMS_STATUS_INVALID_ARGUMENT;
+    }
+
+    return CallWithContext(
+        context,
+        [&](BINUMS_CONTEXT& callContext) -> BINUMS_STATUS
+        {
+            std::string_view const commandLineView(commandLine, commandLineByteSize);
+            int const exitCode = ServeCommandLine(commandLineView, callContext.evaluationContext, /*out*/ callContext.output);
+            *outputByteSize = callContext.output.size();
+            if (callContext.output.size() > outputByteCapacity)
+            {
+                return BINUMS_STATUS_BUFFER_TOO_SMALL;
+            }
+            std::copy(callContext.output.begin(), callContext.output.end(), output);
+            return (exitCode == EXIT_SUCCESS) ? BINUMS_STATUS_SUCCESS : BINUMS_STATUS_FAILURE;
+        }
+    );
+}
+
+extern "C" BINUMS_STATUS BiNumsConvert(
+    BINUMS_ELEMENT_TYPE sourceType,
+    BINUMS_ELEMENT_TYPE destinationType,
+    void const* source,
+    void* destination,
+    size_t count
+)
+{
+    if (!IsDefinedElementType(sourceType)
+    ||  !IsDefinedElementType(destinationType)
+    ||  ((source == nullptr || destination == nullptr) && count > 0))
+    {
+        return BINUMS_STATUS_INVALID_ARGUMENT;
+    }
+
+    return CallReturningStatus(
+        [&]() -> BINUMS_STATUS
+        {
+            CastElementTypeArray(ElementType(sourceType), ElementType(destinationType), source, /*out*/ destination, count);
+            return BINUMS_STATUS_SUCCESS;
+        }
+    );
+}
+
+extern "C" BINUMS_STATUS BiNumsReduce(
+    BINUMS_CONTEXT* context,
+    BINUMS_OPERATION operation,
+    BINUMS_ELEMENT_TYPE type,
+    void const* source,
+    size_t count,
+    BINUMS_REDUCE_OPTIONS const* options,
+    void* result
+)
+{
+    // Callers built against an earlier header pass a smaller struct, whose missing fields default
+    // to zero like the rest of a zero initialized struct.
+    BINUMS_REDUCE_OPTIONS reduceOptions = BINUMS_REDUCE_OPTIONS_DEFAULT;
+    if (options != nullptr)
+    {
+        if (options->structByteSize < sizeof(options->structByteSize))
+        {
+            return BINUMS_STATUS_INVALID_ARGUMENT;
+        }
+        std::memcpy(&reduceOptions, options, std::min(size_t(options->structByteSize), sizeof(reduceOptions)));
+    }
+
+    NumericOperationType const numericOperationType = NumericOperationType(operation);
+    if ((numericOperationType != NumericOperationType::Add
+    &&   numericOperationType != NumericOperationType::Subtract
+    &&   numericOperationType != NumericOperationType::Multiply
+    &&   numericOperationType != NumericOperationType::Divide
+    &&   numericOperationType != NumericOperationType::Dot)
+    ||  !IsDefinedElementType(type)
+    ||  (source == nullptr && count > 0)
+    ||  result == nullptr
+    ||  (reduceOptions.accumulatorType != BINUMS_ELEMENT_TYPE_UNDEFINED && !IsDefinedElementType(reduceOptions.accumulatorType))
+    ||  uint32_t(reduceOptions.summationMode) > uint32_t(BINUMS_SUMMATION_MODE_NEUMAIER))
+    {
+        return BINUMS_STATUS_INVALID_ARGUMENT;
+    }
+    if (g_numericOperationFunctions[size_t(type)] == nullptr)
+    {
+        return BINUMS_STATUS_UNSUPPORTED;
+    }
+
+    NumericOperationOptions numericOperationOptions;
+    numericOperationOptions.accumulatorElementType = ElementType(reduceOptions.accumulatorType);
+    numericOperationOptions.accumulationBlockSize = reduceOptions.accumulationBlockSize;
+    numericOperationOptions.summationMode = SummationMode(reduceOptions.summationMode);
+    numericOperationOptions.threadCount = reduceOptions.threadCount;
+
+    return CallWithContext(
+        context,
+        [&](BINUMS_CONTEXT& callContext) -> BINUMS_STATUS
+        {
+            // The operands are read where they are, needing no cast as they are already the type.
+            ScratchArena& scratch = callContext.evaluationContext.GetScratch();
+            ScratchArenaScope scratchScope(scratch);
+            NumberList operands(&scratch);
+            NumberList results(&scratch);
+            operands.AppendExternal(ElementType(type), NumericPrintingFlags::Default, source, count, {});
+            PerformNumericOperation(numericOperationType, NumberListView(operands), numericOperationOptions, ElementType(type), NumericPrintingFlags::Default, &scratch, /*out*/ results);
+            if (results.size() != 1)
+            {
+                return BINUMS_STATUS_FAILURE;
+            }
+
+            NumberUnionAndType const reduced = results[0];
+            std::memcpy(result, &reduced.numberUnion, g_byteSizeOfElementType[size_t(type)]);
+            return BINUMS_STATUS_SUCCESS;
+        }
+    );
+}
@@ -0,0 +1,127 @@
+//-----------------------------------------------------------------------------
+//
+//  C interface to the binums_core library, for calling it in process rather
+//  than running the executable.
+//
+//  The enum values are fixed, so callers built against one version keep
+//  working with later ones. Nothing here throws. Functions taking a context
+//  accept null for a temporary one, but reusing a context (one per thread)
+//  avoids allocating on every call once it has warmed up.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum BINUMS_STATUS
+{
+    BINUMS_STATUS_SUCCESS = 0,
+    BINUMS_STATUS_FAILURE = 1,              // The command line failed, and the output says why.
+    BINUMS_STATUS_BUFFER_TOO_SMALL = 2,     // Nothing was written, and the size needed was returned.
+    BINUMS_STATUS_INVALID_ARGUMENT = 3,
+    BINUMS_STATUS_UNSUPPORTED = 4,          // Like an operation on a type without numeric operations.
+    BINUMS_STATUS_OUT_OF_MEMORY = 5,
+} BINUMS_STATUS;
+
+typedef enum BINUMS_ELEMENT_TYPE
+{
+    BINUMS_ELEMENT_TYPE_UNDEFINED = 0,
+    BINUMS_ELEMENT_TYPE_FLOAT32 = 1,
+    BINUMS_ELEMENT_TYPE_UINT8 = 2,
+    BINUMS_ELEMENT_TYPE_INT8 = 3,
+    BINUMS_ELEMENT_TYPE_UINT16 = 4,
+    BINUMS_ELEMENT_TYPE_INT16 = 5,
+    BINUMS_ELEMENT_TYPE_INT32 = 6,
+    BINUMS_ELEMENT_TYPE_INT64 = 7,
+    BINUMS_ELEMENT_TYPE_BOOL8 = 9,
+    BINUMS_ELEMENT_TYPE_FLOAT16 = 10,
+    BINUMS_ELEMENT_TYPE_FLOAT64 = 11,
+    BINUMS_ELEMENT_TYPE_UINT32 = 12,
+    BINUMS_ELEMENT_TYPE_UINT64 = 13,
+    BINUMS_ELEMENT_TYPE_BFLOAT16 = 16,
+    BINUMS_ELEMENT_TYPE_FIXED12_12 = 17,
+    BINUMS_ELEMENT_TYPE_FIXED16_16 = 18,
+    BINUMS_ELEMENT_TYPE_FIXED8_24 = 19,
+    BINUMS_ELEMENT_TYPE_FLOAT8E4M3 = 20,
+    BINUMS_ELEMENT_TYPE_FLOAT8E5M2 = 21,
+} BINUMS_ELEMENT_TYPE;
+
+typedef enum BINUMS_OPERATION
+{
+    BINUMS_OPERATION_ADD = 3,
+    BINUMS_OPERATION_SUBTRACT = 4,
+    BINUMS_OPERATION_MULTIPLY = 5,
+    BINUMS_OPERATION_DIVIDE = 6,
+    BINUMS_OPERATION_DOT = 7,               // Of interleaved pairs: a0 b0 a1 b1...
+} BINUMS_OPERATION;
+
+typedef enum BINUMS_SUMMATION_MODE
+{
+    BINUMS_SUMMATION_MODE_SEQUENTIAL = 0,
+    BINUMS_SUMMATION_MODE_PAIRWISE = 1,
+    BINUMS_SUMMATION_MODE_KAHAN = 2,
+    BINUMS_SUMMATION_MODE_NEUMAIER = 3,
+} BINUMS_SUMMATION_MODE;
+
+// The same as the command line's accumulate, block, sum, and threads options. Zero initialized
+// options (besides the byte size) are the defaults, as in BINUMS_REDUCE_OPTIONS_DEFAULT.
+typedef struct BINUMS_REDUCE_OPTIONS
+{
+    uint32_t structByteSize;                // sizeof(BINUMS_REDUCE_OPTIONS). Fields past a smaller size get their defaults.
+    BINUMS_ELEMENT_TYPE accumulatorType;    // UNDEFINED accumulates in the data type.
+    uint32_t accumulationBlockSize;         // 0 rounds to the data type only at the end.
+    BINUMS_SUMMATION_MODE summationMode;
+    uint32_t threadCount;                   // 0 uses every hardware thread.
+} BINUMS_REDUCE_OPTIONS;
+
+#define BINUMS_REDUCE_OPTIONS_DEFAULT {sizeof(BINUMS_REDUCE_OPTIONS), BINUMS_ELEMENT_TYPE_UNDEFINED, 0, BINUMS_SUMMATION_MODE_SEQUENTIAL, 0}
+
+// Memory reused across calls. Not thread-safe, so each thread calling at once needs its own.
+typedef struct BINUMS_CONTEXT BINUMS_CONTEXT;
+
+BINUMS_STATUS BiNumsCreateContext(BINUMS_CONTEXT** context);
+void BiNumsDestroyContext(BINUMS_CONTEXT* context);
+
+// Evaluate a command line (without the leading "binums"), writing the same text output as the
+// executable, not null terminated. The output byte size is always returned, so if the buffer was
+// too small, the caller can retry with one large enough. Operands cannot be streamed from stdin.
+BINUMS_STATUS BiNumsEvaluate(
+    BINUMS_CONTEXT* context,
+    char const* commandLine,
+    size_t commandLineByteSize,
+    char* output,
+    size_t outputByteCapacity,
+    size_t* outputByteSize
+);
+
+// Convert count elements from one type to another, the same as the command line casts them. The
+// arrays must not overlap.
+BINUMS_STATUS BiNumsConvert(
+    BINUMS_ELEMENT_TYPE sourceType,
+    BINUMS_ELEMENT_TYPE destinationType,
+    void const* source,
+    void* destination,
+    size_t count
+);
+
+// Reduce count elements of the type to one of the same type, read in place. Options may be null
+// for the defaults.
+BINUMS_STATUS BiNumsReduce(
+    BINUMS_CONTEXT* context,
+    BINUMS_OPERATION operation,
+    BINUMS_ELEMENT_TYPE type,
+    void const* source,
+    size_t count,
+    BINUMS_REDUCE_OPTIONS const* options,
+    void* result
+);
+
+#ifdef __cplusplus
+}
+#endif
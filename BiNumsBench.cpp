@@ -0,0 +1,1001 @@
+﻿// BiNums, see binary numbers - microbenchmarks
+//
+// Times the parsing, casting, reducing, and formatting functions, and whole command lines, for
+// working sets sized to each cache level and beyond to DRAM. Results print as a table, can be saved
+// as JSON, and compared against JSON saved before, to tell whether a change helped.
+
+#include "precomp.h"
+#include <chrono>
+#include <map>
+#include <random>
+#include <string>
+#if _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#else
+#include <unistd.h>
+#endif
+
+extern void AppendFormatted(std::string& s, char const* formatString, ...);
+extern int MainImplementation(std::string_view commandLine, std::string& stringOutput, EvaluationContext& context);
+extern int ParseCommandLine(std::string_view commandLine, EvaluationContext& context, size_t& operationCount, size_t& operandCount, std::string& errorMessage);
+extern void ParseNumber(char const* valueString, ElementType preferredElementType, bool parseAsRawData, NumberUnionAndType& number);
+extern std::string_view GetIdentifier(std::string_view s);
+extern void CastElementType(ElementType inputDataType, ElementType outputDataType, void const* inputData, void* outputData);
+extern void CastElementTypeArray(ElementType inputDataType, ElementType outputDataType, void const* inputData, void* outputData, size_t count);
+extern void AppendFormattedRawInteger(std::string& stringValue, uint32_t radix, Range bitRange, uint64_t value);
+extern void AppendFormattedNumericValue(std::string& output, ElementType elementType, double floatValue, int64_t integerValue, NumericPrintingFlags printingFlags);
+extern std::string_view GetTypeNameFromElementType(ElementType dataType) noexcept;
+extern uint32_t GetSizeOfTypeInBits(ElementType dataType) noexcept;
+
+////////////////////////////////////////////////////////////////////////////////
+// Generic functions/classes.
+
+bool StringsMatch(char const* a, char const* b)
+{
+    return strcmp(a, b) == 0;
+}
+
+// Results are folded into this, so the compiler cannot drop the work producing them.
+std::atomic<uint64_t> g_sink = 0;
+
+void Consume(uint64_t value)
+{
+    g_sink.fetch_xor(value, std::memory_order_relaxed);
+}
+
+struct BenchmarkOptions
+{
+    char const* filter = nullptr; // Only run benchmarks whose names contain this.
+    char const* jsonPath = nullptr;
+    char const* baselinePath = nullptr;
+    double regressionThreshold = 0.10; // Slowdown beyond which a baseline comparison fails.
+    bool isQuick = false; // Only the L1 and L2 working sets, timed briefly, for a quick check.
+};
+
+BenchmarkOptions g_options;
+
+int ParseCommandLineParameters(int argc, char* argv[])
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        char const* argument = argv[i];
+        char const* nextArgument = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (StringsMatch(argument, "/?") || StringsMatch(argument, "-h") || StringsMatch(argument, "-help"))
+        {
+            printf(
+                "Run without any arguments to time every benchmark.\n"
+                "Times are the best of several passes, in ns per element and GB/s read plus written.\n"
+                "\n"
+                "filter <text> : only run benchmarks whose names contain the text, like \"cast float32\"\n"
+                "json <path> : save the results as JSON\n"
+                "baseline <path> : compare against results saved before, failing if any are slower\n"
+                "threshold <percent> : how much slower than the baseline counts as a regression (default 10)\n"
+                "quick : only the L1 and L2 sized working sets, timed briefly\n"
+            );
+            return EXIT_FAILURE;
+        }
+        else if (StringsMatch(argument, "quick"))
+        {
+            g_options.isQuick = true;
+        }
+        else if (nextArgument != nullptr && StringsMatch(argument, "filter"))
+        {
+            g_options.filter = nextArgument;
+            ++i;
+        }
+        else if (nextArgument != nullptr && StringsMatch(argument, "json"))
+        {
+            g_options.jsonPath = nextArgument;
+            ++i;
+        }
+        else if (nextArgument != nullptr && StringsMatch(argument, "baseline"))
+        {
+            g_options.baselinePath = nextArgument;
+            ++i;
+        }
+        else if (nextArgument != nullptr && StringsMatch(argument, "threshold"))
+        {
+            g_options.regressionThreshold = atof(nextArgument) / 100;
+            ++i;
+        }
+        else
+        {
+            printf(
+                "Unrecognized parameter: %s\n"
+                "Type -help for help.",
+                argument
+            );
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Working sets and timing.
+
+struct CacheSizes
+{
+    size_t level1 = 0;
+    size_t level2 = 0;
+    size_t level3 = 0;
+};
+
+// Read the data cache sizes, falling back to typical ones where the system does not say.
+CacheSizes DetectCacheSizes()
+{
+    CacheSizes cacheSizes;
+
+#if _WIN32
+    DWORD byteSize = 0;
+    GetLogicalProcessorInformation(nullptr, &byteSize);
+    std::vector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> processorInformation(byteSize / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+    if (!processorInformation.empty() && GetLogicalProcessorInformation(processorInformation.data(), &byteSize))
+    {
+        for (auto const& information : processorInformation)
+        {
+            if (information.Relationship != RelationCache || information.Cache.Type == CacheInstruction)
+            {
+                continue;
+            }
+
+            size_t* cacheSize = (information.Cache.Level == 1) ? &cacheSizes.level1
+                              : (information.Cache.Level == 2) ? &cacheSizes.level2
+                              : (information.Cache.Level == 3) ? &cacheSizes.level3
+                              : nullptr;
+            if (cacheSize != nullptr)
+            {
+                *cacheSize = std::max(*cacheSize, size_t(information.Cache.Size));
+            }
+        }
+    }
+#elif defined(_SC_LEVEL1_DCACHE_SIZE)
+    cacheSizes.level1 = size_t(std::max(sysconf(_SC_LEVEL1_DCACHE_SIZE), 0L));
+    cacheSizes.level2 = size_t(std::max(sysconf(_SC_LEVEL2_CACHE_SIZE), 0L));
+    cacheSizes.level3 = size_t(std::max(sysconf(_SC_LEVEL3_CACHE_SIZE), 0L));
+#endif
+
+    if (cacheSizes.level1 == 0)
+    {
+        cacheSizes.level1 = size_t(32) << 10;
+    }
+    if (cacheSizes.level2 == 0)
+    {
+        cacheSizes.level2 = std::max(cacheSizes.level1 * 8, size_t(1) << 20);
+    }
+    if (cacheSizes.level3 == 0)
+    {
+        cacheSizes.level3 = std::max(cacheSizes.level2 * 8, size_t(32) << 20);
+    }
+
+    return cacheSizes;
+}
+
+struct WorkingSet
+{
+    char const* name;
+    uint32_t cacheLevel; // 4 for DRAM.
+    size_t byteSize; // Read plus written per pass.
+};
+
+// Each cache level gets a working set of half its size, leaving room for everything else resident,
+// and DRAM gets one a few times the last level's, bounded to keep a whole run within minutes.
+std::vector<WorkingSet> GetWorkingSets(CacheSizes const& cacheSizes, bool isQuick)
+{
+    std::vector<WorkingSet> workingSets =
+    {
+        {"L1", 1, cacheSizes.level1 / 2},
+        {"L2", 2, cacheSizes.level2 / 2},
+    };
+    if (!isQuick)
+    {
+        workingSets.push_back({"L3", 3, cacheSizes.level3 / 2});
+        workingSets.push_back({"DRAM", 4, std::clamp(cacheSizes.level3 * 4, size_t(64) << 20, size_t(512) << 20)});
+    }
+    return workingSets;
+}
+
+// One timed pass over data prepared for a working set.
+struct BenchmarkPass
+{
+    std::function<void()> run; // Empty to skip the working set.
+    size_t elementCount = 0;
+    size_t byteCount = 0; // Read plus written, for the throughput.
+};
+
+using PrepareBenchmarkPass = std::function<BenchmarkPass(WorkingSet const& workingSet)>;
+
+struct BenchmarkResult
+{
+    std::string name;
+    std::string workingSetName;
+    size_t workingSetByteSize;
+    size_t elementCount;
+    double nanosecondsPerElement;
+    double gigabytesPerSecond;
+};
+
+class BenchmarkRunner
+{
+public:
+    BenchmarkRunner(BenchmarkOptions const& options, std::vector<WorkingSet> workingSets)
+    :   options_(options),
+        workingSets_(std::move(workingSets))
+    {
+    }
+
+    void PrintHeader() const
+    {
+        printf("%-40s", "");
+        for (WorkingSet const& workingSet : workingSets_)
+        {
+            char label[32];
+            snprintf(label, sizeof(label), "%s %zu KiB", workingSet.name, workingSet.byteSize >> 10);
+            printf("  %18s", label);
+        }
+        printf("\n%-40s", "");
+        for (size_t i = 0; i < workingSets_.size(); ++i)
+        {
+            printf("  %10s %7s", "ns/elem", "GB/s");
+        }
+        printf("\n");
+    }
+
+    // Prepare and time the benchmark for each working set, printing a row of the table.
+    void Run(std::string const& name, PrepareBenchmarkPass const& prepare)
+    {
+        if (options_.filter != nullptr && name.find(options_.filter) == name.npos)
+        {
+            return;
+        }
+
+        printf("%-40s", name.c_str());
+        fflush(stdout);
+        for (WorkingSet const& workingSet : workingSets_)
+        {
+            BenchmarkPass pass = prepare(workingSet);
+            if (!pass.run || pass.elementCount == 0)
+            {
+                printf("  %10s %7s", "-", "-");
+                continue;
+            }
+
+            // Repeat until enough time passes for a stable measurement, keeping the best pass.
+            // The first pass only warms up the caches and branch predictors.
+            auto const minimumDuration = std::chrono::milliseconds(options_.isQuick ? 5 : 50);
+            size_t const minimumPassCount = options_.isQuick ? 2 : 3;
+            pass.run();
+            double bestSeconds = 1e9;
+            size_t passCount = 0;
+            auto const startTime = std::chrono::steady_clock::now();
+            while (passCount < minimumPassCount || std::chrono::steady_clock::now() - startTime < minimumDuration)
+            {
+                auto const passStartTime = std::chrono::steady_clock::now();
+                pass.run();
+                std::chrono::duration<double> const passDuration = std::chrono::steady_clock::now() - passStartTime;
+                bestSeconds = std::min(bestSeconds, passDuration.count());
+                ++passCount;
+            }
+
+            bestSeconds = std::max(bestSeconds, 1e-9);
+            BenchmarkResult result =
+            {
+                .name = name,
+                .workingSetName = workingSet.name,
+                .workingSetByteSize = workingSet.byteSize,
+                .elementCount = pass.elementCount,
+                .nanosecondsPerElement = bestSeconds * 1e9 / double(pass.elementCount),
+                .gigabytesPerSecond = double(pass.byteCount) / bestSeconds * 1e-9,
+            };
+            printf("  %10.3f %7.2f", result.nanosecondsPerElement, result.gigabytesPerSecond);
+            fflush(stdout);
+            results_.push_back(std::move(result));
+        }
+        printf("\n");
+    }
+
+    std::vector<BenchmarkResult> const& GetResults() const noexcept { return results_; }
+
+private:
+    BenchmarkOptions const& options_;
+    std::vector<WorkingSet> workingSets_;
+    std::vector<BenchmarkResult> results_;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Benchmark data.
+
+// The element types with a fixed size, which casting and reducing support.
+constexpr ElementType g_numericElementTypes[] =
+{
+    ElementType::Uint8,
+    ElementType::Int8,
+    ElementType::Uint16,
+    ElementType::Int16,
+    ElementType::Uint32,
+    ElementType::Int32,
+    ElementType::Uint64,
+    ElementType::Int64,
+    ElementType::Float8m3e4s1,
+    ElementType::Float8m2e5s1,
+    ElementType::Float16,
+    ElementType::Bfloat16,
+    ElementType::Float32,
+    ElementType::Float64,
+    ElementType::Fixed24f12i12,
+    ElementType::Fixed32f16i16,
+    ElementType::Fixed32f24i8,
+};
+
+size_t GetByteSize(ElementType elementType)
+{
+    return GetSizeOfTypeInBits(elementType) / 8;
+}
+
+std::string GetTypeName(ElementType elementType)
+{
+    return std::string(GetTypeNameFromElementType(elementType));
+}
+
+// Generate values of the type, cast from normally distributed ones (mostly small, like typical
+// data), or all 1's so long products and quotients neither overflow nor divide by zero. Only the
+// first 64Ki are random, repeated from there, which is too long a pattern for branch predictors
+// and keeps preparing DRAM sized working sets quick.
+std::vector<uint8_t> GenerateElements(ElementType elementType, size_t count, bool isUnitMagnitude = false)
+{
+    std::mt19937 randomGenerator(42);
+    std::normal_distribution<double> normalDistribution(0.0, 8.0);
+    std::vector<double> values(std::min(count, size_t(65536)));
+    for (double& value : values)
+    {
+        value = isUnitMagnitude ? 1.0 : normalDistribution(randomGenerator);
+    }
+
+    size_t const elementByteSize = GetByteSize(elementType);
+    std::vector<uint8_t> elements(count * elementByteSize);
+    CastElementTypeArray(ElementType::Float64, elementType, values.data(), elements.data(), values.size());
+    for (size_t i = values.size() * elementByteSize; i < elements.size(); i += values.size() * elementByteSize)
+    {
+        memcpy(&elements[i], elements.data(), std::min(values.size() * elementByteSize, elements.size() - i));
+    }
+    return elements;
+}
+
+// Space separated numbers, typical of command lines, as decimals for fractional types.
+std::string GenerateNumberText(size_t byteSize, bool isFractional, char separator)
+{
+    std::mt19937 randomGenerator(42);
+    std::normal_distribution<double> normalDistribution(0.0, 100.0);
+    std::string text;
+    text.reserve(byteSize + 32);
+    while (text.size() < byteSize)
+    {
+        double const value = normalDistribution(randomGenerator);
+        if (isFractional)
+        {
+            AppendFormatted(text, "%.6g", value);
+        }
+        else
+        {
+            AppendFormatted(text, "%d", int(value));
+        }
+        text.push_back(separator);
+    }
+    text.pop_back();
+    return text;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Benchmarks.
+
+void RunParsingBenchmarks(BenchmarkRunner& runner)
+{
+    constexpr ElementType parsedElementTypes[] =
+    {
+        ElementType::Undefined,
+        ElementType::Int32,
+        ElementType::Float32,
+        ElementType::Float64,
+        ElementType::Float16,
+        ElementType::Float8m3e4s1,
+    };
+
+    for (ElementType elementType : parsedElementTypes)
+    {
+        bool const isInteger = (elementType == ElementType::Int32);
+        runner.Run("parse number " + GetTypeName(elementType), [=](WorkingSet const& workingSet) -> BenchmarkPass
+        {
+            // Null separated, since each number is parsed as a null terminated string.
+            std::string text = GenerateNumberText(workingSet.byteSize, !isInteger, '\0');
+            size_t const elementCount = std::count(text.begin(), text.end(), '\0') + 1;
+            return
+            {
+                .run = [=]()
+                {
+                    NumberUnionAndType number;
+                    uint64_t checksum = 0;
+                    for (char const* p = text.data(), *end = text.data() + text.size(); p < end; p += strlen(p) + 1)
+                    {
+                        ParseNumber(p, elementType, /*parseAsRawData*/ false, /*out*/ number);
+                        checksum += number.numberUnion.ui64;
+                    }
+                    Consume(checksum);
+                },
+                .elementCount = elementCount,
+                .byteCount = text.size(),
+            };
+        });
+    }
+
+    runner.Run("get identifier", [](WorkingSet const& workingSet) -> BenchmarkPass
+    {
+        std::string text = "float32 add ";
+        text += GenerateNumberText(workingSet.byteSize, /*isFractional*/ true, ' ');
+        size_t const elementCount = std::count(text.begin(), text.end(), ' ') + 1;
+        return
+        {
+            .run = [=]()
+            {
+                std::string_view remainder = text;
+                uint64_t checksum = 0;
+                while (!remainder.empty())
+                {
+                    std::string_view const identifier = GetIdentifier(remainder);
+                    if (identifier.empty())
+                    {
+                        break;
+                    }
+                    checksum += identifier.size();
+                    remainder.remove_prefix(identifier.data() + identifier.size() - remainder.data());
+                }
+                Consume(checksum);
+            },
+            .elementCount = elementCount,
+            .byteCount = text.size(),
+        };
+    });
+
+    for (bool isFractional : {false, true})
+    {
+        std::string const dataTypeName = isFractional ? "float32" : "int32";
+        runner.Run("parse command line " + dataTypeName, [=](WorkingSet const& workingSet) -> BenchmarkPass
+        {
+            // The parsed operands take about as much memory as their text, so split the working set.
+            std::string commandLine = dataTypeName + " add ";
+            commandLine += GenerateNumberText(workingSet.byteSize / 2, isFractional, ' ');
+            auto context = std::make_shared<EvaluationContext>();
+            size_t operationCount = 0, operandCount = 0;
+            std::string errorMessage;
+            if (ParseCommandLine(commandLine, *context, /*out*/ operationCount, /*out*/ operandCount, /*out*/ errorMessage) != EXIT_SUCCESS)
+            {
+                printf("\n%s\n", errorMessage.c_str());
+                return {};
+            }
+            return
+            {
+                .run = [=]()
+                {
+                    size_t runOperationCount = 0, runOperandCount = 0;
+                    std::string runErrorMessage;
+                    ParseCommandLine(commandLine, *context, /*out*/ runOperationCount, /*out*/ runOperandCount, /*out*/ runErrorMessage);
+                    Consume(runOperandCount);
+                },
+                .elementCount = operandCount,
+                .byteCount = commandLine.size(),
+            };
+        });
+    }
+}
+
+void RunCastingBenchmarks(BenchmarkRunner& runner)
+{
+    for (ElementType inputElementType : g_numericElementTypes)
+    {
+        for (ElementType outputElementType : g_numericElementTypes)
+        {
+            size_t const elementByteSize = GetByteSize(inputElementType) + GetByteSize(outputElementType);
+            std::string const typeNames = GetTypeName(inputElementType) + " " + GetTypeName(outputElementType);
+
+            runner.Run("cast " + typeNames, [=](WorkingSet const& workingSet) -> BenchmarkPass
+            {
+                size_t const elementCount = workingSet.byteSize / elementByteSize;
+                std::vector<uint8_t> input = GenerateElements(inputElementType, elementCount);
+                std::vector<uint8_t> output(elementCount * GetByteSize(outputElementType));
+                return
+                {
+                    .run = [=]() mutable
+                    {
+                        CastElementTypeArray(inputElementType, outputElementType, input.data(), output.data(), elementCount);
+                        Consume(output.back());
+                    },
+                    .elementCount = elementCount,
+                    .byteCount = elementCount * elementByteSize,
+                };
+            });
+        }
+    }
+
+    // Casting one element at a time is bound by the dispatch, not memory, so it is only timed in L1.
+    for (ElementType inputElementType : g_numericElementTypes)
+    {
+        for (ElementType outputElementType : g_numericElementTypes)
+        {
+            size_t const elementByteSize = GetByteSize(inputElementType) + GetByteSize(outputElementType);
+            std::string const typeNames = GetTypeName(inputElementType) + " " + GetTypeName(outputElementType);
+
+            runner.Run("cast scalar " + typeNames, [=](WorkingSet const& workingSet) -> BenchmarkPass
+            {
+                if (workingSet.cacheLevel != 1)
+                {
+                    return {};
+                }
+
+                size_t const elementCount = workingSet.byteSize / elementByteSize;
+                std::vector<uint8_t> input = GenerateElements(inputElementType, elementCount);
+                std::vector<uint8_t> output(elementCount * GetByteSize(outputElementType));
+                return
+                {
+                    .run = [=]() mutable
+                    {
+                        size_t const inputByteSize = GetByteSize(inputElementType);
+                        size_t const outputByteSize = GetByteSize(outputElementType);
+                        for (size_t i = 0; i < elementCount; ++i)
+                        {
+                            CastElementType(inputElementType, outputElementType, &input[i * inputByteSize], &output[i * outputByteSize]);
+                        }
+                        Consume(output.back());
+                    },
+                    .elementCount = elementCount,
+                    .byteCount = elementCount * elementByteSize,
+                };
+            });
+        }
+    }
+}
+
+void RunReductionBenchmarks(BenchmarkRunner& runner)
+{
+    struct Operation
+    {
+        char const* name;
+        BINUMS_OPERATION operation;
+        bool isUnitMagnitude; // So long products stay finite.
+    };
+
+    Operation const operations[] =
+    {
+        {"add", BINUMS_OPERATION_ADD, false},
+        {"subtract", BINUMS_OPERATION_SUBTRACT, false},
+        {"multiply", BINUMS_OPERATION_MULTIPLY, true},
+        {"divide", BINUMS_OPERATION_DIVIDE, true},
+        {"dot", BINUMS_OPERATION_DOT, false},
+    };
+
+    BINUMS_CONTEXT* rawContext = nullptr;
+    if (BiNumsCreateContext(&rawContext) != BINUMS_STATUS_SUCCESS)
+    {
+        printf("Could not create a context for the reductions.\n");
+        return;
+    }
+    std::shared_ptr<BINUMS_CONTEXT> context(rawContext, &BiNumsDestroyContext);
+
+    // Single threaded, to time the kernels rather than the thread count of the machine.
+    BINUMS_REDUCE_OPTIONS options = BINUMS_REDUCE_OPTIONS_DEFAULT;
+    options.threadCount = 1;
+
+    for (Operation const& operation : operations)
+    {
+        for (ElementType elementType : g_numericElementTypes)
+        {
+            runner.Run(std::string("reduce ") + operation.name + " " + GetTypeName(elementType), [=](WorkingSet const& workingSet) -> BenchmarkPass
+            {
+                size_t const elementCount = workingSet.byteSize / GetByteSize(elementType);
+                std::vector<uint8_t> input = GenerateElements(elementType, elementCount, operation.isUnitMagnitude);
+                NumberUnion result;
+                if (BiNumsReduce(context.get(), operation.operation, BINUMS_ELEMENT_TYPE(elementType), input.data(), elementCount, &options, &result) != BINUMS_STATUS_SUCCESS)
+                {
+                    return {};
+                }
+                return
+                {
+                    .run = [=]()
+                    {
+                        NumberUnion runResult;
+                        BiNumsReduce(context.get(), operation.operation, BINUMS_ELEMENT_TYPE(elementType), input.data(), elementCount, &options, &runResult);
+                        Consume(runResult.ui64);
+                    },
+                    .elementCount = elementCount,
+                    .byteCount = input.size(),
+                };
+            });
+        }
+    }
+}
+
+// Size the elements to format so the input plus the output fill the working set.
+template <typename Element, typename FormatFunction>
+BenchmarkPass PrepareFormattingPass(WorkingSet const& workingSet, std::vector<Element> const& sampleElements, FormatFunction format)
+{
+    std::string sampleOutput;
+    for (Element const& element : sampleElements)
+    {
+        format(/*inout*/ sampleOutput, element);
+    }
+    size_t const elementByteSize = sizeof(Element) + sampleOutput.size() / sampleElements.size();
+    size_t const elementCount = std::max(workingSet.byteSize / elementByteSize, size_t(1));
+
+    std::vector<Element> elements(elementCount);
+    for (size_t i = 0; i < elementCount; ++i)
+    {
+        elements[i] = sampleElements[i % sampleElements.size()];
+    }
+    std::string output;
+    output.reserve(elementCount * elementByteSize * 2);
+
+    return
+    {
+        .run = [=]() mutable
+        {
+            output.clear();
+            for (Element const& element : elements)
+            {
+                format(/*inout*/ output, element);
+            }
+            Consume(output.size());
+        },
+        .elementCount = elementCount,
+        .byteCount = elementCount * elementByteSize,
+    };
+}
+
+void RunFormattingBenchmarks(BenchmarkRunner& runner)
+{
+    // Distinct values of different lengths, repeated to fill the working set.
+    std::mt19937 randomGenerator(42);
+    std::vector<uint64_t> rawValues(4096);
+    for (uint64_t& value : rawValues)
+    {
+        value = uint64_t(randomGenerator()) >> (randomGenerator() & 31);
+    }
+
+    for (uint32_t radix : {2u, 8u, 10u, 16u})
+    {
+        runner.Run("format raw integer radix " + std::to_string(radix), [&rawValues, radix](WorkingSet const& workingSet) -> BenchmarkPass
+        {
+            return PrepareFormattingPass(workingSet, rawValues, [radix](std::string& output, uint64_t value)
+            {
+                AppendFormattedRawInteger(/*inout*/ output, radix, {0, 32}, value);
+            });
+        });
+    }
+
+    struct NumericValue
+    {
+        double floatValue;
+        int64_t integerValue;
+    };
+
+    std::normal_distribution<double> normalDistribution(0.0, 1000.0);
+    std::vector<NumericValue> numericValues(4096);
+    for (NumericValue& value : numericValues)
+    {
+        value.floatValue = float(normalDistribution(randomGenerator));
+        value.integerValue = int64_t(value.floatValue);
+    }
+
+    for (ElementType elementType : {ElementType::Int32, ElementType::Uint64, ElementType::Float32, ElementType::Float64})
+    {
+        runner.Run("format numeric value " + GetTypeName(elementType), [&numericValues, elementType](WorkingSet const& workingSet) -> BenchmarkPass
+        {
+            return PrepareFormattingPass(workingSet, numericValues, [elementType](std::string& output, NumericValue const& value)
+            {
+                AppendFormattedNumericValue(/*inout*/ output, elementType, value.floatValue, value.integerValue, NumericPrintingFlags::Default);
+                output.push_back(' ');
+            });
+        });
+    }
+}
+
+void RunEndToEndBenchmarks(BenchmarkRunner& runner)
+{
+    for (char const* dataTypeName : {"int32", "float32", "float16"})
+    {
+        bool const isFractional = !StringsMatch(dataTypeName, "int32");
+        runner.Run(std::string("main add ") + dataTypeName, [=](WorkingSet const& workingSet) -> BenchmarkPass
+        {
+            // Every operand is printed, so size the operands by their text plus output.
+            auto context = std::make_shared<EvaluationContext>();
+            std::string const commandPrefix = std::string(dataTypeName) + " add ";
+            std::string sampleCommandLine = commandPrefix + GenerateNumberText(4096, isFractional, ' ');
+            std::string output;
+            if (MainImplementation(sampleCommandLine, /*out*/ output, *context) != EXIT_SUCCESS)
+            {
+                printf("\n%s\n", output.c_str());
+                return {};
+            }
+            double const outputRatio = double(output.size()) / double(sampleCommandLine.size());
+
+            std::string commandLine = commandPrefix + GenerateNumberText(size_t(double(workingSet.byteSize) / (1 + outputRatio)), isFractional, ' ');
+            size_t const elementCount = std::count(commandLine.begin(), commandLine.end(), ' ') - 1;
+            return
+            {
+                .run = [=]() mutable
+                {
+                    output.clear();
+                    MainImplementation(commandLine, /*out*/ output, *context);
+                    Consume(output.size());
+                },
+                .elementCount = elementCount,
+                .byteCount = commandLine.size() + size_t(double(commandLine.size()) * outputRatio),
+            };
+        });
+    }
+
+    // A single number shows every representation, which is all formatting, so it is only timed in L1.
+    runner.Run("main single number", [](WorkingSet const& workingSet) -> BenchmarkPass
+    {
+        if (workingSet.cacheLevel != 1)
+        {
+            return {};
+        }
+
+        auto context = std::make_shared<EvaluationContext>();
+        constexpr size_t repeatCount = 100;
+        std::string output;
+        MainImplementation("float16 -42.25", /*out*/ output, *context);
+        size_t const outputByteSize = output.size();
+        return
+        {
+            .run = [=]() mutable
+            {
+                for (size_t i = 0; i < repeatCount; ++i)
+                {
+                    output.clear();
+                    MainImplementation("float16 -42.25", /*out*/ output, *context);
+                }
+                Consume(output.size());
+            },
+            .elementCount = repeatCount,
+            .byteCount = repeatCount * outputByteSize,
+        };
+    });
+}
+
+// Each way of decoding float16/bfloat16 to float32, for both typical values and uniformly random
+// bits (more subnormals and NaN's).
+void RunDecodingBenchmarks(BenchmarkRunner& runner)
+{
+    using DecodeFunction = void(*)(uint16_t const* input, float* output, size_t count);
+
+    struct Decoder
+    {
+        char const* name;
+        DecodeFunction decode;
+        bool isSupported;
+    };
+
+    // bfloat16 has no shared table since the shift wins, but it is timed anyway for comparison.
+    static std::vector<float> bfloat16DecodeTable(65536);
+    for (uint32_t i = 0; i < 65536; ++i)
+    {
+        bfloat16DecodeTable[i] = ConvertBfloat16BitsToFloat32(uint16_t(i));
+    }
+
+    [[maybe_unused]] CpuFeatures const& cpuFeatures = GetCpuFeatures();
+    Decoder const decoders[] =
+    {
+        {"float16 half2float", [](uint16_t const* input, float* output, size_t count) { for (size_t i = 0; i < count; ++i) output[i] = half_float::detail::half2float<float>(input[i]); }, true},
+        {"float16 arithmetic", [](uint16_t const* input, float* output, size_t count) { for (size_t i = 0; i < count; ++i) output[i] = ConvertFloat16BitsToFloat32(input[i]); }, true},
+        {"float16 table", [](uint16_t const* input, float* output, size_t count) { float const* table = GetFloat16DecodeTable(); for (size_t i = 0; i < count; ++i) output[i] = table[input[i]]; }, true},
+#if BINUMS_X86
+        {"float16 f16c", &ConvertFloat16ToFloat32ArrayF16c, cpuFeatures.f16c},
+#endif
+        {"bfloat16 shift", [](uint16_t const* input, float* output, size_t count) { for (size_t i = 0; i < count; ++i) output[i] = ConvertBfloat16BitsToFloat32(input[i]); }, true},
+        {"bfloat16 table", [](uint16_t const* input, float* output, size_t count) { for (size_t i = 0; i < count; ++i) output[i] = bfloat16DecodeTable[input[i]]; }, true},
+#if BINUMS_X86
+        {"bfloat16 sse2", &ConvertBfloat16ToFloat32ArraySse2, cpuFeatures.sse2},
+#endif
+    };
+
+    // Build the table up front so the first timing does not include that.
+    GetFloat16DecodeTable();
+
+    for (bool isRandomBits : {false, true})
+    {
+        for (Decoder const& decoder : decoders)
+        {
+            if (!decoder.isSupported)
+            {
+                continue;
+            }
+
+            runner.Run(std::string("decode ") + decoder.name + (isRandomBits ? " random bits" : ""), [=](WorkingSet const& workingSet) -> BenchmarkPass
+            {
+                size_t const elementCount = workingSet.byteSize / (sizeof(uint16_t) + sizeof(float));
+                std::mt19937 randomGenerator(42);
+                std::normal_distribution<float> normalDistribution(0.0f, 2.0f);
+                std::vector<uint16_t> input(elementCount);
+                for (uint16_t& value : input)
+                {
+                    value = isRandomBits ? uint16_t(randomGenerator()) : ConvertFloat32ToFloat16Bits(normalDistribution(randomGenerator));
+                }
+                std::vector<float> output(elementCount);
+
+                return
+                {
+                    .run = [=]() mutable
+                    {
+                        decoder.decode(input.data(), output.data(), elementCount);
+                        Consume(std::bit_cast<uint32_t>(output.back()));
+                    },
+                    .elementCount = elementCount,
+                    .byteCount = elementCount * (sizeof(uint16_t) + sizeof(float)),
+                };
+            });
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Saving and comparing results.
+
+// One result per line, so a baseline can be read back without a JSON parser.
+int WriteResultsJson(char const* path, CacheSizes const& cacheSizes, std::vector<BenchmarkResult> const& results)
+{
+    FILE* file = fopen(path, "wb");
+    if (file == nullptr)
+    {
+        printf("Could not write the results to: %s\n", path);
+        return EXIT_FAILURE;
+    }
+
+    fprintf(file, "{\n");
+    fprintf(file, "  \"cacheSizes\": {\"level1\": %zu, \"level2\": %zu, \"level3\": %zu},\n", cacheSizes.level1, cacheSizes.level2, cacheSizes.level3);
+    fprintf(file, "  \"results\": [\n");
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        BenchmarkResult const& result = results[i];
+        fprintf(
+            file,
+            "    {\"name\": \"%s\", \"workingSet\": \"%s\", \"workingSetBytes\": %zu, \"elements\": %zu, \"nsPerElement\": %.6g, \"gbPerSecond\": %.6g}%s\n",
+            result.name.c_str(),
+            result.workingSetName.c_str(),
+            result.workingSetByteSize,
+            result.elementCount,
+            result.nanosecondsPerElement,
+            result.gigabytesPerSecond,
+            (i + 1 < results.size()) ? "," : ""
+        );
+    }
+    fprintf(file, "  ]\n}\n");
+    fclose(file);
+    return EXIT_SUCCESS;
+}
+
+// Read the ns per element of each result in JSON written above, keyed by name and working set.
+int ReadBaselineJson(char const* path, /*out*/ std::map<std::string, double>& baseline)
+{
+    FILE* file = fopen(path, "rb");
+    if (file == nullptr)
+    {
+        printf("Could not read the baseline: %s\n", path);
+        return EXIT_FAILURE;
+    }
+
+    auto readQuotedField = [](std::string_view line, std::string_view key) -> std::string_view
+    {
+        size_t const begin = line.find(key);
+        if (begin == line.npos)
+        {
+            return {};
+        }
+        line.remove_prefix(begin + key.size());
+        return line.substr(0, line.find('"'));
+    };
+
+    char lineBuffer[1024];
+    while (fgets(lineBuffer, sizeof(lineBuffer), file) != nullptr)
+    {
+        std::string_view const line = lineBuffer;
+        std::string_view const name = readQuotedField(line, "\"name\": \"");
+        std::string_view const workingSetName = readQuotedField(line, "\"workingSet\": \"");
+        size_t const valueBegin = line.find("\"nsPerElement\": ");
+        if (name.empty() || workingSetName.empty() || valueBegin == line.npos)
+        {
+            continue;
+        }
+        double const nanosecondsPerElement = atof(lineBuffer + valueBegin + strlen("\"nsPerElement\": "));
+        baseline[std::string(name) + "/" + std::string(workingSetName)] = nanosecondsPerElement;
+    }
+
+    fclose(file);
+    return EXIT_SUCCESS;
+}
+
+// Print every result that changed beyond the threshold, failing if any got slower.
+int CompareToBaseline(std::map<std::string, double> const& baseline, std::vector<BenchmarkResult> const& results, double regressionThreshold)
+{
+    size_t comparedCount = 0, slowerCount = 0, fasterCount = 0;
+    printf("\nCompared to the baseline (ns/elem, beyond %.0f%%):\n", regressionThreshold * 100);
+    for (BenchmarkResult const& result : results)
+    {
+        auto const baselineResult = baseline.find(result.name + "/" + result.workingSetName);
+        if (baselineResult == baseline.end() || baselineResult->second <= 0)
+        {
+            continue;
+        }
+
+        ++comparedCount;
+        double const change = result.nanosecondsPerElement / baselineResult->second - 1;
+        if (std::abs(change) <= regressionThreshold)
+        {
+            continue;
+        }
+
+        bool const isSlower = change > 0;
+        slowerCount += isSlower ? 1 : 0;
+        fasterCount += isSlower ? 0 : 1;
+        printf(
+            "%-40s %-5s %10.3f -> %10.3f  %+7.1f%% %s\n",
+            result.name.c_str(),
+            result.workingSetName.c_str(),
+            baselineResult->second,
+            result.nanosecondsPerElement,
+            change * 100,
+            isSlower ? "slower" : "faster"
+        );
+    }
+    printf("%zu compared, %zu slower, %zu faster.\n", comparedCount, slowerCount, fasterCount);
+
+    return (slowerCount > 0) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+int main(int argc, char* argv[])
+{
+    auto exitCode = ParseCommandLineParameters(argc, argv);
+    if (exitCode != EXIT_SUCCESS)
+    {
+        return exitCode;
+    }
+
+    std::map<std::string, double> baseline;
+    if (g_options.baselinePath != nullptr)
+    {
+        exitCode = ReadBaselineJson(g_options.baselinePath, /*out*/ baseline);
+        if (exitCode != EXIT_SUCCESS)
+        {
+            return exitCode;
+        }
+    }
+
+    CacheSizes const cacheSizes = DetectCacheSizes();
+    printf("Cache sizes: L1 %zu KiB, L2 %zu KiB, L3 %zu KiB\n\n", cacheSizes.level1 >> 10, cacheSizes.level2 >> 10, cacheSizes.level3 >> 10);
+
+    BenchmarkRunner runner(g_options, GetWorkingSets(cacheSizes, g_options.isQuick));
+    runner.PrintHeader();
+    RunParsingBenchmarks(runner);
+    RunCastingBenchmarks(runner);
+    RunReductionBenchmarks(runner);
+    RunFormattingBenchmarks(runner);
+    RunEndToEndBenchmarks(runner);
+    RunDecodingBenchmarks(runner);
+
+    if (g_options.jsonPath != nullptr)
+    {
+        exitCode = WriteResultsJson(g_options.jsonPath, cacheSizes, runner.GetResults());
+        if (exitCode != EXIT_SUCCESS)
+        {
+            return exitCode;
+        }
+    }
+
+    if (g_options.baselinePath != nullptr)
+    {
+        exitCode = CompareToBaseline(baseline, runner.GetResults(), g_options.regressionThreshold);
+    }
+
+    return exitCode;
+}
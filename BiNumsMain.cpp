@@ -1,10 +1,24 @@
 ﻿// BiNums main, separated out from BiNums just so tests and main executable don't have both a main function.
 
 #include "precomp.h"
+#include <csignal>
+#if _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
 
-extern int MainImplementation(std::string_view commandLine, std::string& stringOutput);
+extern int MainImplementation(std::string_view commandLine, std::string& stringOutput, EvaluationContext& context);
+extern int ServeCommandLines(FILE* input, FILE* output, EvaluationContext& context);
 extern std::string ConcatenateCommandLineParameters(int argc, char* argv[]);
 
+SocketServer g_socketServer;
+
+// Stop serving on interruption, so the socket file is removed on the way out.
+extern "C" void StopSocketServer(int /*signalNumber*/)
+{
+    g_socketServer.Stop();
+}
+
 int main(int argc, char* argv[])
 {
     // Standard C/C++ tries to be helpful by chopping up the arguments for us,
@@ -13,8 +27,35 @@ int main(int argc, char* argv[])
     // back to the original string.
     std::string commandLine = ConcatenateCommandLineParameters(argc, argv);
 
+    EvaluationContext context;
+    if (argc == 3 && strcmp(argv[1], "--serve") == 0)
+    {
+        std::string errorMessage;
+        if (g_socketServer.Start(argv[2], /*workerCount*/ 0, /*out*/ errorMessage) != EXIT_SUCCESS)
+        {
+            std::fputs(errorMessage.c_str(), stdout);
+            return EXIT_FAILURE;
+        }
+        std::signal(SIGINT, StopSocketServer);
+        std::signal(SIGTERM, StopSocketServer);
+        g_socketServer.Wait();
+        return EXIT_SUCCESS;
+    }
+    if (commandLine == "--serve")
+    {
+        // Byte counts must match what is written, without newline translation.
+        #if _WIN32
+        _setmode(_fileno(stdin), _O_BINARY);
+        _setmode(_fileno(stdout), _O_BINARY);
+        #endif
+        return ServeCommandLines(stdin, stdout, context);
+    }
+
+    // Streamed operations write their output as they go rather than all at the end.
+    context.outputStream = stdout;
+
     std::string stringOutput;
-    int exitCode = MainImplementation(commandLine, /*out*/ stringOutput);
+    int exitCode = MainImplementation(commandLine, /*out*/ stringOutput, context);
     std::fputs(stringOutput.c_str(), stdout);
 
     return exitCode;
@@ -1,13 +1,28 @@
 ﻿// BiNums, see binary numbers
 
 #include "precomp.h"
+#include <chrono>
+#include <filesystem>
 #if _WIN32
 #define NOMINMAX
 #define WIN32_LEAN_AND_MEAN
 #include <Windows.h>
+#else
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+using WORD = uint16_t;
+constexpr WORD FOREGROUND_RED = 0x0004;
+constexpr WORD FOREGROUND_GREEN = 0x0002;
+constexpr WORD COMMON_LVB_UNDERSCORE = 0x8000;
 #endif
 
 extern int MainImplementation(std::string_view commandLine, std::string& stringOutput);
+extern int MainImplementation(std::string_view commandLine, std::string& stringOutput, EvaluationContext& context);
+extern int ServeCommandLines(FILE* input, FILE* output, EvaluationContext& context);
+extern std::string GetFormatted(char const* formatString, ...);
+extern void CastElementType(ElementType inputDataType, ElementType outputDataType, void const* inputData, void* outputData);
+extern void CastElementTypeArray(ElementType inputDataType, ElementType outputDataType, void const* inputData, void* outputData, size_t count);
 
 ////////////////////////////////////////////////////////////////////////////////
 // Generic functions/classes.
@@ -78,9 +93,35 @@ struct SetAndSaveConsoleAttribute
 };
 
 
+// Prints a colored OK/FAILED line for a check that counted its mismatches, with an optional detail
+// such as the first mismatch, and returns whether there were none.
+bool PrintMismatchResult(std::string_view title, size_t mismatchCount, std::string_view detail = {})
+{
+    bool const valuesMatch = (mismatchCount == 0);
+    SetAndSaveConsoleAttribute consoleAttributes;
+    consoleAttributes.UpdateForegroundColor(valuesMatch ? FOREGROUND_GREEN : FOREGROUND_RED);
+    if (valuesMatch)
+    {
+        printf("OK     - %.*s\n", static_cast<int>(title.size()), title.data());
+    }
+    else
+    {
+        printf("FAILED - %.*s - %zu mismatches", static_cast<int>(title.size()), title.data(), mismatchCount);
+        if (!detail.empty())
+        {
+            printf(", %.*s", static_cast<int>(detail.size()), detail.data());
+        }
+        printf("\n");
+    }
+    consoleAttributes.Reset();
+    return valuesMatch;
+}
+
+
 struct BiNumsTest
 {
     bool shouldRegenerateExpectedBaseline = false;
+    bool shouldSweepAllFloat32Values = false;
 };
 
 BiNumsTest g_test;
@@ -97,6 +138,7 @@ int ParseCommandLineParameters(int argc, char* argv[])
                 "Failed test results go into 'TestResults\\'.\n"
                 "\n"
                 "regenerate : regenerate the test cases (use git diff afterward to verify differences)\n"
+                "exhaustive : convert every float32 value to float16/bfloat16/float8, not just a sample (seconds on many cores)\n"
             );
             return EXIT_FAILURE;
         }
@@ -104,6 +146,10 @@ int ParseCommandLineParameters(int argc, char* argv[])
         {
             g_test.shouldRegenerateExpectedBaseline = true;
         }
+        else if (StringsMatch(argument, "exhaustive"))
+        {
+            g_test.shouldSweepAllFloat32Values = true;
+        }
         else
         {
             printf(
@@ -239,7 +285,7 @@ bool VerifyFloatingTypes()
         std::numeric_limits<float>::infinity(),
        -std::numeric_limits<float>::infinity()
     };
-    constexpr double testNumbersFloat32[] = {
+    static constexpr double testNumbersFloat32[] = {
         0.0,
         1.0,
        -1.0,
@@ -349,48 +395,1760 @@ bool VerifyFloatingTypes()
     return success;
 }
 
+// Compare the vectorized float16 kernels against the scalar codec, which is the reference.
+bool VerifyFloat16Codec()
+{
+    bool success = true;
+
+    // Decode every float16 bit pattern.
+    std::vector<uint16_t> float16Values(65536);
+    std::vector<float> float32Values(65536);
+    for (size_t i = 0; i < float16Values.size(); ++i)
+    {
+        float16Values[i] = uint16_t(i);
+    }
 
-int main(int argc, char* argv[])
+    ConvertFloat16ToFloat32Array(float16Values.data(), /*out*/ float32Values.data(), float16Values.size());
+    size_t mismatchCount = 0;
+    for (size_t i = 0; i < float16Values.size(); ++i)
+    {
+        float const expectedValue = ConvertFloat16BitsToFloat32(float16Values[i]);
+        mismatchCount += std::bit_cast<uint32_t>(expectedValue) != std::bit_cast<uint32_t>(float32Values[i]);
+    }
+    success &= PrintMismatchResult("float16 to float32 array, all values", mismatchCount);
+
+    // Encode a sweep of float32 bit patterns, plus every halfway case between adjacent float16 values.
+    float32Values.clear();
+    for (uint64_t bits = 0; bits <= 0xFFFFFFFF; bits += 65521)
+    {
+        float32Values.push_back(std::bit_cast<float>(uint32_t(bits)));
+    }
+    for (uint32_t i = 0; i < 0x7C00; ++i)
+    {
+        double const halfwayValue = (double(ConvertFloat16BitsToFloat32(uint16_t(i))) + double(ConvertFloat16BitsToFloat32(uint16_t(i + 1)))) / 2;
+        float32Values.push_back(float(halfwayValue));
+        float32Values.push_back(-float(halfwayValue));
+    }
+
+    float16Values.resize(float32Values.size());
+    ConvertFloat32ToFloat16Array(float32Values.data(), /*out*/ float16Values.data(), float32Values.size());
+    mismatchCount = 0;
+    for (size_t i = 0; i < float32Values.size(); ++i)
+    {
+        mismatchCount += ConvertFloat32ToFloat16Bits(float32Values[i]) != float16Values[i];
+    }
+    success &= PrintMismatchResult("float32 to float16 array, sweep and halfway values", mismatchCount);
+
+    // Halfway values round to the even neighbor.
+    success &= PrintMismatchResult("float32 to float16 ties to even", (ConvertFloat32ToFloat16Bits(1.0f + 1.0f / 2048) != 0x3C00) + (ConvertFloat32ToFloat16Bits(1.0f + 3.0f / 2048) != 0x3C02));
+
+    return success;
+}
+
+// Compare the vectorized bfloat16 kernels against the scalar codec, for both rounding modes.
+bool VerifyBfloat16Codec()
 {
-    printf("*** This test suite is just a skeleton for now. ***\n\n");
+    bool success = true;
 
-    auto exitCode = ParseCommandLineParameters(argc, argv);
-    if (exitCode != EXIT_SUCCESS)
+    // Sweep float32 bit patterns, including denormals, NaN's with only low payload bits, and exact ties.
+    std::vector<float> float32Values;
+    for (uint64_t bits = 0; bits <= 0xFFFFFFFF; bits += 65521)
     {
-        return exitCode;
+        float32Values.push_back(std::bit_cast<float>(uint32_t(bits)));
+    }
+    for (uint32_t bits : {0x00018000u, 0x80018000u, 0x3F808000u, 0x3F818000u, 0x7F7F8000u, 0x7F800001u, 0xFF800001u})
+    {
+        float32Values.push_back(std::bit_cast<float>(bits));
     }
 
-    // Placeholder for real tests, which should be data driven in a test file,
-    // preferably JSON or XML (XML might simpler given all the new lines).
-    std::string stringOutput;
-    exitCode = MainImplementation("uint8 42 int8 -42 uint16 42 int16 -42 uint32 42 int32 -42 uint64 42 int64 -42 fixed12_12 -42.25 fixed16_16 -42.25 fixed8_24 -42.25 float16 -42.25 float32 -42.25 float64 -42.25", stringOutput);
+    std::vector<uint16_t> bfloat16Values(float32Values.size());
+    for (Bfloat16Rounding rounding : {Bfloat16Rounding::NearestEven, Bfloat16Rounding::TowardZero})
+    {
+        ConvertFloat32ToBfloat16Array(float32Values.data(), /*out*/ bfloat16Values.data(), float32Values.size(), rounding);
+        size_t mismatchCount = 0;
+        for (size_t i = 0; i < float32Values.size(); ++i)
+        {
+            mismatchCount += ConvertFloat32ToBfloat16Bits(float32Values[i], rounding) != bfloat16Values[i];
+        }
+        success &= PrintMismatchResult(rounding == Bfloat16Rounding::NearestEven ? "float32 to bfloat16 array, nearest even" : "float32 to bfloat16 array, toward zero", mismatchCount);
+    }
 
-    uint32_t errorCount = 0;
-    auto CheckFailure = [&](bool success)
+    success &= PrintMismatchResult("float32 to bfloat16 ties to even",
+        (ConvertFloat32ToBfloat16Bits(std::bit_cast<float>(0x3F808000u)) != 0x3F80) +
+        (ConvertFloat32ToBfloat16Bits(std::bit_cast<float>(0x3F818000u)) != 0x3F82) +
+        (ConvertFloat32ToBfloat16Bits(std::bit_cast<float>(0x3F81FFFFu), Bfloat16Rounding::TowardZero) != 0x3F81));
+    success &= PrintMismatchResult("float32 to bfloat16 NaN stays NaN",
+        (ConvertFloat32ToBfloat16Bits(std::bit_cast<float>(0x7F800001u)) != 0x7FC0) +
+        (ConvertFloat32ToBfloat16Bits(std::bit_cast<float>(0xFF800001u), Bfloat16Rounding::TowardZero) != 0xFFC0));
+
+    return success;
+}
+
+// Compare the float8 lookup tables against known values, and the vectorized kernels against the scalar codec.
+bool VerifyFloat8Codec()
+{
+    using namespace FloatNumberDetails;
+
+    bool success = true;
+
+    auto const& e4m3 = g_float8CodecTables<Float8f3e4s1Definition>;
+    auto const& e5m2 = g_float8CodecTables<Float8f2e5s1Definition>;
+    success &= PrintMismatchResult("float8e4m3 decode table",
+        (e4m3.decode[0x01] != 0.001953125f) + (e4m3.decode[0x7E] != 448.0f) + (e4m3.decode[0xB8] != -1.0f) + !std::isnan(e4m3.decode[0x7F]));
+    success &= PrintMismatchResult("float8e5m2 decode table",
+        (e5m2.decode[0x01] != 0.0000152587890625f) + (e5m2.decode[0x7B] != 57344.0f) + (e5m2.decode[0xBC] != -1.0f) + !std::isinf(e5m2.decode[0x7C]) + !std::isnan(e5m2.decode[0x7D]));
+
+    // Ties go to even, overflow saturates (e4m3) or becomes infinity (e5m2), and NaN stays NaN.
+    success &= PrintMismatchResult("float32 to float8e4m3 rounding",
+        (ConvertFloat32ToFloat8Bits<Float8f3e4s1Definition>(1.0625f) != 0x38) +
+        (ConvertFloat32ToFloat8Bits<Float8f3e4s1Definition>(1.1875f) != 0x3A) +
+        (ConvertFloat32ToFloat8Bits<Float8f3e4s1Definition>(1e6f) != 0x7E) +
+        (ConvertFloat32ToFloat8Bits<Float8f3e4s1Definition>(-std::numeric_limits<float>::quiet_NaN()) != 0xFF));
+    success &= PrintMismatchResult("float32 to float8e5m2 rounding",
+        (ConvertFloat32ToFloat8Bits<Float8f2e5s1Definition>(1.125f) != 0x3C) +
+        (ConvertFloat32ToFloat8Bits<Float8f2e5s1Definition>(61440.0f) != 0x7C) +
+        (ConvertFloat32ToFloat8Bits<Float8f2e5s1Definition>(61439.0f) != 0x7B) +
+        (ConvertFloat64ToFloat8Bits<Float8f2e5s1Definition>(1.125 + 1e-12) != 0x3D));
+
+    std::vector<float> float32Values;
+    for (uint64_t bits = 0; bits <= 0xFFFFFFFF; bits += 65521)
     {
-        errorCount += success ? 0 : 1;
+        float32Values.push_back(std::bit_cast<float>(uint32_t(bits)));
+    }
+    std::vector<uint8_t> float8Values(float32Values.size());
+
+    auto CountArrayMismatches = [&]<typename FloatDefinition>(FloatDefinition)
+    {
+        ConvertFloat32ToFloat8Array<FloatDefinition>(float32Values.data(), /*out*/ float8Values.data(), float32Values.size());
+        size_t mismatchCount = 0;
+        for (size_t i = 0; i < float32Values.size(); ++i)
+        {
+            mismatchCount += ConvertFloat32ToFloat8Bits<FloatDefinition>(float32Values[i]) != float8Values[i];
+        }
+        return mismatchCount;
     };
+    success &= PrintMismatchResult("float32 to float8e4m3 array, sweep", CountArrayMismatches(Float8f3e4s1Definition{}));
+    success &= PrintMismatchResult("float32 to float8e5m2 array, sweep", CountArrayMismatches(Float8f2e5s1Definition{}));
 
-    char const* expectedOutput =
-        "         uint8 42 (0x2A)\n"
-        "          int8 -42 (0xD6)\n"
-        "        uint16 42 (0x002A)\n"
-        "         int16 -42 (0xFFD6)\n"
-        "        uint32 42 (0x0000002A)\n"
-        "         int32 -42 (0xFFFFFFD6)\n"
-        "        uint64 42 (0x000000000000002A)\n"
-        "         int64 -42 (0xFFFFFFFFFFFFFFD6)\n"
-        "    fixed12_12 -42.25 (0xFD5C00)\n"
-        "    fixed16_16 -42.25 (0xFFD5C000)\n"
-        "     fixed8_24 -42.25 (0xD5C00000)\n"
-        "       float16 -42.25 (0xD148)\n"
-        "       float32 -42.25 (0xC2290000)\n"
-        "       float64 -42.25 (0xC045200000000000)\n"
-        ;
-    CheckFailure(CompareExpectedVsActual("All data types", stringOutput, expectedOutput));
-    CheckFailure(CompareExpectedVsActual("Expected failure case to verify output comparison", stringOutput, "Gibberish just to verify failure"));
+    return success;
+}
 
-    CheckFailure(VerifyFloatingTypes());
+
+// Compare the vectorized dot product kernels against the exact result, on small integers
+// where every partial sum is exact in every type, so the summation order does not matter.
+bool VerifyDotProduct()
+{
+    bool success = true;
+
+    size_t float32MismatchCount = 0, float64MismatchCount = 0, float16MismatchCount = 0, bfloat16MismatchCount = 0;
+    size_t avx2MismatchCount = 0;
+#if BINUMS_X86
+    bool const hasAvx2Kernels = DotProductDetails::HasAvx2Kernels(GetCpuFeatures());
+#endif
+
+    // Every count up to a few full steps of the widest kernel, to cover each tail length.
+    for (size_t count = 0; count < 300; ++count)
+    {
+        std::vector<float> float32Values(count);
+        std::vector<double> float64Values(count);
+        std::vector<uint16_t> float16Values(count), bfloat16Values(count);
+        double expectedSum = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            float const value = float(int(i % 5) - 2);
+            float32Values[i] = value;
+            float64Values[i] = value;
+            float16Values[i] = ConvertFloat32ToFloat16Bits(value);
+            bfloat16Values[i] = ConvertFloat32ToBfloat16Bits(value);
+            expectedSum += (i & 1) ? float64Values[i - 1] * value : 0.0;
+        }
+        if (count & 1)
+        {
+            expectedSum += float64Values[count - 1];
+        }
+
+        float32MismatchCount += DotInterleavedFloat32(float32Values.data(), count) != expectedSum;
+        float64MismatchCount += DotInterleavedFloat64(float64Values.data(), count) != expectedSum;
+        float16MismatchCount += ConvertFloat16BitsToFloat32(DotInterleavedFloat16(float16Values.data(), count)) != expectedSum;
+        bfloat16MismatchCount += ConvertBfloat16BitsToFloat32(DotInterleavedBfloat16(bfloat16Values.data(), count)) != expectedSum;
+
+    #if BINUMS_X86
+        // The dispatch above prefers AVX-512 where available, so check AVX2 directly too.
+        if (hasAvx2Kernels)
+        {
+            using namespace DotProductDetails;
+            avx2MismatchCount += DotInterleavedAvx2<Avx2DoubledLanes<Float32Avx2Lanes>>(float32Values.data(), count) != expectedSum;
+            avx2MismatchCount += DotInterleavedAvx2<Avx2DoubledLanes<Float64Avx2Lanes>>(float64Values.data(), count) != expectedSum;
+            avx2MismatchCount += DotInterleavedAvx2<Avx2DoubledLanes<Float16Avx2Lanes>>(float16Values.data(), count) != expectedSum;
+            avx2MismatchCount += DotInterleavedAvx2<Avx2DoubledLanes<Bfloat16Avx2Lanes>>(bfloat16Values.data(), count) != expectedSum;
+        }
+    #endif
+    }
+
+    success &= PrintMismatchResult("float32 dot product", float32MismatchCount);
+    success &= PrintMismatchResult("float64 dot product", float64MismatchCount);
+    success &= PrintMismatchResult("float16 dot product", float16MismatchCount);
+    success &= PrintMismatchResult("bfloat16 dot product", bfloat16MismatchCount);
+    success &= PrintMismatchResult("AVX2 dot products", avx2MismatchCount);
+
+    // On values with full mantissas the order matters, and every kernel must still give the
+    // scalar layout's bits.
+    size_t layoutMismatchCount = 0;
+    for (size_t count = 0; count < 1200; count += (count < 300) ? 1 : 37)
+    {
+        std::vector<float> float32Values(count);
+        std::vector<double> float64Values(count);
+        std::vector<uint16_t> float16Values(count), bfloat16Values(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            float const value = float(int32_t(uint32_t(i + count) * 2654435761u)) * 0x1p-31f;
+            float32Values[i] = value;
+            float64Values[i] = double(value) * (1 + 0x1p-40);
+            float16Values[i] = ConvertFloat32ToFloat16Bits(value);
+            bfloat16Values[i] = ConvertFloat32ToBfloat16Bits(value);
+        }
+
+        using namespace DotProductDetails;
+        uint32_t const float32Sum = std::bit_cast<uint32_t>(DotInterleaved<Float32Scalar>(float32Values.data(), count));
+        uint64_t const float64Sum = std::bit_cast<uint64_t>(DotInterleaved<Float64Scalar>(float64Values.data(), count));
+        uint16_t const float16Sum = ConvertFloat32ToFloat16Bits(DotInterleaved<Float16Scalar>(float16Values.data(), count));
+        uint16_t const bfloat16Sum = ConvertFloat32ToBfloat16Bits(DotInterleaved<Bfloat16Scalar>(bfloat16Values.data(), count));
+
+        layoutMismatchCount += std::bit_cast<uint32_t>(DotInterleavedFloat32(float32Values.data(), count)) != float32Sum;
+        layoutMismatchCount += std::bit_cast<uint64_t>(DotInterleavedFloat64(float64Values.data(), count)) != float64Sum;
+        layoutMismatchCount += DotInterleavedFloat16(float16Values.data(), count) != float16Sum;
+        layoutMismatchCount += DotInterleavedBfloat16(bfloat16Values.data(), count) != bfloat16Sum;
+
+    #if BINUMS_X86
+        if (hasAvx2Kernels)
+        {
+            layoutMismatchCount += std::bit_cast<uint32_t>(DotInterleavedAvx2<Avx2DoubledLanes<Float32Avx2Lanes>>(float32Values.data(), count)) != float32Sum;
+            layoutMismatchCount += std::bit_cast<uint64_t>(DotInterleavedAvx2<Avx2DoubledLanes<Float64Avx2Lanes>>(float64Values.data(), count)) != float64Sum;
+            layoutMismatchCount += ConvertFloat32ToFloat16Bits(DotInterleavedAvx2<Avx2DoubledLanes<Float16Avx2Lanes>>(float16Values.data(), count)) != float16Sum;
+            layoutMismatchCount += ConvertFloat32ToBfloat16Bits(DotInterleavedAvx2<Avx2DoubledLanes<Bfloat16Avx2Lanes>>(bfloat16Values.data(), count)) != bfloat16Sum;
+        }
+        if (hasAvx2Kernels && GetCpuFeatures().avx512f)
+        {
+            layoutMismatchCount += std::bit_cast<uint32_t>(DotInterleavedAvx512<Float32Avx512Lanes>(float32Values.data(), count)) != float32Sum;
+            layoutMismatchCount += std::bit_cast<uint64_t>(DotInterleavedAvx512<Float64Avx512Lanes>(float64Values.data(), count)) != float64Sum;
+            layoutMismatchCount += ConvertFloat32ToFloat16Bits(DotInterleavedAvx512<Float16Avx512Lanes>(float16Values.data(), count)) != float16Sum;
+            layoutMismatchCount += ConvertFloat32ToBfloat16Bits(DotInterleavedAvx512<Bfloat16Avx512Lanes>(bfloat16Values.data(), count)) != bfloat16Sum;
+        }
+    #endif
+    }
+    success &= PrintMismatchResult("dot products give the same bits on every instruction set", layoutMismatchCount);
+
+    // 2048 + 1 rounds back to 2048 in float16, rather than accumulating in float32.
+    uint16_t const roundingValues[] = {0x6800, 0x3C00, 0x3C00, 0x3C00, 0x3C00, 0x3C00}; // 2048 1 1 1 1 1
+    success &= PrintMismatchResult("float16 dot product rounds each step", DotInterleavedFloat16(roundingValues, std::size(roundingValues)) != 0x6800);
+
+    return success;
+}
+
+// Every summation mode must be exact where every partial sum is exact, for every tail length and
+// pairwise split, and must stay within its error bound on a long sum where sequential drifts.
+bool VerifySummation()
+{
+    bool success = true;
+
+    constexpr SummationMode summationModes[] = {SummationMode::Pairwise, SummationMode::Kahan, SummationMode::Neumaier};
+    auto identity32 = [](float value) noexcept { return value; };
+    auto identity64 = [](double value) noexcept { return value; };
+
+    size_t float32MismatchCount = 0, float64MismatchCount = 0, scalarMismatchCount = 0;
+    for (size_t count = 0; count < 600; ++count)
+    {
+        std::vector<float> float32Values(count);
+        std::vector<double> float64Values(count);
+        double expectedSum = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            float const value = float(int(i % 7) - 3);
+            float32Values[i] = value;
+            float64Values[i] = value;
+            expectedSum += value;
+        }
+
+        for (SummationMode summationMode : summationModes)
+        {
+            float32MismatchCount += SumFloat32Array(float32Values.data(), count, summationMode) != expectedSum;
+            float64MismatchCount += SumFloat64Array(float64Values.data(), count, summationMode) != expectedSum;
+            scalarMismatchCount += SumArrayScalar<float>(float32Values.data(), count, summationMode, identity32, identity32) != expectedSum;
+            scalarMismatchCount += SumArrayScalar<double>(float64Values.data(), count, summationMode, identity64, identity64) != expectedSum;
+        }
+    }
+
+    success &= PrintMismatchResult("float32 summation", float32MismatchCount);
+    success &= PrintMismatchResult("float64 summation", float64MismatchCount);
+    success &= PrintMismatchResult("scalar summation", scalarMismatchCount);
+
+    // On values with full mantissas the lane layout matters, and the AVX2 kernels must give the
+    // bits of the plain code that runs elsewhere.
+    size_t layoutMismatchCount = 0;
+    for (size_t count = 0; count < 3000; count += (count < 600) ? 1 : 53)
+    {
+        std::vector<float> float32Values(count);
+        std::vector<double> float64Values(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            float const value = float(int32_t(uint32_t(i + count) * 2654435761u)) * 0x1p-31f;
+            float32Values[i] = value * float(1 << (i % 20));
+            float64Values[i] = double(value) * (1 + 0x1p-40) * double(1 << (i % 40));
+        }
+
+        for (SummationMode summationMode : summationModes)
+        {
+            uint32_t const float32Sum = std::bit_cast<uint32_t>(SummationDetails::SumArrayLanes(float32Values.data(), count, summationMode));
+            uint64_t const float64Sum = std::bit_cast<uint64_t>(SummationDetails::SumArrayLanes(float64Values.data(), count, summationMode));
+            layoutMismatchCount += std::bit_cast<uint32_t>(SumFloat32Array(float32Values.data(), count, summationMode)) != float32Sum;
+            layoutMismatchCount += std::bit_cast<uint64_t>(SumFloat64Array(float64Values.data(), count, summationMode)) != float64Sum;
+
+        #if BINUMS_X86
+            if (GetCpuFeatures().avx2)
+            {
+                using namespace SummationDetails;
+                layoutMismatchCount += std::bit_cast<uint32_t>(SumArrayAvx2<Float32Avx2Lanes>(float32Values.data(), count, summationMode)) != float32Sum;
+                layoutMismatchCount += std::bit_cast<uint64_t>(SumArrayAvx2<Float64Avx2Lanes>(float64Values.data(), count, summationMode)) != float64Sum;
+            }
+        #endif
+        }
+    }
+    success &= PrintMismatchResult("summation modes give the same bits with and without AVX2", layoutMismatchCount);
+
+    // A million values in [0, 1) at 2^-24 granularity, whose exact sum fits in a double.
+    std::vector<float> values(1 << 20);
+    double exactSum = 0;
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        values[i] = float(uint32_t(i * 2654435761u) >> 8) * 0x1p-24f;
+        exactSum += values[i];
+    }
+
+    // Compensated sums land within an ulp of the exact sum, and pairwise within a few.
+    double const ulp = std::nextafter(float(exactSum), INFINITY) - float(exactSum);
+    success &= PrintMismatchResult("float32 Kahan summation error", std::abs(SumFloat32Array(values.data(), values.size(), SummationMode::Kahan) - exactSum) > ulp);
+    success &= PrintMismatchResult("float32 Neumaier summation error", std::abs(SumFloat32Array(values.data(), values.size(), SummationMode::Neumaier) - exactSum) > ulp);
+    success &= PrintMismatchResult("float32 pairwise summation error", std::abs(SumFloat32Array(values.data(), values.size(), SummationMode::Pairwise) - exactSum) > ulp * 16);
+
+    return success;
+}
+
+// Every task must run exactly once for any thread count, and chunked reductions must give the
+// same bits for any thread count.
+bool VerifyParallelReduction()
+{
+    bool success = true;
+
+    // A pool of its own, so the threads run even on a machine with a single hardware thread.
+    ThreadPool threadPool(3);
+    constexpr uint32_t threadCounts[] = {1, 2, 3, 4, 0};
+
+    size_t taskMismatchCount = 0;
+    for (size_t taskCount : {0, 1, 2, 5, 100, 1000})
+    {
+        for (uint32_t threadCount : threadCounts)
+        {
+            std::vector<std::atomic<uint32_t>> runCounts(taskCount);
+            threadPool.ParallelFor(taskCount, threadCount, [&](size_t i) { ++runCounts[i]; });
+            taskMismatchCount += std::count_if(runCounts.begin(), runCounts.end(), [](auto& runCount) { return runCount != 1; });
+        }
+    }
+    success &= PrintMismatchResult("thread pool runs every task once", taskMismatchCount);
+
+    size_t threadIndexMismatchCount = 0;
+    for (uint32_t threadCount : threadCounts)
+    {
+        std::atomic<size_t> outOfRangeCount = 0;
+        uint32_t const threadIndexCount = threadPool.GetThreadCount(threadCount);
+        threadPool.ParallelFor(1000, threadCount, [&](size_t, uint32_t threadIndex) { outOfRangeCount += (threadIndex >= threadIndexCount); });
+        threadIndexMismatchCount += outOfRangeCount;
+    }
+    success &= PrintMismatchResult("thread pool thread indices are within the thread count", threadIndexMismatchCount);
+
+    // Every task still runs, and one thread rethrows the first exception in task order.
+    size_t exceptionMismatchCount = 0;
+    for (uint32_t threadCount : {0u, 1u})
+    {
+        std::atomic<size_t> ranTaskCount = 0;
+        std::string exceptionMessage;
+        try
+        {
+            threadPool.ParallelFor(100, threadCount, [&](size_t i)
+            {
+                ++ranTaskCount;
+                if (i == 7 || i == 20)
+                {
+                    throw std::runtime_error(i == 7 ? "Task 7 failed." : "Task 20 failed.");
+                }
+            });
+        }
+        catch (std::runtime_error const& exception)
+        {
+            exceptionMessage = exception.what();
+        }
+        exceptionMismatchCount += (ranTaskCount != 100);
+        exceptionMismatchCount += (threadCount == 1) ? (exceptionMessage != "Task 7 failed.") : exceptionMessage.empty();
+    }
+    success &= PrintMismatchResult("thread pool rethrows task exceptions after the other tasks", exceptionMismatchCount);
+
+    std::vector<float> values((1 << 20) + 123);
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        values[i] = float(uint32_t(i * 2654435761u) >> 8) * 0x1p-24f;
+    }
+
+    size_t reductionMismatchCount = 0;
+    for (SummationMode summationMode : {SummationMode::Sequential, SummationMode::Pairwise, SummationMode::Kahan})
+    {
+        std::optional<uint32_t> firstSumBits;
+        for (uint32_t threadCount : threadCounts)
+        {
+            float const sum = ReduceInChunks<float>(
+                values.size(),
+                threadCount,
+                [&](size_t begin, size_t count) { return SumFloat32Array(values.data() + begin, count, summationMode); },
+                [](std::pmr::vector<float>& partials) { return CombineInTreeOrder(partials, [](float a, float b) { return a + b; }); },
+                4096,
+                &threadPool
+            );
+            uint32_t const sumBits = std::bit_cast<uint32_t>(sum);
+            reductionMismatchCount += firstSumBits.value_or(sumBits) != sumBits;
+            firstSumBits = sumBits;
+        }
+    }
+    success &= PrintMismatchResult("chunked sums are identical for any thread count", reductionMismatchCount);
+
+    return success;
+}
+
+// Evaluating again with a warmed up context must give the same output without allocating,
+// including when the scratch arena starts too small and has to grow.
+bool VerifyEvaluationContext()
+{
+    bool success = true;
+
+    // Long enough to reduce in several chunks.
+    std::string longCommandLine = "float16 accumulate float32 add";
+    for (uint32_t i = 0; i < 3 * g_reductionChunkSize; ++i)
+    {
+        longCommandLine.push_back(' ');
+        longCommandLine.push_back(char('0' + i % 9));
+    }
+    longCommandLine.append(" float32 sum kahan add");
+    for (uint32_t i = 0; i < 3 * g_reductionChunkSize; ++i)
+    {
+        longCommandLine.push_back(' ');
+        longCommandLine.push_back(char('0' + i % 5));
+        longCommandLine.append(".5");
+    }
+
+    std::string_view const commandLines[] =
+    {
+        "float32 add 1 2 3 4",
+        "float16 accumulate float32 block 2 dot 2048 1 1 1 1 1",
+        "trunc 7 1.5 float16 -2.5 sum neumaier dot 1.5 2 3 4",
+        "uint8 42 int8 -42",
+        longCommandLine,
+    };
+
+    EvaluationContext context(256);
+    std::string stringOutput, expectedOutput;
+    size_t outputMismatchCount = 0, allocationCount = 0;
+    for (uint32_t pass = 0; pass < 3; ++pass)
+    {
+        size_t const previousAllocationCount = context.GetAllocationCount();
+        for (std::string_view commandLine : commandLines)
+        {
+            expectedOutput.clear();
+            MainImplementation(commandLine, /*out*/ expectedOutput);
+            stringOutput.clear();
+            MainImplementation(commandLine, /*out*/ stringOutput, context);
+            outputMismatchCount += (stringOutput != expectedOutput);
+        }
+        if (pass > 0)
+        {
+            allocationCount += context.GetAllocationCount() - previousAllocationCount;
+        }
+    }
+    success &= PrintMismatchResult("evaluation context output", outputMismatchCount);
+    success &= PrintMismatchResult("evaluation context allocations once warmed up", allocationCount);
+
+    return success;
+}
+
+// Reductions of operands read from a stream should match the same operands on the command line,
+// including across chunks, and whichever command line operands precede them.
+bool VerifyStreamedOperands()
+{
+    bool success = true;
+
+    // Long enough to span a few chunks, with an odd count so the last chunk is partial.
+    std::string streamedOperands;
+    for (uint32_t i = 0; i < 2 * g_reductionChunkSize + 1001; ++i)
+    {
+        if (i > 0)
+        {
+            streamedOperands.push_back((i % 11 == 0) ? '\n' : ' ');
+        }
+        int32_t const value = int32_t(i * 7 % 13) - 6;
+        streamedOperands.append(std::to_string(value)).append((i % 3 == 0) ? ".25" : ".5");
+    }
+    std::string commandLineOperands = streamedOperands;
+    std::replace(commandLineOperands.begin(), commandLineOperands.end(), '\n', ' ');
+
+    std::string_view const operations[] =
+    {
+        "float16 add",
+        "float16 add 3.5 1.25",
+        "float16 sum kahan add",
+        "float16 accumulate float32 add",
+        "float16 accumulate float32 dot",
+        "float32 mul",
+        "float16 sub 1000",
+    };
+
+    // The result is all after the last heading, the operand listings differing by design.
+    auto getResult = [](std::string_view output) -> std::string_view
+    {
+        size_t const resultIndex = output.rfind("Result from");
+        return (resultIndex == std::string_view::npos) ? std::string_view{} : output.substr(resultIndex);
+    };
+
+    EvaluationContext context;
+    std::string stringOutput, expectedOutput;
+    size_t resultMismatchCount = 0;
+    for (std::string_view operation : operations)
+    {
+        FILE* inputStream = tmpfile();
+        if (inputStream == nullptr)
+        {
+            ++resultMismatchCount;
+            continue;
+        }
+        fwrite(streamedOperands.data(), 1, streamedOperands.size(), inputStream);
+        rewind(inputStream);
+        context.inputStream = inputStream;
+
+        expectedOutput.clear();
+        MainImplementation(std::string(operation) + " " + commandLineOperands, /*out*/ expectedOutput);
+        stringOutput.clear();
+        MainImplementation(std::string(operation) + " stream", /*out*/ stringOutput, context);
+        resultMismatchCount += (getResult(stringOutput).empty() || getResult(stringOutput) != getResult(expectedOutput));
+        fclose(inputStream);
+    }
+    success &= PrintMismatchResult("streamed reductions match the command line", resultMismatchCount);
+
+    return success;
+}
+
+#if __linux__
+// Clients connecting at once should each get the answers to their own lines, in order, the same
+// as evaluating them directly, with the workers evaluating concurrently.
+bool VerifySocketServer()
+{
+    bool success = true;
+
+    // Long enough to reduce in several chunks.
+    std::string longCommandLine = "float32 sum pairwise add";
+    for (uint32_t i = 0; i < 3 * g_reductionChunkSize; ++i)
+    {
+        longCommandLine.push_back(' ');
+        longCommandLine.push_back(char('0' + i % 7));
+    }
+
+    // Each client sends its own mix, the last line without a line ending.
+    constexpr uint32_t clientCount = 6;
+    std::string requests[clientCount];
+    std::string expectedResponses[clientCount];
+    for (uint32_t client = 0; client < clientCount; ++client)
+    {
+        std::string const commandLines[] =
+        {
+            "float32 add 1 " + std::to_string(client),
+            (client % 2 == 0) ? longCommandLine : "bogus",
+            "float16 accumulate float32 dot 1 2 3 " + std::to_string(client),
+            "uint8 " + std::to_string(client * 40),
+        };
+        for (std::string const& commandLine : commandLines)
+        {
+            requests[client].append(commandLine).push_back('\n');
+            std::string stringOutput;
+            int const exitCode = MainImplementation(commandLine, /*out*/ stringOutput);
+            expectedResponses[client].append(std::to_string(exitCode)).append(" ").append(std::to_string(stringOutput.size())).append("\n");
+            expectedResponses[client].append(stringOutput);
+        }
+        requests[client].pop_back();
+    }
+
+    std::string const socketPath = (std::filesystem::temp_directory_path() / "binums_test.sock").string();
+    SocketServer server;
+    std::string errorMessage;
+    if (server.Start(socketPath.c_str(), /*workerCount*/ 3, /*out*/ errorMessage) != EXIT_SUCCESS)
+    {
+        printf("%s\n", errorMessage.c_str());
+        PrintMismatchResult("socket server started", 1);
+        return false;
+    }
+
+    std::string responses[clientCount];
+    std::vector<std::thread> clients;
+    for (uint32_t client = 0; client < clientCount; ++client)
+    {
+        clients.emplace_back(
+            [&, client]()
+            {
+                int const clientSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+                sockaddr_un address = {};
+                address.sun_family = AF_UNIX;
+                strcpy(address.sun_path, socketPath.c_str());
+                if (clientSocket < 0 || connect(clientSocket, reinterpret_cast<sockaddr const*>(&address), sizeof(address)) != 0)
+                {
+                    return;
+                }
+
+                // Send in uneven pieces, so lines arrive split across reads.
+                std::string_view request = requests[client];
+                for (size_t pieceByteSize = 7 + client; !request.empty(); pieceByteSize *= 3)
+                {
+                    std::string_view const piece = request.substr(0, pieceByteSize);
+                    if (send(clientSocket, piece.data(), piece.size(), MSG_NOSIGNAL) != ssize_t(piece.size()))
+                    {
+                        break;
+                    }
+                    request.remove_prefix(piece.size());
+                }
+                shutdown(clientSocket, SHUT_WR);
+
+                char readBuffer[4096];
+                for (ssize_t readByteCount; (readByteCount = recv(clientSocket, readBuffer, sizeof(readBuffer), 0)) > 0; )
+                {
+                    responses[client].append(readBuffer, size_t(readByteCount));
+                }
+                close(clientSocket);
+            }
+        );
+    }
+    for (std::thread& client : clients)
+    {
+        client.join();
+    }
+    server.Stop();
+    server.Wait();
+
+    size_t responseMismatchCount = 0;
+    for (uint32_t client = 0; client < clientCount; ++client)
+    {
+        responseMismatchCount += (responses[client] != expectedResponses[client]);
+    }
+    success &= PrintMismatchResult("socket server responses", responseMismatchCount);
+    success &= PrintMismatchResult("socket server removes its socket", std::filesystem::exists(socketPath));
+
+    // A client that keeps sending without reading its answers must hold up neither the only worker
+    // nor stopping the server.
+    if (server.Start(socketPath.c_str(), /*workerCount*/ 1, /*out*/ errorMessage) != EXIT_SUCCESS)
+    {
+        printf("%s\n", errorMessage.c_str());
+        PrintMismatchResult("socket server restarted", 1);
+        return false;
+    }
+
+    auto connectToServer = [&]() -> int
+    {
+        int const clientSocket = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        sockaddr_un address = {};
+        address.sun_family = AF_UNIX;
+        strcpy(address.sun_path, socketPath.c_str());
+        if (clientSocket >= 0 && connect(clientSocket, reinterpret_cast<sockaddr const*>(&address), sizeof(address)) != 0)
+        {
+            close(clientSocket);
+            return -1;
+        }
+        return clientSocket;
+    };
+
+    // Send until the server stops taking more, as its answers back up.
+    int const floodingSocket = connectToServer();
+    std::string floodingRequests;
+    for (uint32_t i = 0; i < 20000; ++i)
+    {
+        floodingRequests.append("float32 add 1 2\n");
+    }
+    std::string_view unsentRequests = floodingRequests;
+    auto const floodingDeadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+    while (floodingSocket >= 0 && !unsentRequests.empty() && std::chrono::steady_clock::now() < floodingDeadline)
+    {
+        ssize_t const sentByteCount = send(floodingSocket, unsentRequests.data(), unsentRequests.size(), MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (sentByteCount > 0)
+        {
+            unsentRequests.remove_prefix(size_t(sentByteCount));
+        }
+        else if (errno != EAGAIN && errno != EWOULDBLOCK)
+        {
+            break;
+        }
+        else
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    std::string stringOutput;
+    int const exitCode = MainImplementation("float32 add 1 2", /*out*/ stringOutput);
+    std::string const expectedResponse = std::to_string(exitCode) + " " + std::to_string(stringOutput.size()) + "\n" + stringOutput;
+    std::string response;
+    int const clientSocket = connectToServer();
+    if (clientSocket >= 0)
+    {
+        timeval const timeout = {.tv_sec = 5, .tv_usec = 0};
+        setsockopt(clientSocket, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        send(clientSocket, "float32 add 1 2\n", 16, MSG_NOSIGNAL);
+        shutdown(clientSocket, SHUT_WR);
+        char readBuffer[4096];
+        for (ssize_t readByteCount; (readByteCount = recv(clientSocket, readBuffer, sizeof(readBuffer), 0)) > 0; )
+        {
+            response.append(readBuffer, size_t(readByteCount));
+        }
+        close(clientSocket);
+    }
+    success &= PrintMismatchResult("socket server answers past a client not reading", response != expectedResponse);
+
+    auto const stopBegin = std::chrono::steady_clock::now();
+    server.Stop();
+    server.Wait();
+    success &= PrintMismatchResult("socket server stops past a client not reading", std::chrono::steady_clock::now() - stopBegin > std::chrono::seconds(2));
+    if (floodingSocket >= 0)
+    {
+        close(floodingSocket);
+    }
+
+    return success;
+}
+#endif
+
+// The C interface should give the same results as the command line, and report misuse as statuses.
+bool VerifyCInterface()
+{
+    bool success = true;
+
+    BINUMS_CONTEXT* context = nullptr;
+    if (BiNumsCreateContext(&context) != BINUMS_STATUS_SUCCESS)
+    {
+        PrintMismatchResult("C interface context", 1);
+        return false;
+    }
+
+    // Evaluating, first into a buffer too small for the output.
+    {
+        size_t mismatchCount = 0;
+        std::string_view const commandLine = "float32 add 1 2";
+        std::string expectedOutput;
+        MainImplementation(commandLine, /*out*/ expectedOutput);
+
+        std::string output(expectedOutput.size(), '\0');
+        size_t outputByteSize = 0;
+        mismatchCount += BiNumsEvaluate(context, commandLine.data(), commandLine.size(), output.data(), 10, &outputByteSize) != BINUMS_STATUS_BUFFER_TOO_SMALL;
+        mismatchCount += outputByteSize != expectedOutput.size();
+        mismatchCount += BiNumsEvaluate(context, commandLine.data(), commandLine.size(), output.data(), output.size(), &outputByteSize) != BINUMS_STATUS_SUCCESS;
+        mismatchCount += output != expectedOutput;
+        mismatchCount += BiNumsEvaluate(nullptr, commandLine.data(), commandLine.size(), output.data(), output.size(), &outputByteSize) != BINUMS_STATUS_SUCCESS;
+        mismatchCount += output != expectedOutput;
+
+        std::string_view const failingCommandLines[] = {"bogus", "float32 add stream"};
+        for (std::string_view failingCommandLine : failingCommandLines)
+        {
+            output.assign(256, '\0');
+            mismatchCount += BiNumsEvaluate(context, failingCommandLine.data(), failingCommandLine.size(), output.data(), output.size(), &outputByteSize) != BINUMS_STATUS_FAILURE;
+        }
+        success &= PrintMismatchResult("C interface evaluate", mismatchCount);
+    }
+
+    // Converting.
+    {
+        float const float32Values[] = {1.0f, 2.5f, -3.0f, 65504.0f, 0.5f};
+        uint16_t const expectedFloat16Values[] = {0x3C00, 0x4100, 0xC200, 0x7BFF, 0x3800};
+        uint16_t float16Values[std::size(float32Values)] = {};
+        size_t mismatchCount = 0;
+        mismatchCount += BiNumsConvert(BINUMS_ELEMENT_TYPE_FLOAT32, BINUMS_ELEMENT_TYPE_FLOAT16, float32Values, float16Values, std::size(float32Values)) != BINUMS_STATUS_SUCCESS;
+        mismatchCount += !std::equal(std::begin(float16Values), std::end(float16Values), std::begin(expectedFloat16Values));
+        mismatchCount += BiNumsConvert(BINUMS_ELEMENT_TYPE_UNDEFINED, BINUMS_ELEMENT_TYPE_FLOAT16, float32Values, float16Values, 1) != BINUMS_STATUS_INVALID_ARGUMENT;
+        mismatchCount += BiNumsConvert(BINUMS_ELEMENT_TYPE_FLOAT32, BINUMS_ELEMENT_TYPE_FLOAT16, nullptr, float16Values, 1) != BINUMS_STATUS_INVALID_ARGUMENT;
+
+        // The internal string and complex types are not in the public enum.
+        for (uint32_t internalType : {8u, 14u, 15u, 22u})
+        {
+            mismatchCount += BiNumsConvert(BINUMS_ELEMENT_TYPE(internalType), BINUMS_ELEMENT_TYPE_FLOAT16, float32Values, float16Values, 1) != BINUMS_STATUS_INVALID_ARGUMENT;
+        }
+        success &= PrintMismatchResult("C interface convert", mismatchCount);
+    }
+
+    // Reducing an array long enough for several chunks should match the command line's result.
+    {
+        std::vector<uint16_t> float16Values(3 * g_reductionChunkSize + 101);
+        std::string commandLineOperands;
+        for (size_t i = 0; i < float16Values.size(); ++i)
+        {
+            float const value = float(int(i % 9) - 4) * 0.25f;
+            BiNumsConvert(BINUMS_ELEMENT_TYPE_FLOAT32, BINUMS_ELEMENT_TYPE_FLOAT16, &value, &float16Values[i], 1);
+            commandLineOperands.append(" ").append(std::to_string(value));
+        }
+
+        struct ReduceCase
+        {
+            char const* commandLinePrefix;
+            BINUMS_OPERATION operation;
+            BINUMS_REDUCE_OPTIONS options;
+        };
+        ReduceCase const reduceCases[] =
+        {
+            {"float16 add", BINUMS_OPERATION_ADD, BINUMS_REDUCE_OPTIONS_DEFAULT},
+            {"float16 sum kahan add", BINUMS_OPERATION_ADD, {sizeof(BINUMS_REDUCE_OPTIONS), BINUMS_ELEMENT_TYPE_UNDEFINED, 0, BINUMS_SUMMATION_MODE_KAHAN, 0}},
+            {"float16 accumulate float32 dot", BINUMS_OPERATION_DOT, {sizeof(BINUMS_REDUCE_OPTIONS), BINUMS_ELEMENT_TYPE_FLOAT32, 0, BINUMS_SUMMATION_MODE_SEQUENTIAL, 0}},
+            {"float16 sub", BINUMS_OPERATION_SUBTRACT, BINUMS_REDUCE_OPTIONS_DEFAULT},
+        };
+
+        size_t mismatchCount = 0;
+        for (ReduceCase const& reduceCase : reduceCases)
+        {
+            uint16_t result = 0;
+            mismatchCount += BiNumsReduce(context, reduceCase.operation, BINUMS_ELEMENT_TYPE_FLOAT16, float16Values.data(), float16Values.size(), &reduceCase.options, &result) != BINUMS_STATUS_SUCCESS;
+
+            // The command line prints the result's bits last, like "float16 -2.5 (0xC100)".
+            std::string output;
+            MainImplementation(reduceCase.commandLinePrefix + commandLineOperands, /*out*/ output);
+            char expectedBits[16];
+            snprintf(expectedBits, sizeof(expectedBits), "(0x%04X)", result);
+            mismatchCount += output.rfind(expectedBits) == std::string::npos || output.rfind(expectedBits) < output.rfind("Result from");
+        }
+
+        uint16_t result = 0;
+        mismatchCount += BiNumsReduce(context, BINUMS_OPERATION(8), BINUMS_ELEMENT_TYPE_FLOAT16, float16Values.data(), 1, nullptr, &result) != BINUMS_STATUS_INVALID_ARGUMENT;
+
+        // A struct from an earlier, smaller header defaults the fields past its size, ignoring the Kahan
+        // summation beyond it here, so it matches the default add.
+        uint16_t defaultResult = 0;
+        BINUMS_REDUCE_OPTIONS smallerOptions = {offsetof(BINUMS_REDUCE_OPTIONS, summationMode), BINUMS_ELEMENT_TYPE_UNDEFINED, 0, BINUMS_SUMMATION_MODE_KAHAN, 0};
+        mismatchCount += BiNumsReduce(context, BINUMS_OPERATION_ADD, BINUMS_ELEMENT_TYPE_FLOAT16, float16Values.data(), float16Values.size(), nullptr, &defaultResult) != BINUMS_STATUS_SUCCESS;
+        mismatchCount += BiNumsReduce(context, BINUMS_OPERATION_ADD, BINUMS_ELEMENT_TYPE_FLOAT16, float16Values.data(), float16Values.size(), &smallerOptions, &result) != BINUMS_STATUS_SUCCESS;
+        mismatchCount += result != defaultResult;
+        smallerOptions.structByteSize = 0;
+        mismatchCount += BiNumsReduce(context, BINUMS_OPERATION_ADD, BINUMS_ELEMENT_TYPE_FLOAT16, float16Values.data(), 1, &smallerOptions, &result) != BINUMS_STATUS_INVALID_ARGUMENT;
+        mismatchCount += BiNumsReduce(nullptr, BINUMS_OPERATION_ADD, BINUMS_ELEMENT_TYPE_FLOAT16, float16Values.data(), 2, nullptr, &result) != BINUMS_STATUS_SUCCESS;
+        success &= PrintMismatchResult("C interface reduce", mismatchCount);
+    }
+
+    BiNumsDestroyContext(context);
+
+    return success;
+}
+
+// Compare the vectorized generic conversion against the scalar ConvertRawFloatType for every pair of formats
+// and rounding mode, and the rounding itself (subnormals included) against the hardware and the other codecs.
+bool VerifyRawFloatTypeArray()
+{
+    using namespace FloatNumberDetails;
+
+    bool success = true;
+
+    auto ForEachDefinition = [](auto&& function)
+    {
+        function("float8e4m3", Float8f3e4s1Definition{});
+        function("float8e5m2", Float8f2e5s1Definition{});
+        function("float16", Float16f10e5s1Definition{});
+        function("float16 in uint32", Float16Definition{});
+        function("bfloat16", Float16f7e8s1Definition{});
+        function("float32", Float32Definition{});
+        function("float64", Float64Definition{});
+    };
+
+    ForEachDefinition([&]<typename SourceDefinition>(char const* sourceName, SourceDefinition)
+    {
+        using SourceType = typename SourceDefinition::baseIntegerType;
+
+        // Every value of 8 and 16-bit formats, else a sweep of bit patterns.
+        std::vector<SourceType> sourceValues;
+        if constexpr (SourceDefinition::totalBitCount <= 16)
+        {
+            for (uint32_t bits = 0; bits < (1u << SourceDefinition::totalBitCount); ++bits)
+            {
+                sourceValues.push_back(SourceType(bits));
+            }
+        }
+        else
+        {
+            for (uint64_t i = 0; i < 65536; ++i)
+            {
+                uint64_t const bits = (SourceDefinition::totalBitCount == 32) ? i * 65521 : i * 0x9E3779B97F4A7C15;
+                sourceValues.push_back(SourceType(bits));
+            }
+        }
+
+        size_t mismatchCount = 0;
+        ForEachDefinition([&]<typename TargetDefinition>(char const*, TargetDefinition)
+        {
+            using TargetType = typename TargetDefinition::baseIntegerType;
+
+            std::vector<TargetType> targetValues(sourceValues.size());
+            auto CountMismatches = [&]<RoundingMode roundingMode>()
+            {
+                ConvertRawFloatTypeArray<SourceDefinition, TargetDefinition, roundingMode>(sourceValues.data(), /*out*/ targetValues.data(), sourceValues.size());
+                for (size_t i = 0; i < sourceValues.size(); ++i)
+                {
+                    mismatchCount += ConvertRawFloatType<SourceDefinition, TargetDefinition, roundingMode>(sourceValues[i]) != targetValues[i];
+                }
+            };
+            CountMismatches.template operator()<RoundingMode::NearestEven>();
+            CountMismatches.template operator()<RoundingMode::TowardZero>();
+            CountMismatches.template operator()<RoundingMode::Up>();
+            CountMismatches.template operator()<RoundingMode::Down>();
+        });
+        success &= PrintMismatchResult(std::string(sourceName) + " to every format array", mismatchCount);
+    });
+
+    // bfloat16 has the same exponent as float32, so the generic conversion must match the bfloat16 codec.
+    size_t nearestEvenMismatchCount = 0, towardZeroMismatchCount = 0;
+    for (uint64_t bits = 0; bits <= 0xFFFFFFFF; bits += 4099)
+    {
+        float const value = std::bit_cast<float>(uint32_t(bits));
+        nearestEvenMismatchCount += ConvertRawFloatType<Float32Definition, Float16f7e8s1Definition>(uint32_t(bits)) != ConvertFloat32ToBfloat16Bits(value);
+        towardZeroMismatchCount += ConvertRawFloatType<Float32Definition, Float16f7e8s1Definition, RoundingMode::TowardZero>(uint32_t(bits)) != ConvertFloat32ToBfloat16Bits(value, Bfloat16Rounding::TowardZero);
+    }
+    success &= PrintMismatchResult("float32 to bfloat16 rounding to nearest even", nearestEvenMismatchCount);
+    success &= PrintMismatchResult("float32 to bfloat16 rounding toward zero", towardZeroMismatchCount);
+
+    // float32 to float16 against the F16C compatible codec.
+    // Rounding up or down is the next value away from zero after truncation, when inexact, by sign.
+    nearestEvenMismatchCount = 0;
+    size_t directedMismatchCount = 0;
+    for (uint64_t bits = 0; bits <= 0xFFFFFFFF; bits += 4099)
+    {
+        uint32_t const absoluteBits = uint32_t(bits) & 0x7FFFFFFF;
+        float const value = std::bit_cast<float>(uint32_t(bits));
+        nearestEvenMismatchCount += ConvertRawFloatType<Float32Definition, Float16f10e5s1Definition>(uint32_t(bits)) != ConvertFloat32ToFloat16Bits(value);
+
+        if (absoluteBits <= 0x7F800000)
+        {
+            uint16_t const towardZero = ConvertRawFloatType<Float32Definition, Float16f10e5s1Definition, RoundingMode::TowardZero>(uint32_t(bits));
+            bool const isInexact = ConvertFloat16BitsToFloat32(towardZero) != value;
+            bool const isNegative = std::signbit(value);
+            uint16_t const up = towardZero + (isInexact && !isNegative);
+            uint16_t const down = towardZero + (isInexact && isNegative);
+            directedMismatchCount += ConvertRawFloatType<Float32Definition, Float16f10e5s1Definition, RoundingMode::Up>(uint32_t(bits)) != up;
+            directedMismatchCount += ConvertRawFloatType<Float32Definition, Float16f10e5s1Definition, RoundingMode::Down>(uint32_t(bits)) != down;
+        }
+    }
+    success &= PrintMismatchResult("float32 to float16 rounding to nearest even", nearestEvenMismatchCount);
+    success &= PrintMismatchResult("float32 to float16 rounding up and down", directedMismatchCount);
+
+    // The hardware float32 <-> float64 conversions, whose subnormal range covers the other's normal range.
+    size_t mismatchCount = 0;
+    for (uint64_t bits = 0; bits <= 0xFFFFFFFF; bits += 4099)
+    {
+        float const value = std::bit_cast<float>(uint32_t(bits));
+        mismatchCount += ConvertRawFloatType<Float32Definition, Float64Definition>(uint32_t(bits)) != std::bit_cast<uint64_t>(double(value));
+    }
+    for (uint64_t i = 0; i < (1u << 20); ++i)
+    {
+        // Exponents spanning float32 subnormals up through overflow, with arbitrary sign and fraction bits.
+        uint64_t const bits = ((i * 0x9E3779B97F4A7C15) & 0x800FFFFFFFFFFFFF) | (uint64_t(0x360 + (i % 0x140)) << 52);
+        double const value = std::bit_cast<double>(bits);
+        mismatchCount += ConvertRawFloatType<Float64Definition, Float32Definition>(bits) != std::bit_cast<uint32_t>(float(value));
+    }
+    success &= PrintMismatchResult("float32 <-> float64 against the hardware", mismatchCount);
+
+    // Decoding every float16 and float8 value, and float8 encoding against its threshold tables.
+    mismatchCount = 0;
+    for (uint32_t bits = 0; bits <= 0xFFFF; ++bits)
+    {
+        mismatchCount += ConvertRawFloatType<Float16f10e5s1Definition, Float32Definition>(uint16_t(bits)) != std::bit_cast<uint32_t>(ConvertFloat16BitsToFloat32(uint16_t(bits)));
+    }
+    auto CountFloat8Mismatches = [&]<typename Float8Definition>(Float8Definition)
+    {
+        for (uint32_t bits = 0; bits <= 0xFF; ++bits)
+        {
+            float const decoded = g_float8CodecTables<Float8Definition>.decode[bits];
+            mismatchCount += ConvertRawFloatType<Float8Definition, Float32Definition>(uint8_t(bits)) != std::bit_cast<uint32_t>(decoded);
+        }
+        for (uint64_t bits = 0; bits <= 0xFFFFFFFF; bits += 4099)
+        {
+            float const value = std::bit_cast<float>(uint32_t(bits));
+            if (!std::isnan(value)) // The tables use a single NaN rather than keeping the payload.
+            {
+                mismatchCount += ConvertRawFloatType<Float32Definition, Float8Definition>(uint32_t(bits)) != ConvertFloat32ToFloat8Bits<Float8Definition>(value);
+            }
+        }
+    };
+    CountFloat8Mismatches(Float8f3e4s1Definition{});
+    CountFloat8Mismatches(Float8f2e5s1Definition{});
+    success &= PrintMismatchResult("float16 and float8 against their codecs", mismatchCount);
+
+    return success;
+}
+
+
+// An independent reference for the narrow float formats, to check every conversion against. Each
+// value is decoded with ldexp from the field layout, and rounding searches those values for the
+// nearest one, ties going to the even code. Overflow becomes infinity, or in formats without it
+// (float8e4m3), saturates to the largest finite value, as infinity itself does.
+class ReferenceFloatFormat
+{
+public:
+    ReferenceFloatFormat(uint32_t fractionBitCount, uint32_t exponentBitCount, bool hasInfinity)
+    :   fractionBitCount_(fractionBitCount),
+        exponentBitCount_(exponentBitCount),
+        hasInfinity_(hasInfinity),
+        signMask_(1u << (fractionBitCount + exponentBitCount))
+    {
+        // The largest finite code is right below infinity, or else right below the only NaN.
+        uint32_t const exponentMask = ((1u << exponentBitCount) - 1) << fractionBitCount;
+        maxFiniteCode_ = hasInfinity ? exponentMask - 1 : (signMask_ - 1) - 1;
+
+        for (uint32_t code = 0; code <= maxFiniteCode_; ++code)
+        {
+            magnitudes_.push_back(Decode(code));
+        }
+
+        // Infinity follows as if it were the next value up, so the largest finite value plus half
+        // a step rounds to it, including the tie (since the largest finite code is odd).
+        if (hasInfinity)
+        {
+            magnitudes_.push_back(2 * magnitudes_[maxFiniteCode_] - magnitudes_[maxFiniteCode_ - 1]);
+        }
+    }
+
+    uint32_t GetSignMask() const noexcept { return signMask_; }
+
+    bool IsNan(uint32_t code) const noexcept
+    {
+        return (code & ~signMask_) > maxFiniteCode_ + (hasInfinity_ ? 1 : 0);
+    }
+
+    double Decode(uint32_t code) const noexcept
+    {
+        uint32_t const magnitudeCode = code & ~signMask_;
+        double value = 0;
+        if (IsNan(code))
+        {
+            value = std::numeric_limits<double>::quiet_NaN();
+        }
+        else if (magnitudeCode > maxFiniteCode_)
+        {
+            value = std::numeric_limits<double>::infinity();
+        }
+        else
+        {
+            int32_t const bias = (1 << (exponentBitCount_ - 1)) - 1;
+            uint32_t const exponentField = magnitudeCode >> fractionBitCount_;
+            uint32_t const fraction = magnitudeCode & ((1u << fractionBitCount_) - 1);
+            value = (exponentField == 0)
+                  ? std::ldexp(double(fraction), 1 - bias - int32_t(fractionBitCount_))
+                  : std::ldexp(double(fraction | (1u << fractionBitCount_)), int32_t(exponentField) - bias - int32_t(fractionBitCount_));
+        }
+        return (code & signMask_) ? -value : value;
+    }
+
+    // Round to the nearest code, searching from the cursor, so increasing values (like a sweep of
+    // bit patterns) take a step or two each. NaN rounds to a NaN of the same sign.
+    uint32_t Round(double value, /*inout*/ size_t& cursor) const
+    {
+        uint32_t const sign = std::signbit(value) ? signMask_ : 0;
+        if (std::isnan(value))
+        {
+            return sign | (signMask_ - 1); // All ones is NaN in every format here.
+        }
+
+        double const magnitude = std::abs(value);
+        if (cursor >= magnitudes_.size() || magnitudes_[cursor] > magnitude)
+        {
+            cursor = size_t(std::upper_bound(magnitudes_.begin(), magnitudes_.end(), magnitude) - magnitudes_.begin()) - 1;
+        }
+        while (cursor + 1 < magnitudes_.size() && magnitudes_[cursor + 1] <= magnitude)
+        {
+            ++cursor;
+        }
+
+        // The midpoint of two adjacent values is exact in double, having few significant bits.
+        uint32_t code = uint32_t(cursor);
+        if (cursor + 1 < magnitudes_.size())
+        {
+            double const midpoint = (magnitudes_[cursor] + magnitudes_[cursor + 1]) / 2;
+            if (magnitude > midpoint || (magnitude == midpoint && (code & 1)))
+            {
+                ++code;
+            }
+        }
+        return sign | code;
+    }
+
+    // Equal codes, or NaN's of the same sign, since formats differ in which NaN they produce.
+    bool Matches(uint32_t expectedCode, uint32_t actualCode) const noexcept
+    {
+        return expectedCode == actualCode
+            || (IsNan(expectedCode) && IsNan(actualCode) && ((expectedCode ^ actualCode) & signMask_) == 0);
+    }
+
+private:
+    uint32_t fractionBitCount_;
+    uint32_t exponentBitCount_;
+    bool hasInfinity_;
+    uint32_t signMask_;
+    uint32_t maxFiniteCode_ = 0;
+    std::vector<double> magnitudes_; // Of every code from zero up through the largest finite (and infinity).
+};
+
+// Like ReferenceFloatFormat::Matches, for float32 results, which must be exact.
+bool Float32Matches(double expectedValue, float actualValue)
+{
+    return (std::isnan(expectedValue) && std::isnan(actualValue) && std::signbit(expectedValue) == std::signbit(actualValue))
+        || std::bit_cast<uint32_t>(float(expectedValue)) == std::bit_cast<uint32_t>(actualValue);
+}
+
+// Counts a conversion path's mismatches across threads, keeping the first for the report.
+struct ConversionPathMismatches
+{
+    std::atomic<size_t> count = 0;
+    std::mutex mutex;
+    std::string firstMismatch;
+
+    void Add(size_t mismatchCount, uint32_t input, uint32_t expected, uint32_t actual)
+    {
+        count.fetch_add(mismatchCount, std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(mutex);
+        if (firstMismatch.empty())
+        {
+            firstMismatch = GetFormatted("first at input 0x%08X, expected 0x%08X, got 0x%08X", input, expected, actual);
+        }
+    }
+};
+
+template <typename Code>
+struct EncodePath
+{
+    char const* name;
+    void (*encode)(float const* input, /*out*/ Code* output, size_t count);
+    bool isSupported;
+};
+
+template <typename Code>
+struct DecodePath
+{
+    char const* name;
+    void (*decode)(Code const* input, /*out*/ float* output, size_t count);
+    bool isSupported;
+};
+
+// The format's encodings and decodings to and from float32, from the scalar codec through each
+// vectorized kernel to the casts of the engine.
+template <typename Code>
+struct ExhaustiveFloatFormat
+{
+    char const* name;
+    ElementType elementType;
+    ReferenceFloatFormat reference;
+    std::vector<EncodePath<Code>> encodePaths;
+    std::vector<DecodePath<Code>> decodePaths;
+};
+
+template <typename FloatDefinition, typename Code>
+void AddGenericConversionPaths(/*inout*/ ExhaustiveFloatFormat<Code>& format)
+{
+    using namespace FloatNumberDetails;
+
+    format.encodePaths.push_back({"generic", [](float const* input, Code* output, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            output[i] = ConvertRawFloatType<Float32Definition, FloatDefinition>(std::bit_cast<uint32_t>(input[i]));
+        }
+    }, true});
+    format.encodePaths.push_back({"generic array", [](float const* input, Code* output, size_t count)
+    {
+        ConvertRawFloatTypeArray<Float32Definition, FloatDefinition>(reinterpret_cast<uint32_t const*>(input), /*out*/ output, count);
+    }, true});
+    format.decodePaths.push_back({"generic array", [](Code const* input, float* output, size_t count)
+    {
+        ConvertRawFloatTypeArray<FloatDefinition, Float32Definition>(input, /*out*/ reinterpret_cast<uint32_t*>(output), count);
+    }, true});
+}
+
+template <ElementType elementType, typename Code>
+void AddCastConversionPaths(/*inout*/ ExhaustiveFloatFormat<Code>& format)
+{
+    format.encodePaths.push_back({"cast", [](float const* input, Code* output, size_t count)
+    {
+        CastElementTypeArray(ElementType::Float32, elementType, input, /*out*/ output, count);
+    }, true});
+    format.decodePaths.push_back({"cast", [](Code const* input, float* output, size_t count)
+    {
+        CastElementTypeArray(elementType, ElementType::Float32, input, /*out*/ output, count);
+    }, true});
+}
+
+ExhaustiveFloatFormat<uint16_t> MakeFloat16ExhaustiveFormat()
+{
+    [[maybe_unused]] CpuFeatures const& cpuFeatures = GetCpuFeatures();
+    ExhaustiveFloatFormat<uint16_t> format = {"float16", ElementType::Float16, ReferenceFloatFormat(10, 5, true), {}, {}};
+    format.encodePaths =
+    {
+        {"scalar", [](float const* input, uint16_t* output, size_t count) { for (size_t i = 0; i < count; ++i) output[i] = ConvertFloat32ToFloat16Bits(input[i]); }, true},
+#if BINUMS_X86
+        {"f16c", &ConvertFloat32ToFloat16ArrayF16c, cpuFeatures.f16c},
+        {"sse2", &ConvertFloat32ToFloat16ArraySse2, cpuFeatures.sse2},
+#endif
+        {"array", &ConvertFloat32ToFloat16Array, true},
+    };
+    format.decodePaths =
+    {
+        {"scalar", [](uint16_t const* input, float* output, size_t count) { for (size_t i = 0; i < count; ++i) output[i] = ConvertFloat16BitsToFloat32(input[i]); }, true},
+        {"table", [](uint16_t const* input, float* output, size_t count) { for (size_t i = 0; i < count; ++i) output[i] = ConvertFloat16BitsToFloat32ViaTable(input[i]); }, true},
+        {"half2float", [](uint16_t const* input, float* output, size_t count) { for (size_t i = 0; i < count; ++i) output[i] = half_float::detail::half2float<float>(input[i]); }, true},
+#if BINUMS_X86
+        {"f16c", &ConvertFloat16ToFloat32ArrayF16c, cpuFeatures.f16c},
+#endif
+        {"array", &ConvertFloat16ToFloat32Array, true},
+    };
+    AddGenericConversionPaths<FloatNumberDetails::Float16f10e5s1Definition>(/*inout*/ format);
+    AddCastConversionPaths<ElementType::Float16>(/*inout*/ format);
+    return format;
+}
+
+ExhaustiveFloatFormat<uint16_t> MakeBfloat16ExhaustiveFormat()
+{
+    [[maybe_unused]] CpuFeatures const& cpuFeatures = GetCpuFeatures();
+    ExhaustiveFloatFormat<uint16_t> format = {"bfloat16", ElementType::Bfloat16, ReferenceFloatFormat(7, 8, true), {}, {}};
+    format.encodePaths =
+    {
+        {"scalar", [](float const* input, uint16_t* output, size_t count) { for (size_t i = 0; i < count; ++i) output[i] = ConvertFloat32ToBfloat16Bits(input[i]); }, true},
+#if BINUMS_X86
+        {"avx512bf16", &ConvertFloat32ToBfloat16ArrayAvx512Bf16, cpuFeatures.avx512bf16},
+        {"avx2", &ConvertFloat32ToBfloat16ArrayAvx2<Bfloat16Rounding::NearestEven>, cpuFeatures.avx2},
+        {"sse2", &ConvertFloat32ToBfloat16ArraySse2<Bfloat16Rounding::NearestEven>, cpuFeatures.sse2},
+#endif
+        {"array", [](float const* input, uint16_t* output, size_t count) { ConvertFloat32ToBfloat16Array(input, /*out*/ output, count); }, true},
+    };
+    format.decodePaths =
+    {
+        {"scalar", [](uint16_t const* input, float* output, size_t count) { for (size_t i = 0; i < count; ++i) output[i] = ConvertBfloat16BitsToFloat32(input[i]); }, true},
+#if BINUMS_X86
+        {"sse2", &ConvertBfloat16ToFloat32ArraySse2, cpuFeatures.sse2},
+#endif
+        {"array", &ConvertBfloat16ToFloat32Array, true},
+    };
+    AddGenericConversionPaths<FloatNumberDetails::Float16f7e8s1Definition>(/*inout*/ format);
+    AddCastConversionPaths<ElementType::Bfloat16>(/*inout*/ format);
+    return format;
+}
+
+template <typename FloatDefinition, ElementType elementType>
+ExhaustiveFloatFormat<uint8_t> MakeFloat8ExhaustiveFormat(char const* name)
+{
+    [[maybe_unused]] CpuFeatures const& cpuFeatures = GetCpuFeatures();
+    ExhaustiveFloatFormat<uint8_t> format = {name, elementType, ReferenceFloatFormat(FloatDefinition::fractionBitCount, FloatDefinition::exponentBitCount, FloatDefinition::hasInfinity), {}, {}};
+    format.encodePaths =
+    {
+        {"scalar", [](float const* input, uint8_t* output, size_t count) { for (size_t i = 0; i < count; ++i) output[i] = FloatNumberDetails::ConvertFloat32ToFloat8Bits<FloatDefinition>(input[i]); }, true},
+#if BINUMS_X86
+        {"avx2", &ConvertFloat32ToFloat8ArrayAvx2<FloatDefinition>, cpuFeatures.avx2},
+#endif
+        {"array", &ConvertFloat32ToFloat8Array<FloatDefinition>, true},
+    };
+    format.decodePaths =
+    {
+        {"table", [](uint8_t const* input, float* output, size_t count) { for (size_t i = 0; i < count; ++i) output[i] = FloatNumberDetails::g_float8CodecTables<FloatDefinition>.decode[input[i]]; }, true},
+#if BINUMS_X86
+        {"avx2", &ConvertFloat8ToFloat32ArrayAvx2<FloatDefinition>, cpuFeatures.avx2},
+#endif
+        {"array", &ConvertFloat8ToFloat32Array<FloatDefinition>, true},
+    };
+    AddGenericConversionPaths<FloatDefinition>(/*inout*/ format);
+    AddCastConversionPaths<elementType>(/*inout*/ format);
+    return format;
+}
+
+// Check every value of the float8, float16, and bfloat16 formats through every conversion path
+// against the reference, and float32 to each of them for every float32 value (or a sample from
+// every exponent). The work is split across the shared thread pool, so the full float32 sweep
+// takes seconds on many cores.
+bool VerifyExhaustiveFloatConversions(bool shouldSweepAllFloat32Values)
+{
+    bool success = true;
+
+    auto PrintResult = [&](std::string const& title, ConversionPathMismatches const& mismatches)
+    {
+        success &= PrintMismatchResult(title, mismatches.count.load(), mismatches.firstMismatch);
+    };
+
+    ThreadPool& threadPool = ThreadPool::GetShared();
+    auto const startTime = std::chrono::steady_clock::now();
+    uint64_t sweptValueCount = 0;
+
+    // The float32 magnitudes go in runs sharing their upper bits (the exponent and top of the
+    // mantissa), each tried as positive and negative. The full sweep takes all of a run's lower
+    // bits, and otherwise a window of them, so the sample still covers every exponent. The windows
+    // take turns around the float8 ties (lower bits all zero), the bfloat16 tie, the float16 tie,
+    // and anywhere else.
+    constexpr uint32_t runLength = 1u << 16;
+    constexpr uint32_t runCount = 1u << 15;
+    uint32_t const sampleLength = shouldSweepAllFloat32Values ? runLength : 64;
+    auto GetSampleBegin = [&](uint32_t runIndex) -> uint32_t
+    {
+        if (shouldSweepAllFloat32Values)
+        {
+            return 0;
+        }
+        switch (runIndex % 4)
+        {
+        case 0:  return 0;
+        case 1:  return 0x8000 - sampleLength / 2;
+        case 2:  return (((runIndex / 4) & 7) << 13) | (0x1000 - sampleLength / 2);
+        default: return ((runIndex * 0x9E3779B1u) >> 16) & (runLength - sampleLength);
+        }
+    };
+
+    auto VerifyFormat = [&]<typename Code>(ExhaustiveFloatFormat<Code> const& format)
+    {
+        ReferenceFloatFormat const& reference = format.reference;
+
+        // Decode every code.
+        constexpr size_t codeCount = size_t(1) << (sizeof(Code) * 8);
+        std::vector<Code> codes(codeCount);
+        std::vector<float> decodedValues(codeCount);
+        for (size_t i = 0; i < codeCount; ++i)
+        {
+            codes[i] = Code(i);
+        }
+        for (DecodePath<Code> const& path : format.decodePaths)
+        {
+            if (!path.isSupported)
+            {
+                continue;
+            }
+
+            ConversionPathMismatches mismatches;
+            path.decode(codes.data(), /*out*/ decodedValues.data(), codeCount);
+            for (size_t i = 0; i < codeCount; ++i)
+            {
+                if (!Float32Matches(reference.Decode(uint32_t(i)), decodedValues[i]))
+                {
+                    mismatches.Add(1, uint32_t(i), std::bit_cast<uint32_t>(float(reference.Decode(uint32_t(i)))), std::bit_cast<uint32_t>(decodedValues[i]));
+                }
+            }
+            PrintResult(GetFormatted("%s to float32, all values, %s", format.name, path.name), mismatches);
+        }
+
+        // Encode runs of float32 values, each thread with its own buffers.
+        uint32_t const threadCount = threadPool.GetThreadCount(0);
+        std::vector<std::vector<float>> threadInputs(threadCount, std::vector<float>(sampleLength * 2));
+        std::vector<std::vector<Code>> threadExpectedCodes(threadCount, std::vector<Code>(sampleLength * 2));
+        std::vector<std::vector<Code>> threadActualCodes(threadCount, std::vector<Code>(sampleLength * 2));
+        std::vector<ConversionPathMismatches> pathMismatches(format.encodePaths.size());
+
+        threadPool.ParallelFor(runCount, 0, [&](size_t runIndex, uint32_t threadIndex)
+        {
+            std::vector<float>& inputs = threadInputs[threadIndex];
+            std::vector<Code>& expectedCodes = threadExpectedCodes[threadIndex];
+            std::vector<Code>& actualCodes = threadActualCodes[threadIndex];
+
+            uint32_t const firstMagnitudeBits = uint32_t(runIndex) * runLength + GetSampleBegin(uint32_t(runIndex));
+            size_t cursor = 0;
+            for (uint32_t i = 0; i < sampleLength; ++i)
+            {
+                float const value = std::bit_cast<float>(firstMagnitudeBits + i);
+                Code const expectedCode = Code(reference.Round(value, /*inout*/ cursor));
+                inputs[i] = value;
+                inputs[i + sampleLength] = -value;
+                expectedCodes[i] = expectedCode;
+                expectedCodes[i + sampleLength] = Code(expectedCode | reference.GetSignMask());
+            }
+
+            for (size_t pathIndex = 0; pathIndex < format.encodePaths.size(); ++pathIndex)
+            {
+                EncodePath<Code> const& path = format.encodePaths[pathIndex];
+                if (!path.isSupported)
+                {
+                    continue;
+                }
+
+                path.encode(inputs.data(), /*out*/ actualCodes.data(), inputs.size());
+                size_t mismatchCount = 0;
+                size_t firstMismatchIndex = 0;
+                for (size_t i = 0; i < inputs.size(); ++i)
+                {
+                    if (!reference.Matches(expectedCodes[i], actualCodes[i]))
+                    {
+                        firstMismatchIndex = (mismatchCount == 0) ? i : firstMismatchIndex;
+                        ++mismatchCount;
+                    }
+                }
+                if (mismatchCount > 0)
+                {
+                    pathMismatches[pathIndex].Add(mismatchCount, std::bit_cast<uint32_t>(inputs[firstMismatchIndex]), expectedCodes[firstMismatchIndex], actualCodes[firstMismatchIndex]);
+                }
+            }
+        });
+
+        sweptValueCount = uint64_t(runCount) * sampleLength * 2;
+        for (size_t pathIndex = 0; pathIndex < format.encodePaths.size(); ++pathIndex)
+        {
+            if (format.encodePaths[pathIndex].isSupported)
+            {
+                PrintResult(GetFormatted("float32 to %s, %llu values, %s", format.name, static_cast<unsigned long long>(sweptValueCount), format.encodePaths[pathIndex].name), pathMismatches[pathIndex]);
+            }
+        }
+    };
+
+    ExhaustiveFloatFormat<uint8_t> const float8e4m3Format = MakeFloat8ExhaustiveFormat<FloatNumberDetails::Float8f3e4s1Definition, ElementType::Float8m3e4s1>("float8e4m3");
+    ExhaustiveFloatFormat<uint8_t> const float8e5m2Format = MakeFloat8ExhaustiveFormat<FloatNumberDetails::Float8f2e5s1Definition, ElementType::Float8m2e5s1>("float8e5m2");
+    ExhaustiveFloatFormat<uint16_t> const float16Format = MakeFloat16ExhaustiveFormat();
+    ExhaustiveFloatFormat<uint16_t> const bfloat16Format = MakeBfloat16ExhaustiveFormat();
+    VerifyFormat(float8e4m3Format);
+    VerifyFormat(float8e5m2Format);
+    VerifyFormat(float16Format);
+    VerifyFormat(bfloat16Format);
+
+    // Cast every value of each format to each other format, and to float64, rounding the exact value.
+    auto VerifyCastsFrom = [&]<typename SourceCode>(ExhaustiveFloatFormat<SourceCode> const& source)
+    {
+        constexpr size_t codeCount = size_t(1) << (sizeof(SourceCode) * 8);
+        std::vector<SourceCode> codes(codeCount);
+        for (size_t i = 0; i < codeCount; ++i)
+        {
+            codes[i] = SourceCode(i);
+        }
+
+        auto VerifyCastsTo = [&]<typename TargetCode>(ExhaustiveFloatFormat<TargetCode> const& target)
+        {
+            std::vector<TargetCode> arrayCodes(codeCount);
+            CastElementTypeArray(source.elementType, target.elementType, codes.data(), /*out*/ arrayCodes.data(), codeCount);
+            ConversionPathMismatches mismatches;
+            size_t cursor = 0;
+            for (size_t i = 0; i < codeCount; ++i)
+            {
+                uint32_t const expectedCode = target.reference.Round(source.reference.Decode(uint32_t(i)), /*inout*/ cursor);
+                TargetCode scalarCode = 0;
+                CastElementType(source.elementType, target.elementType, &codes[i], /*out*/ &scalarCode);
+                for (TargetCode actualCode : {arrayCodes[i], scalarCode})
+                {
+                    if (!target.reference.Matches(expectedCode, actualCode))
+                    {
+                        mismatches.Add(1, uint32_t(i), expectedCode, actualCode);
+                    }
+                }
+            }
+            PrintResult(GetFormatted("%s to %s, all values, cast", source.name, target.name), mismatches);
+        };
+        VerifyCastsTo(float8e4m3Format);
+        VerifyCastsTo(float8e5m2Format);
+        VerifyCastsTo(float16Format);
+        VerifyCastsTo(bfloat16Format);
+
+        std::vector<double> float64Values(codeCount);
+        CastElementTypeArray(source.elementType, ElementType::Float64, codes.data(), /*out*/ float64Values.data(), codeCount);
+        ConversionPathMismatches mismatches;
+        for (size_t i = 0; i < codeCount; ++i)
+        {
+            double const expectedValue = source.reference.Decode(uint32_t(i));
+            bool const isMatch = (std::isnan(expectedValue) && std::isnan(float64Values[i]) && std::signbit(expectedValue) == std::signbit(float64Values[i]))
+                              || std::bit_cast<uint64_t>(expectedValue) == std::bit_cast<uint64_t>(float64Values[i]);
+            if (!isMatch)
+            {
+                mismatches.Add(1, uint32_t(i), uint32_t(std::bit_cast<uint64_t>(expectedValue) >> 32), uint32_t(std::bit_cast<uint64_t>(float64Values[i]) >> 32));
+            }
+        }
+        PrintResult(GetFormatted("%s to float64, all values, cast", source.name), mismatches);
+    };
+    VerifyCastsFrom(float8e4m3Format);
+    VerifyCastsFrom(float8e5m2Format);
+    VerifyCastsFrom(float16Format);
+    VerifyCastsFrom(bfloat16Format);
+
+    std::chrono::duration<double> const duration = std::chrono::steady_clock::now() - startTime;
+    printf("         (%llu float32 values per path, %.1f s on %u threads)\n", static_cast<unsigned long long>(sweptValueCount), duration.count(), threadPool.GetThreadCount(0));
+
+    return success;
+}
+
+
+int main(int argc, char* argv[])
+{
+    printf("*** This test suite is just a skeleton for now. ***\n\n");
+
+    auto exitCode = ParseCommandLineParameters(argc, argv);
+    if (exitCode != EXIT_SUCCESS)
+    {
+        return exitCode;
+    }
+
+    // Placeholder for real tests, which should be data driven in a test file,
+    // preferably JSON or XML (XML might simpler given all the new lines).
+    std::string stringOutput;
+    exitCode = MainImplementation("uint8 42 int8 -42 uint16 42 int16 -42 uint32 42 int32 -42 uint64 42 int64 -42 fixed12_12 -42.25 fixed16_16 -42.25 fixed8_24 -42.25 float16 -42.25 float32 -42.25 float64 -42.25", stringOutput);
+
+    uint32_t errorCount = 0;
+    auto CheckFailure = [&](bool success)
+    {
+        errorCount += success ? 0 : 1;
+    };
+
+    char const* expectedOutput =
+        "         uint8 42 (0x2A)\n"
+        "          int8 -42 (0xD6)\n"
+        "        uint16 42 (0x002A)\n"
+        "         int16 -42 (0xFFD6)\n"
+        "        uint32 42 (0x0000002A)\n"
+        "         int32 -42 (0xFFFFFFD6)\n"
+        "        uint64 42 (0x000000000000002A)\n"
+        "         int64 -42 (0xFFFFFFFFFFFFFFD6)\n"
+        "    fixed12_12 -42.25 (0xFD5C00)\n"
+        "    fixed16_16 -42.25 (0xFFD5C000)\n"
+        "     fixed8_24 -42.25 (0xD5C00000)\n"
+        "       float16 -42.25 (0xD148)\n"
+        "       float32 -42.25 (0xC2290000)\n"
+        "       float64 -42.25 (0xC045200000000000)\n"
+        ;
+    CheckFailure(CompareExpectedVsActual("All data types", stringOutput, expectedOutput));
+    CheckFailure(CompareExpectedVsActual("Expected failure case to verify output comparison", stringOutput, "Gibberish just to verify failure"));
+
+    // Narrowing float64 through float32 first would round twice, to 1 instead.
+    stringOutput.clear();
+    MainImplementation("float16 add float64 0x1.0020000001p0", stringOutput);
+    expectedOutput =
+        "Operands to add:\n"
+        "       float64 1.00048828125090949470177 (0x3FF0020000001000)\n"
+        "Result from add:\n"
+        "       float16 1.0009765625 (0x3C01)\n"
+        "\n"
+        ;
+    CheckFailure(CompareExpectedVsActual("Cast float64 to float16 with a single rounding", stringOutput, expectedOutput));
+
+    // 1*2 + 3*4 + 5 = 19 rounds to 20, since float8e5m2 steps by 4 there.
+    stringOutput.clear();
+    MainImplementation("float8e5m2 dot 1 2 3 4 5", stringOutput);
+    expectedOutput =
+        "Operands to dot:\n"
+        "    float8e5m2 1 (0x3C)\n"
+        "    float8e5m2 2 (0x40)\n"
+        "    float8e5m2 3 (0x42)\n"
+        "    float8e5m2 4 (0x44)\n"
+        "    float8e5m2 5 (0x45)\n"
+        "Result from dot:\n"
+        "    float8e5m2 20 (0x4D)\n"
+        "\n"
+        ;
+    CheckFailure(CompareExpectedVsActual("Numeric operations on float8", stringOutput, expectedOutput));
+
+    // 2048 + 1 + 1 is exact in float32 but rounds back to 2048 per step in float16.
+    stringOutput.clear();
+    MainImplementation("float16 accumulate float32 dot 2048 1 1 1 1 1 accumulate float32 block 1 dot 2048 1 1 1 1 1", stringOutput);
+    expectedOutput =
+        "Operands to dot:\n"
+        "       float16 2048 (0x6800)\n"
+        "       float16 1 (0x3C00)\n"
+        "       float16 1 (0x3C00)\n"
+        "       float16 1 (0x3C00)\n"
+        "       float16 1 (0x3C00)\n"
+        "       float16 1 (0x3C00)\n"
+        "Result from dot:\n"
+        "       float16 2050 (0x6801)\n"
+        "\n"
+        "Operands to dot:\n"
+        "       float16 2048 (0x6800)\n"
+        "       float16 1 (0x3C00)\n"
+        "       float16 1 (0x3C00)\n"
+        "       float16 1 (0x3C00)\n"
+        "       float16 1 (0x3C00)\n"
+        "       float16 1 (0x3C00)\n"
+        "Result from dot:\n"
+        "       float16 2048 (0x6800)\n"
+        "\n"
+        ;
+    CheckFailure(CompareExpectedVsActual("Accumulate float16 in float32, with and without blocks", stringOutput, expectedOutput));
+
+    // Each 2048 + 1 rounds back to 2048 in float16, unless the lost ones are carried along.
+    stringOutput.clear();
+    MainImplementation("float16 sum kahan add 2048 1 1 1 1 sum sequential add 2048 1 1 1 1", stringOutput);
+    expectedOutput =
+        "Operands to add:\n"
+        "       float16 2048 (0x6800)\n"
+        "       float16 1 (0x3C00)\n"
+        "       float16 1 (0x3C00)\n"
+        "       float16 1 (0x3C00)\n"
+        "       float16 1 (0x3C00)\n"
+        "Result from add:\n"
+        "       float16 2052 (0x6802)\n"
+        "\n"
+        "Operands to add:\n"
+        "       float16 2048 (0x6800)\n"
+        "       float16 1 (0x3C00)\n"
+        "       float16 1 (0x3C00)\n"
+        "       float16 1 (0x3C00)\n"
+        "       float16 1 (0x3C00)\n"
+        "Result from add:\n"
+        "       float16 2048 (0x6800)\n"
+        "\n"
+        ;
+    CheckFailure(CompareExpectedVsActual("Kahan summation in float16", stringOutput, expectedOutput));
+
+    // Truncate keeps each run of operands in its own type.
+    stringOutput.clear();
+    MainImplementation("trunc 7 1.5 float16 -2.5", stringOutput);
+    expectedOutput =
+        "Operands to truncate:\n"
+        "         int32 7 (0x00000007)\n"
+        "       float64 1.5 (0x3FF8000000000000)\n"
+        "       float16 -2.5 (0xC100)\n"
+        "Result from truncate:\n"
+        "         int32 7 (0x00000007)\n"
+        "       float64 1 (0x3FF0000000000000)\n"
+        "       float16 -2 (0xC000)\n"
+        "\n"
+        ;
+    CheckFailure(CompareExpectedVsActual("Truncate mixed types", stringOutput, expectedOutput));
+
+    // Operands of one type still form several runs when their printing flags differ, and every run counts.
+    stringOutput.clear();
+    MainImplementation("float32 add 1 2 dec 3 4 hex dot 1 2 dec 3 4", stringOutput);
+    expectedOutput =
+        "Operands to add:\n"
+        "       float32 1 (0x3F800000)\n"
+        "       float32 2 (0x40000000)\n"
+        "       float32 3 (1077936128)\n"
+        "       float32 4 (1082130432)\n"
+        "Result from add:\n"
+        "       float32 10 (0x41200000)\n"
+        "\n"
+        "Operands to dot:\n"
+        "       float32 1 (0x3F800000)\n"
+        "       float32 2 (0x40000000)\n"
+        "       float32 3 (1077936128)\n"
+        "       float32 4 (1082130432)\n"
+        "Result from dot:\n"
+        "       float32 14 (0x41600000)\n"
+        "\n"
+        ;
+    CheckFailure(CompareExpectedVsActual("Several runs of the same type", stringOutput, expectedOutput));
+
+    // Operands mapped from a raw binary file, alone and followed by a command line operand.
+    {
+        std::string const operandFilePath = (std::filesystem::temp_directory_path() / "binums_test_operands.bin").string();
+        uint16_t const float16Operands[] = {0x3C00, 0x4000, 0x4200, 0x3800}; // 1 2 3 0.5
+        FILE* operandFile = fopen(operandFilePath.c_str(), "wb");
+        if (operandFile != nullptr)
+        {
+            fwrite(float16Operands, sizeof(float16Operands), 1, operandFile);
+            fclose(operandFile);
+        }
+
+        stringOutput.clear();
+        MainImplementation("float16 add file \"" + operandFilePath + "\" mul file \"" + operandFilePath + "\" 2", stringOutput);
+        std::string const expectedFileOutput =
+            "Operands to add:\n"
+            "       float16[4] from file " + operandFilePath + "\n"
+            "Result from add:\n"
+            "       float16 6.5 (0x4680)\n"
+            "\n"
+            "Operands to multiply:\n"
+            "       float16[4] from file " + operandFilePath + "\n"
+            "       float16 2 (0x4000)\n"
+            "Result from multiply:\n"
+            "       float16 6 (0x4600)\n"
+            "\n"
+            ;
+        CheckFailure(CompareExpectedVsActual("Operands from a file", stringOutput, expectedFileOutput.c_str()));
+        std::filesystem::remove(operandFilePath);
+    }
+
+    stringOutput.clear();
+    MainImplementation("add file weights.bin", stringOutput);
+    expectedOutput = "Expected a data type before \"file\": \"weights.bin\"";
+    CheckFailure(CompareExpectedVsActual("Operands from a file without a data type", stringOutput, expectedOutput));
+
+    // Operands read from the input stream after those on the command line, separated by spaces, commas, or lines.
+    {
+        EvaluationContext context;
+        context.inputStream = tmpfile();
+        if (context.inputStream != nullptr)
+        {
+            fputs("1 2 3\n4,5", context.inputStream);
+            rewind(context.inputStream);
+        }
+
+        stringOutput.clear();
+        MainImplementation("float32 add 10 stream", stringOutput, context);
+        expectedOutput =
+            "Operands to add:\n"
+            "       float32 10 (0x41200000)\n"
+            "       float32[] from stream\n"
+            "Result from add:\n"
+            "       float32 25 (0x41C80000)\n"
+            "\n"
+            ;
+        CheckFailure(CompareExpectedVsActual("Operands from the input stream", stringOutput, expectedOutput));
+        if (context.inputStream != nullptr)
+        {
+            fclose(context.inputStream);
+        }
+    }
+
+    stringOutput.clear();
+    MainImplementation("add stream", stringOutput);
+    expectedOutput = "Expected a data type before \"stream\"";
+    CheckFailure(CompareExpectedVsActual("Operands from the input stream without a data type", stringOutput, expectedOutput));
+
+    // Served command lines, each response prefixed by its exit code and byte count, including a
+    // failure, a line ending in CRLF, and a last line without a line ending.
+    {
+        FILE* input = tmpfile();
+        FILE* output = tmpfile();
+        std::string servedOutput;
+        if (input != nullptr && output != nullptr)
+        {
+            fputs("float32 add 1 2\nbogus\r\nfloat16 dot 1 2 3 4", input);
+            rewind(input);
+            EvaluationContext context;
+            ServeCommandLines(input, output, context);
+
+            rewind(output);
+            char readBuffer[256];
+            for (size_t readByteCount; (readByteCount = fread(readBuffer, 1, sizeof(readBuffer), output)) > 0; )
+            {
+                servedOutput.append(readBuffer, readByteCount);
+            }
+        }
+        if (input != nullptr)
+        {
+            fclose(input);
+        }
+        if (output != nullptr)
+        {
+            fclose(output);
+        }
+
+        std::string expectedServedOutput;
+        for (std::string_view commandLine : {"float32 add 1 2", "bogus", "float16 dot 1 2 3 4"})
+        {
+            stringOutput.clear();
+            int const exitCode = MainImplementation(commandLine, stringOutput);
+            expectedServedOutput.append(std::to_string(exitCode)).append(" ").append(std::to_string(stringOutput.size())).append("\n");
+            expectedServedOutput.append(stringOutput);
+        }
+        CheckFailure(CompareExpectedVsActual("Served command lines", servedOutput, expectedServedOutput.c_str()));
+    }
+
+    CheckFailure(VerifyFloatingTypes());
+    CheckFailure(VerifyFloat16Codec());
+    CheckFailure(VerifyBfloat16Codec());
+    CheckFailure(VerifyFloat8Codec());
+    CheckFailure(VerifyRawFloatTypeArray());
+    CheckFailure(VerifyExhaustiveFloatConversions(g_test.shouldSweepAllFloat32Values));
+    CheckFailure(VerifyDotProduct());
+    CheckFailure(VerifySummation());
+    CheckFailure(VerifyParallelReduction());
+    CheckFailure(VerifyEvaluationContext());
+    CheckFailure(VerifyStreamedOperands());
+    CheckFailure(VerifyCInterface());
+    #if __linux__
+    CheckFailure(VerifySocketServer());
+    #endif
 
     return EXIT_SUCCESS;
 }
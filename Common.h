@@ -6,6 +6,13 @@ struct Range
     uint32_t end = 0;
 };
 
+// For indices that may pass 32 bits, like those of operands mapped from files.
+struct SizeRange
+{
+    size_t begin = 0;
+    size_t end = 0;
+};
+
 template <typename T>
 class Span
 {
@@ -56,6 +63,44 @@ struct SmallEnum
     SmallType value;
 };
 
+// Allocates on the given alignment boundary, like for buffers read with SIMD loads,
+// from the given memory resource (otherwise the default one).
+template <typename T, size_t Alignment>
+struct AlignedAllocator
+{
+    using value_type = T;
+
+    template <typename U>
+    struct rebind
+    {
+        using other = AlignedAllocator<U, Alignment>;
+    };
+
+    static constexpr size_t alignment = std::max(Alignment, alignof(T));
+
+    AlignedAllocator() = default;
+
+    AlignedAllocator(std::pmr::memory_resource* memoryResource) noexcept : memoryResource(memoryResource) {}
+
+    template <typename U>
+    AlignedAllocator(AlignedAllocator<U, Alignment> const& other) noexcept : memoryResource(other.memoryResource) {}
+
+    T* allocate(size_t count)
+    {
+        return static_cast<T*>(memoryResource->allocate(count * sizeof(T), alignment));
+    }
+
+    void deallocate(T* p, size_t count) noexcept
+    {
+        memoryResource->deallocate(p, count * sizeof(T), alignment);
+    }
+
+    template <typename U>
+    bool operator ==(AlignedAllocator<U, Alignment> const& other) const noexcept { return *memoryResource == *other.memoryResource; }
+
+    std::pmr::memory_resource* memoryResource = std::pmr::get_default_resource();
+};
+
 template <typename ContainerType>
 auto MakeSpan(ContainerType& container) -> Span<std::remove_reference_t<decltype(*container.data())> >
 {
@@ -0,0 +1,130 @@
+//-----------------------------------------------------------------------------
+//
+//  Runtime CPU feature detection for the vectorized conversion kernels.
+//
+//  The kernels are compiled per instruction set using BINUMS_TARGET, since
+//  GCC and Clang otherwise refuse to emit instructions beyond the baseline
+//  architecture (MSVC emits any intrinsic regardless). Callers must check
+//  GetCpuFeatures() before calling a kernel that uses newer instructions.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+    #define BINUMS_X86 1
+    #include <immintrin.h>
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #include <intrin.h>
+    #else
+        #include <cpuid.h>
+    #endif
+#else
+    #define BINUMS_X86 0
+#endif
+
+#if BINUMS_X86 && (defined(__GNUC__) || defined(__clang__))
+    #define BINUMS_TARGET(features) __attribute__((target(features)))
+#else
+    #define BINUMS_TARGET(features)
+#endif
+
+struct CpuFeatures
+{
+    bool sse2 = false;
+    bool sse41 = false;
+    bool avx = false;
+    bool avx2 = false;
+    bool fma = false;
+    bool f16c = false;
+    bool avx512f = false;
+    bool avx512bw = false;
+    bool avx512vl = false;
+    bool avx512bf16 = false;
+};
+
+namespace CpuFeaturesDetails
+{
+#if BINUMS_X86
+    inline void Cpuid(uint32_t leaf, uint32_t subleaf, /*out*/ uint32_t (&registers)[4]) noexcept
+    {
+    #if defined(_MSC_VER) && !defined(__clang__)
+        int values[4];
+        __cpuidex(values, int(leaf), int(subleaf));
+        for (size_t i = 0; i < 4; ++i)
+        {
+            registers[i] = uint32_t(values[i]);
+        }
+    #else
+        __cpuid_count(leaf, subleaf, registers[0], registers[1], registers[2], registers[3]);
+    #endif
+    }
+
+    // Read which register states the OS saves on context switches (XCR0).
+    inline uint64_t ReadExtendedControlRegister() noexcept
+    {
+    #if defined(_MSC_VER) && !defined(__clang__)
+        return _xgetbv(0);
+    #else
+        uint32_t eax, edx;
+        __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+        return (uint64_t(edx) << 32) | eax;
+    #endif
+    }
+#endif
+} // namespace CpuFeaturesDetails
+
+inline CpuFeatures DetectCpuFeatures() noexcept
+{
+    CpuFeatures cpuFeatures;
+
+#if BINUMS_X86
+    using namespace CpuFeaturesDetails;
+
+    uint32_t registers[4] = {}; // eax, ebx, ecx, edx
+    Cpuid(0, 0, /*out*/ registers);
+    uint32_t const maximumLeaf = registers[0];
+
+    Cpuid(1, 0, /*out*/ registers);
+    uint32_t const leaf1Ecx = registers[2];
+    uint32_t const leaf1Edx = registers[3];
+
+    uint32_t leaf7Ebx = 0, leaf7Subleaf1Eax = 0;
+    if (maximumLeaf >= 7)
+    {
+        Cpuid(7, 0, /*out*/ registers);
+        leaf7Ebx = registers[1];
+        uint32_t const maximumSubleaf = registers[0];
+        if (maximumSubleaf >= 1)
+        {
+            Cpuid(7, 1, /*out*/ registers);
+            leaf7Subleaf1Eax = registers[0];
+        }
+    }
+
+    // The OS must save the wider registers too, not just the CPU support them.
+    bool const hasOsXsave = leaf1Ecx & (1u << 27);
+    uint64_t const extendedControlRegister = hasOsXsave ? ReadExtendedControlRegister() : 0;
+    bool const hasOsAvxState = (extendedControlRegister & 0x06) == 0x06; // XMM and YMM
+    bool const hasOsAvx512State = (extendedControlRegister & 0xE6) == 0xE6; // XMM, YMM, opmask, ZMM
+
+    cpuFeatures.sse2        = leaf1Edx & (1u << 26);
+    cpuFeatures.sse41       = leaf1Ecx & (1u << 19);
+    cpuFeatures.avx         = hasOsAvxState && (leaf1Ecx & (1u << 28));
+    cpuFeatures.fma         = cpuFeatures.avx && (leaf1Ecx & (1u << 12));
+    cpuFeatures.f16c        = cpuFeatures.avx && (leaf1Ecx & (1u << 29));
+    cpuFeatures.avx2        = cpuFeatures.avx && (leaf7Ebx & (1u << 5));
+    cpuFeatures.avx512f     = hasOsAvx512State && (leaf7Ebx & (1u << 16));
+    cpuFeatures.avx512bw    = cpuFeatures.avx512f && (leaf7Ebx & (1u << 30));
+    cpuFeatures.avx512vl    = cpuFeatures.avx512f && (leaf7Ebx & (1u << 31));
+    cpuFeatures.avx512bf16  = cpuFeatures.avx512f && (leaf7Subleaf1Eax & (1u << 5));
+#endif
+
+    return cpuFeatures;
+}
+
+inline CpuFeatures const& GetCpuFeatures() noexcept
+{
+    static CpuFeatures const cpuFeatures = DetectCpuFeatures();
+    return cpuFeatures;
+}
@@ -0,0 +1,610 @@
+//-----------------------------------------------------------------------------
+//
+//  Dot products over interleaved pairs (a0 b0 a1 b1 ...), which is how the
+//  dot operation lays out its operands: a0*b0 + a1*b1 + ..., plus the last
+//  value if the count is odd.
+//
+//  The pairs are summed in one fixed layout on every machine, so a dot product
+//  gives the same bits whichever kernel runs: four accumulators of 64 bytes of
+//  lanes (16 float32 or 8 float64), the width of one AVX-512 register. Each
+//  step hands accumulator j, lane l the pair (j * laneCount + l) of the step.
+//  At the end, each lane adds its accumulators as (0 + 1) + (2 + 3), the lanes
+//  are added in order, and the pairs past the last whole step follow one at a
+//  time. AVX2 runs each accumulator as two registers, and the scalar code runs
+//  the same lanes in a loop.
+//
+//  float32 and float64 use FMA throughout, tail included, rounding each
+//  product and sum once. float16 and bfloat16 compute in float32 but round
+//  every product and every sum back to their own precision like the scalar
+//  element operations, since float32 has enough bits that the double rounding
+//  is still correct. Only the order differs from those element operations.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+namespace DotProductDetails
+{
+    inline float RoundToFloat16(float value) noexcept
+    {
+        return ConvertFloat16BitsToFloat32(ConvertFloat32ToFloat16Bits(value));
+    }
+
+    inline float RoundToBfloat16(float value) noexcept
+    {
+        return ConvertBfloat16BitsToFloat32(ConvertFloat32ToBfloat16Bits(value));
+    }
+
+    constexpr size_t accumulatorCount = 4;
+    constexpr size_t accumulatorByteCount = 64;
+
+    // Multiply and add with the rounding of the element type, fused for float32 and float64.
+    template <typename Scalar>
+    typename Scalar::AccumulatorType MultiplyAddScalar(
+        typename Scalar::AccumulatorType left,
+        typename Scalar::AccumulatorType right,
+        typename Scalar::AccumulatorType sum
+        ) noexcept
+    {
+        if constexpr (Scalar::isFused)
+        {
+            return std::fma(left, right, sum);
+        }
+        else
+        {
+            return Scalar::Round(sum + Scalar::Round(left * right));
+        }
+    }
+
+    // Continue the dot product from an initial sum, one pair at a time.
+    template <typename Scalar>
+    typename Scalar::AccumulatorType DotInterleavedScalar(
+        typename Scalar::ValueType const* values,
+        size_t count,
+        typename Scalar::AccumulatorType sum
+        ) noexcept
+    {
+        size_t i = 0;
+        for (; i + 2 <= count; i += 2)
+        {
+            sum = MultiplyAddScalar<Scalar>(Scalar::Decode(values[i]), Scalar::Decode(values[i + 1]), sum);
+        }
+        if (i < count)
+        {
+            sum = Scalar::Round(sum + Scalar::Decode(values[i]));
+        }
+        return sum;
+    }
+
+    struct Float32Scalar
+    {
+        using ValueType = float;
+        using AccumulatorType = float;
+        static constexpr bool isFused = true;
+        static float Decode(float value) noexcept { return value; }
+        static float Round(float value) noexcept { return value; }
+    };
+
+    struct Float64Scalar
+    {
+        using ValueType = double;
+        using AccumulatorType = double;
+        static constexpr bool isFused = true;
+        static double Decode(double value) noexcept { return value; }
+        static double Round(double value) noexcept { return value; }
+    };
+
+    struct Float16Scalar
+    {
+        using ValueType = uint16_t;
+        using AccumulatorType = float;
+        static constexpr bool isFused = false;
+        static float Decode(uint16_t value) noexcept { return ConvertFloat16BitsToFloat32ViaTable(value); }
+        static float Round(float value) noexcept { return RoundToFloat16(value); }
+    };
+
+    struct Bfloat16Scalar
+    {
+        using ValueType = uint16_t;
+        using AccumulatorType = float;
+        static constexpr bool isFused = false;
+        static float Decode(uint16_t value) noexcept { return ConvertBfloat16BitsToFloat32(value); }
+        static float Round(float value) noexcept { return RoundToBfloat16(value); }
+    };
+
+    template <typename Scalar>
+    constexpr size_t accumulatorLaneCount = accumulatorByteCount / sizeof(typename Scalar::AccumulatorType);
+
+    // Add the accumulator lanes in a fixed order, then finish the remaining values.
+    template <typename Scalar>
+    typename Scalar::AccumulatorType FinishDotInterleaved(
+        typename Scalar::AccumulatorType const (&lanes)[accumulatorLaneCount<Scalar>],
+        typename Scalar::ValueType const* values,
+        size_t count
+        ) noexcept
+    {
+        typename Scalar::AccumulatorType sum = lanes[0];
+        for (size_t i = 1; i < accumulatorLaneCount<Scalar>; ++i)
+        {
+            sum = Scalar::Round(sum + lanes[i]);
+        }
+        return DotInterleavedScalar<Scalar>(values, count, sum);
+    }
+
+    // The kernels' layout one lane at a time, for machines without them.
+    template <typename Scalar>
+    typename Scalar::AccumulatorType DotInterleaved(typename Scalar::ValueType const* values, size_t count) noexcept
+    {
+        using AccumulatorType = typename Scalar::AccumulatorType;
+        constexpr size_t stepSize = accumulatorLaneCount<Scalar> * 2 * accumulatorCount;
+
+        AccumulatorType sums[accumulatorCount][accumulatorLaneCount<Scalar>] = {};
+        size_t i = 0;
+        for (; i + stepSize <= count; i += stepSize)
+        {
+            for (size_t j = 0; j < accumulatorCount; ++j)
+            {
+                for (size_t lane = 0; lane < accumulatorLaneCount<Scalar>; ++lane)
+                {
+                    typename Scalar::ValueType const* pair = values + i + (j * accumulatorLaneCount<Scalar> + lane) * 2;
+                    sums[j][lane] = MultiplyAddScalar<Scalar>(Scalar::Decode(pair[0]), Scalar::Decode(pair[1]), sums[j][lane]);
+                }
+            }
+        }
+
+        AccumulatorType lanes[accumulatorLaneCount<Scalar>];
+        for (size_t lane = 0; lane < accumulatorLaneCount<Scalar>; ++lane)
+        {
+            lanes[lane] = Scalar::Round(Scalar::Round(sums[0][lane] + sums[1][lane]) + Scalar::Round(sums[2][lane] + sums[3][lane]));
+        }
+        return FinishDotInterleaved<Scalar>(lanes, values + i, count - i);
+    }
+} // namespace DotProductDetails
+
+#if BINUMS_X86
+
+namespace DotProductDetails
+{
+    constexpr int float16RoundingMode = _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC;
+
+    // Every AVX2 kernel shares one target, and AVX-512 adds to it.
+    inline bool HasAvx2Kernels(CpuFeatures const& cpuFeatures) noexcept
+    {
+        return cpuFeatures.avx2 && cpuFeatures.fma && cpuFeatures.f16c;
+    }
+
+    // Each lanes type loads one block of interleaved pairs as left and right factors, lane l
+    // taking pair l of the block, and multiplies and adds them with the rounding of its element
+    // type.
+
+    // Within each 128-bit half, the shuffles take even elements as the left factors and odd as
+    // the right, giving pairs 0 1 4 5 2 3 6 7, which the permute puts back in order.
+    BINUMS_TARGET("avx2,fma,f16c")
+    inline void DeinterleaveAvx2(__m256 low, __m256 high, /*out*/ __m256& left, /*out*/ __m256& right) noexcept
+    {
+        left = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(_mm256_shuffle_ps(low, high, 0b10'00'10'00)), 0b11'01'10'00));
+        right = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(_mm256_shuffle_ps(low, high, 0b11'01'11'01)), 0b11'01'10'00));
+    }
+
+    struct Float32Avx2Lanes : Float32Scalar
+    {
+        using Vector = __m256;
+        static constexpr size_t laneCount = 8;
+
+        BINUMS_TARGET("avx2,fma,f16c")
+        static void Load(float const* values, /*out*/ __m256& left, /*out*/ __m256& right) noexcept
+        {
+            __m256 const low = _mm256_loadu_ps(values);
+            __m256 const high = _mm256_loadu_ps(values + 8);
+            DeinterleaveAvx2(low, high, /*out*/ left, /*out*/ right);
+        }
+
+        BINUMS_TARGET("avx2,fma,f16c")
+        static __m256 MultiplyAdd(__m256 left, __m256 right, __m256 sum) noexcept
+        {
+            return _mm256_fmadd_ps(left, right, sum);
+        }
+
+        BINUMS_TARGET("avx2,fma,f16c")
+        static __m256 Add(__m256 a, __m256 b) noexcept
+        {
+            return _mm256_add_ps(a, b);
+        }
+    };
+
+    struct Float64Avx2Lanes : Float64Scalar
+    {
+        using Vector = __m256d;
+        static constexpr size_t laneCount = 4;
+
+        BINUMS_TARGET("avx2,fma,f16c")
+        static void Load(double const* values, /*out*/ __m256d& left, /*out*/ __m256d& right) noexcept
+        {
+            __m256d const low = _mm256_loadu_pd(values);
+            __m256d const high = _mm256_loadu_pd(values + 4);
+            // The unpacks take pairs 0 2 1 3, which the permute puts back in order.
+            left = _mm256_permute4x64_pd(_mm256_unpacklo_pd(low, high), 0b11'01'10'00);
+            right = _mm256_permute4x64_pd(_mm256_unpackhi_pd(low, high), 0b11'01'10'00);
+        }
+
+        BINUMS_TARGET("avx2,fma,f16c")
+        static __m256d MultiplyAdd(__m256d left, __m256d right, __m256d sum) noexcept
+        {
+            return _mm256_fmadd_pd(left, right, sum);
+        }
+
+        BINUMS_TARGET("avx2,fma,f16c")
+        static __m256d Add(__m256d a, __m256d b) noexcept
+        {
+            return _mm256_add_pd(a, b);
+        }
+    };
+
+    struct Float16Avx2Lanes : Float16Scalar
+    {
+        using Vector = __m256;
+        static constexpr size_t laneCount = 8;
+
+        BINUMS_TARGET("avx2,fma,f16c")
+        static void Load(uint16_t const* values, /*out*/ __m256& left, /*out*/ __m256& right) noexcept
+        {
+            __m256 const low = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<__m128i const*>(values)));
+            __m256 const high = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<__m128i const*>(values + 8)));
+            DeinterleaveAvx2(low, high, /*out*/ left, /*out*/ right);
+        }
+
+        BINUMS_TARGET("avx2,fma,f16c")
+        static __m256 RoundVector(__m256 value) noexcept
+        {
+            return _mm256_cvtph_ps(_mm256_cvtps_ph(value, float16RoundingMode));
+        }
+
+        BINUMS_TARGET("avx2,fma,f16c")
+        static __m256 MultiplyAdd(__m256 left, __m256 right, __m256 sum) noexcept
+        {
+            return Add(sum, RoundVector(_mm256_mul_ps(left, right)));
+        }
+
+        BINUMS_TARGET("avx2,fma,f16c")
+        static __m256 Add(__m256 a, __m256 b) noexcept
+        {
+            return RoundVector(_mm256_add_ps(a, b));
+        }
+    };
+
+    struct Bfloat16Avx2Lanes : Bfloat16Scalar
+    {
+        using Vector = __m256;
+        static constexpr size_t laneCount = 8;
+
+        BINUMS_TARGET("avx2,fma,f16c")
+        static void Load(uint16_t const* values, /*out*/ __m256& left, /*out*/ __m256& right) noexcept
+        {
+            // bfloat16 is the upper half of a float32, so each 32-bit lane holds a whole pair.
+            __m256i const pairs = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(values));
+            left = _mm256_castsi256_ps(_mm256_slli_epi32(pairs, 16));
+            right = _mm256_castsi256_ps(_mm256_and_si256(pairs, _mm256_set1_epi32(int32_t(0xFFFF0000))));
+        }
+
+        BINUMS_TARGET("avx2,fma,f16c")
+        static __m256 RoundVector(__m256 value) noexcept
+        {
+            using namespace Bfloat16CodecDetails;
+            __m256i const bits = ConvertFloat32ToBfloat16Avx2<Bfloat16Rounding::NearestEven>(_mm256_castps_si256(value));
+            return _mm256_castsi256_ps(_mm256_slli_epi32(bits, bfloat16Shift));
+        }
+
+        BINUMS_TARGET("avx2,fma,f16c")
+        static __m256 MultiplyAdd(__m256 left, __m256 right, __m256 sum) noexcept
+        {
+            return Add(sum, RoundVector(_mm256_mul_ps(left, right)));
+        }
+
+        BINUMS_TARGET("avx2,fma,f16c")
+        static __m256 Add(__m256 a, __m256 b) noexcept
+        {
+            return RoundVector(_mm256_add_ps(a, b));
+        }
+    };
+
+    // Two AVX2 registers per accumulator, to have the lanes of one AVX-512 register.
+    template <typename HalfLanes>
+    struct Avx2DoubledLanes : HalfLanes
+    {
+        struct Vector
+        {
+            typename HalfLanes::Vector low;
+            typename HalfLanes::Vector high;
+        };
+        static constexpr size_t laneCount = HalfLanes::laneCount * 2;
+
+        BINUMS_TARGET("avx2,fma,f16c")
+        static void Load(typename HalfLanes::ValueType const* values, /*out*/ Vector& left, /*out*/ Vector& right) noexcept
+        {
+            HalfLanes::Load(values, /*out*/ left.low, /*out*/ right.low);
+            HalfLanes::Load(values + HalfLanes::laneCount * 2, /*out*/ left.high, /*out*/ right.high);
+        }
+
+        BINUMS_TARGET("avx2,fma,f16c")
+        static Vector MultiplyAdd(Vector left, Vector right, Vector sum) noexcept
+        {
+            return {HalfLanes::MultiplyAdd(left.low, right.low, sum.low), HalfLanes::MultiplyAdd(left.high, right.high, sum.high)};
+        }
+
+        BINUMS_TARGET("avx2,fma,f16c")
+        static Vector Add(Vector a, Vector b) noexcept
+        {
+            return {HalfLanes::Add(a.low, b.low), HalfLanes::Add(a.high, b.high)};
+        }
+    };
+
+    // GCC 12's unmasked forms of several AVX-512 intrinsics pass an uninitialized vector through as
+    // the merge source, which -Wmaybe-uninitialized flags once inlined. The zero masked forms with
+    // every lane selected compute the same thing without it.
+    constexpr __mmask16 allFloat32Lanes = 0xFFFF;
+
+    BINUMS_TARGET("avx512f,avx2,fma,f16c")
+    inline void DeinterleaveAvx512(__m512 low, __m512 high, /*out*/ __m512& left, /*out*/ __m512& right) noexcept
+    {
+        left = _mm512_permutex2var_ps(low, _mm512_setr_epi32(0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30), high);
+        right = _mm512_permutex2var_ps(low, _mm512_setr_epi32(1, 3, 5, 7, 9, 11, 13, 15, 17, 19, 21, 23, 25, 27, 29, 31), high);
+    }
+
+    struct Float32Avx512Lanes : Float32Scalar
+    {
+        using Vector = __m512;
+        static constexpr size_t laneCount = 16;
+
+        BINUMS_TARGET("avx512f,avx2,fma,f16c")
+        static void Load(float const* values, /*out*/ __m512& left, /*out*/ __m512& right) noexcept
+        {
+            __m512 const low = _mm512_loadu_ps(values);
+            __m512 const high = _mm512_loadu_ps(values + 16);
+            DeinterleaveAvx512(low, high, /*out*/ left, /*out*/ right);
+        }
+
+        BINUMS_TARGET("avx512f,avx2,fma,f16c")
+        static __m512 MultiplyAdd(__m512 left, __m512 right, __m512 sum) noexcept
+        {
+            return _mm512_fmadd_ps(left, right, sum);
+        }
+
+        BINUMS_TARGET("avx512f,avx2,fma,f16c")
+        static __m512 Add(__m512 a, __m512 b) noexcept
+        {
+            return _mm512_add_ps(a, b);
+        }
+    };
+
+    struct Float64Avx512Lanes : Float64Scalar
+    {
+        using Vector = __m512d;
+        static constexpr size_t laneCount = 8;
+
+        BINUMS_TARGET("avx512f,avx2,fma,f16c")
+        static void Load(double const* values, /*out*/ __m512d& left, /*out*/ __m512d& right) noexcept
+        {
+            __m512d const low = _mm512_loadu_pd(values);
+            __m512d const high = _mm512_loadu_pd(values + 8);
+            left = _mm512_permutex2var_pd(low, _mm512_setr_epi64(0, 2, 4, 6, 8, 10, 12, 14), high);
+            right = _mm512_permutex2var_pd(low, _mm512_setr_epi64(1, 3, 5, 7, 9, 11, 13, 15), high);
+        }
+
+        BINUMS_TARGET("avx512f,avx2,fma,f16c")
+        static __m512d MultiplyAdd(__m512d left, __m512d right, __m512d sum) noexcept
+        {
+            return _mm512_fmadd_pd(left, right, sum);
+        }
+
+        BINUMS_TARGET("avx512f,avx2,fma,f16c")
+        static __m512d Add(__m512d a, __m512d b) noexcept
+        {
+            return _mm512_add_pd(a, b);
+        }
+    };
+
+    struct Float16Avx512Lanes : Float16Scalar
+    {
+        using Vector = __m512;
+        static constexpr size_t laneCount = 16;
+
+        BINUMS_TARGET("avx512f,avx2,fma,f16c")
+        static void Load(uint16_t const* values, /*out*/ __m512& left, /*out*/ __m512& right) noexcept
+        {
+            __m512 const low = _mm512_maskz_cvtph_ps(allFloat32Lanes, _mm256_loadu_si256(reinterpret_cast<__m256i const*>(values)));
+            __m512 const high = _mm512_maskz_cvtph_ps(allFloat32Lanes, _mm256_loadu_si256(reinterpret_cast<__m256i const*>(values + 16)));
+            DeinterleaveAvx512(low, high, /*out*/ left, /*out*/ right);
+        }
+
+        BINUMS_TARGET("avx512f,avx2,fma,f16c")
+        static __m512 RoundVector(__m512 value) noexcept
+        {
+            return _mm512_maskz_cvtph_ps(allFloat32Lanes, _mm512_maskz_cvtps_ph(allFloat32Lanes, value, float16RoundingMode));
+        }
+
+        BINUMS_TARGET("avx512f,avx2,fma,f16c")
+        static __m512 MultiplyAdd(__m512 left, __m512 right, __m512 sum) noexcept
+        {
+            return Add(sum, RoundVector(_mm512_mul_ps(left, right)));
+        }
+
+        BINUMS_TARGET("avx512f,avx2,fma,f16c")
+        static __m512 Add(__m512 a, __m512 b) noexcept
+        {
+            return RoundVector(_mm512_add_ps(a, b));
+        }
+    };
+
+    struct Bfloat16Avx512Lanes : Bfloat16Scalar
+    {
+        using Vector = __m512;
+        static constexpr size_t laneCount = 16;
+
+        BINUMS_TARGET("avx512f,avx2,fma,f16c")
+        static void Load(uint16_t const* values, /*out*/ __m512& left, /*out*/ __m512& right) noexcept
+        {
+            __m512i const pairs = _mm512_loadu_si512(values);
+            left = _mm512_castsi512_ps(_mm512_maskz_slli_epi32(allFloat32Lanes, pairs, 16));
+            right = _mm512_castsi512_ps(_mm512_and_si512(pairs, _mm512_set1_epi32(int32_t(0xFFFF0000))));
+        }
+
+        // Same logic as ConvertFloat32ToBfloat16Bits, just for 16 lanes.
+        BINUMS_TARGET("avx512f,avx2,fma,f16c")
+        static __m512 RoundVector(__m512 value) noexcept
+        {
+            using namespace Bfloat16CodecDetails;
+            __m512i const bits = _mm512_castps_si512(value);
+            __m512i const absoluteBits = _mm512_and_si512(bits, _mm512_set1_epi32(float32AbsoluteMask));
+            __mmask16 const isNan = _mm512_cmpgt_epu32_mask(absoluteBits, _mm512_set1_epi32(float32InfinityBits));
+            __m512i const isLowestBitOdd = _mm512_and_si512(_mm512_maskz_srli_epi32(allFloat32Lanes, bits, bfloat16Shift), _mm512_set1_epi32(1));
+            __m512i rounded = _mm512_add_epi32(_mm512_add_epi32(bits, _mm512_set1_epi32(nearestEvenRoundingBias)), isLowestBitOdd);
+            rounded = _mm512_mask_or_epi32(rounded, isNan, bits, _mm512_set1_epi32(float32QuietNanMask));
+            return _mm512_castsi512_ps(_mm512_and_si512(rounded, _mm512_set1_epi32(int32_t(0xFFFF0000))));
+        }
+
+        BINUMS_TARGET("avx512f,avx2,fma,f16c")
+        static __m512 MultiplyAdd(__m512 left, __m512 right, __m512 sum) noexcept
+        {
+            return Add(sum, RoundVector(_mm512_mul_ps(left, right)));
+        }
+
+        BINUMS_TARGET("avx512f,avx2,fma,f16c")
+        static __m512 Add(__m512 a, __m512 b) noexcept
+        {
+            return RoundVector(_mm512_add_ps(a, b));
+        }
+    };
+
+    // The AVX2 and AVX-512 kernels are identical apart from their target, which must differ
+    // so the AVX2 one never picks up EVEX encoded instructions.
+
+    template <typename Lanes>
+    BINUMS_TARGET("avx2,fma,f16c")
+    inline typename Lanes::AccumulatorType DotInterleavedAvx2(typename Lanes::ValueType const* values, size_t count) noexcept
+    {
+        static_assert(Lanes::laneCount == accumulatorLaneCount<Lanes>);
+        constexpr size_t blockSize = Lanes::laneCount * 2;
+        constexpr size_t stepSize = blockSize * accumulatorCount;
+
+        typename Lanes::Vector sums[accumulatorCount] = {};
+        size_t i = 0;
+        for (; i + stepSize <= count; i += stepSize)
+        {
+            for (size_t j = 0; j < accumulatorCount; ++j)
+            {
+                typename Lanes::Vector left, right;
+                Lanes::Load(values + i + j * blockSize, /*out*/ left, /*out*/ right);
+                sums[j] = Lanes::MultiplyAdd(left, right, sums[j]);
+            }
+        }
+
+        typename Lanes::AccumulatorType lanes[Lanes::laneCount];
+        typename Lanes::Vector const sum = Lanes::Add(Lanes::Add(sums[0], sums[1]), Lanes::Add(sums[2], sums[3]));
+        static_assert(sizeof(lanes) == sizeof(sum));
+        std::memcpy(lanes, &sum, sizeof(sum));
+        return FinishDotInterleaved<Lanes>(lanes, values + i, count - i);
+    }
+
+    template <typename Lanes>
+    BINUMS_TARGET("avx512f,avx2,fma,f16c")
+    inline typename Lanes::AccumulatorType DotInterleavedAvx512(typename Lanes::ValueType const* values, size_t count) noexcept
+    {
+        static_assert(Lanes::laneCount == accumulatorLaneCount<Lanes>);
+        constexpr size_t blockSize = Lanes::laneCount * 2;
+        constexpr size_t stepSize = blockSize * accumulatorCount;
+
+        typename Lanes::Vector sums[accumulatorCount] = {};
+        size_t i = 0;
+        for (; i + stepSize <= count; i += stepSize)
+        {
+            for (size_t j = 0; j < accumulatorCount; ++j)
+            {
+                typename Lanes::Vector left, right;
+                Lanes::Load(values + i + j * blockSize, /*out*/ left, /*out*/ right);
+                sums[j] = Lanes::MultiplyAdd(left, right, sums[j]);
+            }
+        }
+
+        typename Lanes::AccumulatorType lanes[Lanes::laneCount];
+        typename Lanes::Vector const sum = Lanes::Add(Lanes::Add(sums[0], sums[1]), Lanes::Add(sums[2], sums[3]));
+        static_assert(sizeof(lanes) == sizeof(sum));
+        std::memcpy(lanes, &sum, sizeof(sum));
+        return FinishDotInterleaved<Lanes>(lanes, values + i, count - i);
+    }
+} // namespace DotProductDetails
+
+#endif // BINUMS_X86
+
+inline float DotInterleavedFloat32(float const* values, size_t count) noexcept
+{
+    using namespace DotProductDetails;
+#if BINUMS_X86
+    CpuFeatures const& cpuFeatures = GetCpuFeatures();
+    if (HasAvx2Kernels(cpuFeatures) && cpuFeatures.avx512f)
+    {
+        return DotInterleavedAvx512<Float32Avx512Lanes>(values, count);
+    }
+    if (HasAvx2Kernels(cpuFeatures))
+    {
+        return DotInterleavedAvx2<Avx2DoubledLanes<Float32Avx2Lanes>>(values, count);
+    }
+#endif
+
+    return DotInterleaved<Float32Scalar>(values, count);
+}
+
+inline double DotInterleavedFloat64(double const* values, size_t count) noexcept
+{
+    using namespace DotProductDetails;
+#if BINUMS_X86
+    CpuFeatures const& cpuFeatures = GetCpuFeatures();
+    if (HasAvx2Kernels(cpuFeatures) && cpuFeatures.avx512f)
+    {
+        return DotInterleavedAvx512<Float64Avx512Lanes>(values, count);
+    }
+    if (HasAvx2Kernels(cpuFeatures))
+    {
+        return DotInterleavedAvx2<Avx2DoubledLanes<Float64Avx2Lanes>>(values, count);
+    }
+#endif
+
+    return DotInterleaved<Float64Scalar>(values, count);
+}
+
+// Returns float16 bits.
+inline uint16_t DotInterleavedFloat16(uint16_t const* values, size_t count) noexcept
+{
+    using namespace DotProductDetails;
+#if BINUMS_X86
+    CpuFeatures const& cpuFeatures = GetCpuFeatures();
+    if (HasAvx2Kernels(cpuFeatures) && cpuFeatures.avx512f)
+    {
+        return ConvertFloat32ToFloat16Bits(DotInterleavedAvx512<Float16Avx512Lanes>(values, count));
+    }
+    if (HasAvx2Kernels(cpuFeatures))
+    {
+        return ConvertFloat32ToFloat16Bits(DotInterleavedAvx2<Avx2DoubledLanes<Float16Avx2Lanes>>(values, count));
+    }
+#endif
+
+    return ConvertFloat32ToFloat16Bits(DotInterleaved<Float16Scalar>(values, count));
+}
+
+// Returns bfloat16 bits.
+inline uint16_t DotInterleavedBfloat16(uint16_t const* values, size_t count) noexcept
+{
+    using namespace DotProductDetails;
+#if BINUMS_X86
+    CpuFeatures const& cpuFeatures = GetCpuFeatures();
+    if (HasAvx2Kernels(cpuFeatures) && cpuFeatures.avx512f)
+    {
+        return ConvertFloat32ToBfloat16Bits(DotInterleavedAvx512<Bfloat16Avx512Lanes>(values, count));
+    }
+    if (HasAvx2Kernels(cpuFeatures))
+    {
+        return ConvertFloat32ToBfloat16Bits(DotInterleavedAvx2<Avx2DoubledLanes<Bfloat16Avx2Lanes>>(values, count));
+    }
+#endif
+
+    return ConvertFloat32ToBfloat16Bits(DotInterleaved<Bfloat16Scalar>(values, count));
+}
@@ -0,0 +1,219 @@
+//-----------------------------------------------------------------------------
+//
+//  Memory for evaluating operations without heap allocation once warmed up.
+//
+//  Every temporary of an evaluation (the parsed operands, the results, the
+//  cast arrays, the chunk partials) comes from a scratch arena that is
+//  rewound rather than freed afterwards. The arena only takes more from the
+//  heap when it runs out, and then keeps it, so repeating an evaluation of a
+//  similar size allocates nothing. A counter between the arena and the heap
+//  makes that checkable.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+// Passes allocations through to the upstream resource, counting them.
+class CountingMemoryResource : public std::pmr::memory_resource
+{
+public:
+    explicit CountingMemoryResource(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource()) noexcept
+    :   upstream_(upstream)
+    {
+    }
+
+    size_t GetAllocationCount() const noexcept { return allocationCount_.load(std::memory_order_relaxed); }
+    size_t GetAllocatedByteCount() const noexcept { return allocatedByteCount_.load(std::memory_order_relaxed); }
+
+private:
+    void* do_allocate(size_t byteSize, size_t alignment) override
+    {
+        void* p = upstream_->allocate(byteSize, alignment);
+        allocationCount_.fetch_add(1, std::memory_order_relaxed);
+        allocatedByteCount_.fetch_add(byteSize, std::memory_order_relaxed);
+        return p;
+    }
+
+    void do_deallocate(void* p, size_t byteSize, size_t alignment) override
+    {
+        upstream_->deallocate(p, byteSize, alignment);
+    }
+
+    bool do_is_equal(std::pmr::memory_resource const& other) const noexcept override
+    {
+        return this == &other;
+    }
+
+    std::pmr::memory_resource* upstream_;
+    std::atomic<size_t> allocationCount_ = 0;
+    std::atomic<size_t> allocatedByteCount_ = 0;
+};
+
+// Bump allocates from blocks taken from the upstream resource. Deallocation does nothing, and Reset
+// rewinds everything at once, which suits temporaries that all die together. Not thread-safe, so
+// tasks on other threads should be handed their memory up front rather than allocate here.
+class ScratchArena : public std::pmr::memory_resource
+{
+public:
+    explicit ScratchArena(size_t initialByteSize, std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+    :   upstream_(upstream)
+    {
+        if (initialByteSize > 0)
+        {
+            AddBlock(initialByteSize);
+        }
+    }
+
+    ~ScratchArena()
+    {
+        FreeBlocks();
+    }
+
+    ScratchArena(ScratchArena const&) = delete;
+    ScratchArena& operator=(ScratchArena const&) = delete;
+
+    // The total byte size of the blocks, used or not.
+    size_t GetCapacity() const noexcept
+    {
+        size_t capacity = 0;
+        for (Block const* block = firstBlock_; block != nullptr; block = block->next)
+        {
+            capacity += block->byteSize;
+        }
+        return capacity;
+    }
+
+    // Rewind to empty, invalidating everything allocated. If the arena grew since the last reset,
+    // its blocks are merged into one as large as all of them, so the same use fits next time.
+    void Reset()
+    {
+        if (firstBlock_ != nullptr && firstBlock_->next != nullptr)
+        {
+            size_t const capacity = GetCapacity();
+            FreeBlocks();
+            AddBlock(capacity);
+        }
+        else if (firstBlock_ != nullptr)
+        {
+            cursor_ = GetBlockData(firstBlock_);
+        }
+    }
+
+private:
+    struct Block
+    {
+        Block* next;
+        size_t byteSize; // Of the data following the header.
+    };
+
+    // The data starts a cache line after the header, so it is aligned like typical SIMD buffers.
+    static constexpr size_t blockAlignment = 64;
+    static_assert(sizeof(Block) <= blockAlignment);
+
+    static uint8_t* GetBlockData(Block* block) noexcept
+    {
+        return reinterpret_cast<uint8_t*>(block) + blockAlignment;
+    }
+
+    void* do_allocate(size_t byteSize, size_t alignment) override
+    {
+        uint8_t* p = AlignUp(cursor_, alignment);
+        if (lastBlock_ == nullptr || p > end_ || size_t(end_ - p) < byteSize)
+        {
+            // Grow geometrically, and by at least enough for the allocation at any alignment.
+            AddBlock(std::max(byteSize + alignment, GetCapacity()));
+            p = AlignUp(cursor_, alignment);
+        }
+        cursor_ = p + byteSize;
+        return p;
+    }
+
+    void do_deallocate(void* /*p*/, size_t /*byteSize*/, size_t /*alignment*/) override
+    {
+    }
+
+    bool do_is_equal(std::pmr::memory_resource const& other) const noexcept override
+    {
+        return this == &other;
+    }
+
+    static uint8_t* AlignUp(uint8_t* p, size_t alignment) noexcept
+    {
+        uintptr_t const address = reinterpret_cast<uintptr_t>(p);
+        return p + (((address + alignment - 1) & ~(alignment - 1)) - address);
+    }
+
+    void AddBlock(size_t byteSize)
+    {
+        Block* block = static_cast<Block*>(upstream_->allocate(blockAlignment + byteSize, blockAlignment));
+        block->next = nullptr;
+        block->byteSize = byteSize;
+        (lastBlock_ != nullptr ? lastBlock_->next : firstBlock_) = block;
+        lastBlock_ = block;
+        cursor_ = GetBlockData(block);
+        end_ = cursor_ + byteSize;
+    }
+
+    void FreeBlocks() noexcept
+    {
+        for (Block* block = firstBlock_; block != nullptr; )
+        {
+            Block* next = block->next;
+            upstream_->deallocate(block, blockAlignment + block->byteSize, blockAlignment);
+            block = next;
+        }
+        firstBlock_ = nullptr;
+        lastBlock_ = nullptr;
+        cursor_ = nullptr;
+        end_ = nullptr;
+    }
+
+    std::pmr::memory_resource* upstream_;
+    Block* firstBlock_ = nullptr;
+    Block* lastBlock_ = nullptr; // Being allocated from.
+    uint8_t* cursor_ = nullptr;
+    uint8_t* end_ = nullptr;
+};
+
+// Resets the arena on leaving the scope, once everything declared after it has been destroyed.
+class ScratchArenaScope
+{
+public:
+    explicit ScratchArenaScope(ScratchArena& arena) noexcept : arena_(arena) {}
+    ~ScratchArenaScope() { arena_.Reset(); }
+
+    ScratchArenaScope(ScratchArenaScope const&) = delete;
+    ScratchArenaScope& operator=(ScratchArenaScope const&) = delete;
+
+private:
+    ScratchArena& arena_;
+};
+
+// State kept across evaluations, so that repeating them reuses memory instead of allocating it.
+// Each evaluation draws on the scratch arena, and the arena draws on the heap through a counter.
+class EvaluationContext
+{
+public:
+    static constexpr size_t defaultScratchByteSize = size_t(1) << 16;
+
+    // Where "stream" reads operands from, and where output is written as it is produced while
+    // streaming, keeping it bounded. Without an output stream, all of it goes to the output string.
+    FILE* inputStream = stdin;
+    FILE* outputStream = nullptr;
+
+    explicit EvaluationContext(size_t scratchByteSize = defaultScratchByteSize)
+    :   scratch_(scratchByteSize, &heap_)
+    {
+    }
+
+    ScratchArena& GetScratch() noexcept { return scratch_; }
+
+    // Heap allocations made for the context since it was constructed, which stop growing once
+    // the evaluations fit in the scratch arena.
+    size_t GetAllocationCount() const noexcept { return heap_.GetAllocationCount(); }
+    size_t GetAllocatedByteCount() const noexcept { return heap_.GetAllocatedByteCount(); }
+
+private:
+    CountingMemoryResource heap_;
+    ScratchArena scratch_;
+};
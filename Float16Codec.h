@@ -0,0 +1,256 @@
+//-----------------------------------------------------------------------------
+//
+//  Bulk float16 <-> float32 conversion.
+//
+//  The scalar functions are the reference, and the vectorized kernels (F16C,
+//  or plain SSE2 integer math on older CPUs) give bit-identical results:
+//  - float32 to float16 rounds to nearest with ties to even.
+//  - overflow becomes infinity.
+//  - NaN's are quieted, keeping the upper payload bits.
+//
+//  This matches the F16C vcvtps2ph/vcvtph2ps instructions, whereas the half
+//  class (see Half.h) rounds ties away from zero and passes signaling NaN's.
+//
+//  Without F16C, decoding is a lookup into a 256KB table of every float16,
+//  which measured faster than the branchy or blended arithmetic for anything
+//  from L1 sized inputs out to DRAM (binumsbench filter decode).
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+namespace Float16CodecDetails
+{
+    constexpr uint32_t float32SignMask          = 0x80000000;
+    constexpr uint32_t float32InfinityBits      = 0x7F800000;
+    constexpr uint32_t float32QuietNanMask      = 0x00400000;
+    constexpr uint32_t float16SignMask          = 0x8000;
+    constexpr uint32_t float16InfinityBits      = 0x7C00;
+    constexpr uint32_t float16QuietNanMask      = 0x0200;
+    constexpr uint32_t float16FractionMask      = 0x03FF;
+    constexpr uint32_t float16MinimumNormalBits = 0x0400;
+    constexpr uint32_t fractionShift            = 23 - 10;
+    constexpr uint32_t exponentAdjustment       = (127 - 15) << 23;
+
+    // Any float32 at least this large (65536) is infinity or NaN in float16.
+    constexpr uint32_t float32OverflowBits      = 0x47800000;
+    // Any float32 below this (2^-14) is subnormal or zero in float16.
+    constexpr uint32_t float32SubnormalBits     = 0x38800000;
+    // Adding 0.5 aligns a float16 subnormal's fraction at the bottom of the float32,
+    // and the FPU's own round-to-nearest-even does the rounding.
+    constexpr uint32_t subnormalMagicBits       = 126u << 23;
+    // 2^-14, the smallest float16 normal, used to renormalize subnormals.
+    constexpr uint32_t float16MinimumNormalFloat32Bits = 113u << 23;
+}
+
+inline uint16_t ConvertFloat32ToFloat16Bits(float value) noexcept
+{
+    using namespace Float16CodecDetails;
+
+    uint32_t bits = std::bit_cast<uint32_t>(value);
+    uint32_t const sign = bits & float32SignMask;
+    bits ^= sign;
+
+    uint32_t result;
+    if (bits >= float32OverflowBits)
+    {
+        // Infinity stays infinity, overflow saturates to it, and NaN's are quieted.
+        result = float16InfinityBits;
+        if (bits > float32InfinityBits)
+        {
+            result |= float16QuietNanMask | ((bits >> fractionShift) & float16FractionMask);
+        }
+    }
+    else if (bits < float32SubnormalBits)
+    {
+        float const aligned = std::bit_cast<float>(bits) + std::bit_cast<float>(subnormalMagicBits);
+        result = std::bit_cast<uint32_t>(aligned) - subnormalMagicBits;
+    }
+    else
+    {
+        // Round to nearest, ties to even, then rebias the exponent.
+        uint32_t const isFractionOdd = (bits >> fractionShift) & 1;
+        result = (bits - exponentAdjustment + ((1u << (fractionShift - 1)) - 1) + isFractionOdd) >> fractionShift;
+    }
+
+    return uint16_t(result | (sign >> 16));
+}
+
+inline float ConvertFloat16BitsToFloat32(uint16_t value) noexcept
+{
+    using namespace Float16CodecDetails;
+
+    uint32_t const absoluteValue = value & ~float16SignMask;
+    uint32_t bits = (absoluteValue << fractionShift) + exponentAdjustment;
+
+    if (absoluteValue >= float16InfinityBits)
+    {
+        bits += exponentAdjustment; // Maximum exponent, (255 - 31) << 23.
+        if (absoluteValue > float16InfinityBits)
+        {
+            bits |= float32QuietNanMask;
+        }
+    }
+    else if (absoluteValue < float16MinimumNormalBits)
+    {
+        // Treat subnormals as a normal with the minimum exponent, then subtract the implicit one.
+        float const renormalized = std::bit_cast<float>(bits + (1u << 23)) - std::bit_cast<float>(float16MinimumNormalFloat32Bits);
+        bits = std::bit_cast<uint32_t>(renormalized);
+    }
+
+    return std::bit_cast<float>(bits | (uint32_t(value & float16SignMask) << 16));
+}
+
+// Every float16 decoded once into a table shared by the whole process, built on first use.
+// A lookup is a single load without the subnormal/NaN branches.
+inline float const* GetFloat16DecodeTable() noexcept
+{
+    static std::vector<float> const table = []()
+    {
+        std::vector<float> values(65536);
+        for (uint32_t i = 0; i < 65536; ++i)
+        {
+            values[i] = ConvertFloat16BitsToFloat32(uint16_t(i));
+        }
+        return values;
+    }();
+    return table.data();
+}
+
+inline float ConvertFloat16BitsToFloat32ViaTable(uint16_t value) noexcept
+{
+    return GetFloat16DecodeTable()[value];
+}
+
+#if BINUMS_X86
+
+BINUMS_TARGET("avx,f16c")
+inline void ConvertFloat32ToFloat16ArrayF16c(float const* input, /*out*/ uint16_t* output, size_t count) noexcept
+{
+    constexpr int roundingMode = _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC;
+
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        __m128i const low = _mm256_cvtps_ph(_mm256_loadu_ps(input + i), roundingMode);
+        __m128i const high = _mm256_cvtps_ph(_mm256_loadu_ps(input + i + 8), roundingMode);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), low);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i + 8), high);
+    }
+    for (; i < count; ++i)
+    {
+        output[i] = ConvertFloat32ToFloat16Bits(input[i]);
+    }
+}
+
+BINUMS_TARGET("avx,f16c")
+inline void ConvertFloat16ToFloat32ArrayF16c(uint16_t const* input, /*out*/ float* output, size_t count) noexcept
+{
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        __m256 const low = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<__m128i const*>(input + i)));
+        __m256 const high = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<__m128i const*>(input + i + 8)));
+        _mm256_storeu_ps(output + i, low);
+        _mm256_storeu_ps(output + i + 8, high);
+    }
+    for (; i < count; ++i)
+    {
+        output[i] = ConvertFloat16BitsToFloat32(input[i]);
+    }
+}
+
+namespace Float16CodecDetails
+{
+    // Select a where the mask is set, else b.
+    inline __m128i Select(__m128i mask, __m128i a, __m128i b) noexcept
+    {
+        return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+    }
+
+    // Same logic as ConvertFloat32ToFloat16Bits, just for 4 lanes. The result is in the low 16 bits of each lane.
+    inline __m128i ConvertFloat32ToFloat16Sse2(__m128 value) noexcept
+    {
+        __m128i bits = _mm_castps_si128(value);
+        __m128i const sign = _mm_and_si128(bits, _mm_set1_epi32(int32_t(float32SignMask)));
+        bits = _mm_xor_si128(bits, sign);
+
+        __m128i const fraction = _mm_srli_epi32(bits, fractionShift);
+        __m128i const isFractionOdd = _mm_and_si128(fraction, _mm_set1_epi32(1));
+        __m128i const roundingBias = _mm_set1_epi32(int32_t(((1u << (fractionShift - 1)) - 1) - exponentAdjustment));
+        __m128i const normal = _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(bits, roundingBias), isFractionOdd), fractionShift);
+
+        __m128 const subnormalMagic = _mm_castsi128_ps(_mm_set1_epi32(subnormalMagicBits));
+        __m128i const subnormal = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(_mm_castsi128_ps(bits), subnormalMagic)), _mm_castps_si128(subnormalMagic));
+
+        __m128i const isNan = _mm_cmpgt_epi32(bits, _mm_set1_epi32(float32InfinityBits));
+        __m128i const nanPayload = _mm_or_si128(_mm_set1_epi32(float16QuietNanMask), _mm_and_si128(fraction, _mm_set1_epi32(float16FractionMask)));
+        __m128i const special = _mm_or_si128(_mm_set1_epi32(float16InfinityBits), _mm_and_si128(isNan, nanPayload));
+
+        __m128i const isSpecial = _mm_cmpgt_epi32(bits, _mm_set1_epi32(float32OverflowBits - 1));
+        __m128i const isSubnormal = _mm_cmplt_epi32(bits, _mm_set1_epi32(float32SubnormalBits));
+        __m128i result = Select(isSpecial, special, Select(isSubnormal, subnormal, normal));
+        return _mm_or_si128(result, _mm_srli_epi32(sign, 16));
+    }
+
+} // namespace Float16CodecDetails
+
+BINUMS_TARGET("sse2")
+inline void ConvertFloat32ToFloat16ArraySse2(float const* input, /*out*/ uint16_t* output, size_t count) noexcept
+{
+    using namespace Float16CodecDetails;
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i low = ConvertFloat32ToFloat16Sse2(_mm_loadu_ps(input + i));
+        __m128i high = ConvertFloat32ToFloat16Sse2(_mm_loadu_ps(input + i + 4));
+        // Sign extend the low 16 bits so the signed saturating pack keeps them as-is.
+        low = _mm_srai_epi32(_mm_slli_epi32(low, 16), 16);
+        high = _mm_srai_epi32(_mm_slli_epi32(high, 16), 16);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), _mm_packs_epi32(low, high));
+    }
+    for (; i < count; ++i)
+    {
+        output[i] = ConvertFloat32ToFloat16Bits(input[i]);
+    }
+}
+
+#endif // BINUMS_X86
+
+inline void ConvertFloat32ToFloat16Array(float const* input, /*out*/ uint16_t* output, size_t count) noexcept
+{
+#if BINUMS_X86
+    CpuFeatures const& cpuFeatures = GetCpuFeatures();
+    if (cpuFeatures.f16c)
+    {
+        return ConvertFloat32ToFloat16ArrayF16c(input, /*out*/ output, count);
+    }
+    if (cpuFeatures.sse2)
+    {
+        return ConvertFloat32ToFloat16ArraySse2(input, /*out*/ output, count);
+    }
+#endif
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        output[i] = ConvertFloat32ToFloat16Bits(input[i]);
+    }
+}
+
+inline void ConvertFloat16ToFloat32Array(uint16_t const* input, /*out*/ float* output, size_t count) noexcept
+{
+#if BINUMS_X86
+    CpuFeatures const& cpuFeatures = GetCpuFeatures();
+    if (cpuFeatures.f16c)
+    {
+        return ConvertFloat16ToFloat32ArrayF16c(input, /*out*/ output, count);
+    }
+#endif
+
+    float const* decodeTable = GetFloat16DecodeTable();
+    for (size_t i = 0; i < count; ++i)
+    {
+        output[i] = decodeTable[input[i]];
+    }
+}
@@ -24,24 +24,23 @@ struct float16m7e8s1_t
     float16m7e8s1_t(const float16m7e8s1_t&) = default;
     float16m7e8s1_t(float16m7e8s1_t&&) = default;
 
+    // Rounds to nearest even, like hardware bfloat16 conversion.
     float16m7e8s1_t(float floatValue) noexcept
     {
-        value = reinterpret_cast<uint32_t&>(floatValue) >> 16;
+        value = ConvertFloat32ToBfloat16Bits(floatValue);
     }
 
     float16m7e8s1_t& operator =(const float16m7e8s1_t&) = default;
 
     float16m7e8s1_t& operator =(float floatValue) noexcept
     {
-        value = reinterpret_cast<uint32_t&>(floatValue) >> 16;
+        value = ConvertFloat32ToBfloat16Bits(floatValue);
         return *this;
     }
 
     operator float() const noexcept
     {
-        float floatValue = 0.0;
-        reinterpret_cast<uint32_t&>(floatValue) = value << 16;
-        return floatValue;
+        return ConvertBfloat16BitsToFloat32(value);
     }
 
     uint16_t value;
@@ -0,0 +1,144 @@
+//-----------------------------------------------------------------------------
+//
+//  Bulk float8 <-> float32 conversion for any 8-bit FloatDefinition.
+//
+//  The scalar functions and their tables live in FloatNumber.h. The AVX2
+//  kernels here just do the same work 8 lanes at a time: decoding is one
+//  gather from the 256-entry table, and encoding is a fixed number of
+//  gather-and-compare steps over the threshold table.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#if BINUMS_X86
+
+namespace Float8CodecDetails
+{
+    // Same logic as FloatNumberDetails::ConvertFloat32ToFloat8Bits, just for 8 lanes.
+    template <typename FloatDefinition>
+    BINUMS_TARGET("avx2")
+    inline __m256i ConvertFloat32ToFloat8Avx2(__m256i bits) noexcept
+    {
+        using Definition = FloatDefinition;
+        using Tables = FloatNumberDetails::Float8CodecTables<Definition>;
+        Tables const& tables = FloatNumberDetails::g_float8CodecTables<Definition>;
+
+        __m256i const absoluteBits = _mm256_and_si256(bits, _mm256_set1_epi32(0x7FFFFFFF));
+        __m256i index = _mm256_setzero_si256();
+        for (uint32_t step = Tables::magnitudeCapacity / 2; step > 0; step /= 2)
+        {
+            __m256i const nextIndex = _mm256_add_epi32(index, _mm256_set1_epi32(step));
+            __m256i const threshold = _mm256_i32gather_epi32(tables.thresholds, nextIndex, sizeof(int32_t));
+            __m256i const isBelowThreshold = _mm256_cmpgt_epi32(threshold, absoluteBits);
+            index = _mm256_blendv_epi8(nextIndex, index, isBelowThreshold);
+        }
+        __m256i code = _mm256_i32gather_epi32(tables.codes, index, sizeof(int32_t));
+
+        __m256i const isNegative = _mm256_srai_epi32(bits, 31);
+        if constexpr (Definition::hasSign)
+        {
+            code = _mm256_or_si256(code, _mm256_and_si256(isNegative, _mm256_set1_epi32(Definition::signMask)));
+        }
+        else
+        {
+            code = _mm256_andnot_si256(isNegative, code);
+        }
+
+        __m256i const isNan = _mm256_cmpgt_epi32(absoluteBits, _mm256_set1_epi32(0x7F800000));
+        __m256i const nan = _mm256_or_si256(_mm256_set1_epi32(tables.nanCode), _mm256_and_si256(isNegative, _mm256_set1_epi32(Definition::signMask)));
+        return _mm256_blendv_epi8(code, nan, isNan);
+    }
+} // namespace Float8CodecDetails
+
+template <typename FloatDefinition>
+BINUMS_TARGET("avx2")
+inline void ConvertFloat32ToFloat8ArrayAvx2(float const* input, /*out*/ uint8_t* output, size_t count) noexcept
+{
+    using namespace Float8CodecDetails;
+
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        __m256i const low = ConvertFloat32ToFloat8Avx2<FloatDefinition>(_mm256_loadu_si256(reinterpret_cast<__m256i const*>(input + i)));
+        __m256i const high = ConvertFloat32ToFloat8Avx2<FloatDefinition>(_mm256_loadu_si256(reinterpret_cast<__m256i const*>(input + i + 8)));
+        // Codes are 0..255, so the saturating packs keep them as-is. The 256-bit pack works
+        // within 128-bit halves, so restore the element order before the final pack.
+        __m256i const packed16 = _mm256_permute4x64_epi64(_mm256_packs_epi32(low, high), 0b11'01'10'00);
+        __m128i const packed8 = _mm_packus_epi16(_mm256_castsi256_si128(packed16), _mm256_extracti128_si256(packed16, 1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), packed8);
+    }
+    for (; i < count; ++i)
+    {
+        output[i] = FloatNumberDetails::ConvertFloat32ToFloat8Bits<FloatDefinition>(input[i]);
+    }
+}
+
+template <typename FloatDefinition>
+BINUMS_TARGET("avx2")
+inline void ConvertFloat8ToFloat32ArrayAvx2(uint8_t const* input, /*out*/ float* output, size_t count) noexcept
+{
+    float const* decodeTable = FloatNumberDetails::g_float8CodecTables<FloatDefinition>.decode;
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256i const index = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<__m128i const*>(input + i)));
+        _mm256_storeu_ps(output + i, _mm256_i32gather_ps(decodeTable, index, sizeof(float)));
+    }
+    for (; i < count; ++i)
+    {
+        output[i] = decodeTable[input[i]];
+    }
+}
+
+#endif // BINUMS_X86
+
+template <typename FloatDefinition>
+inline void ConvertFloat32ToFloat8Array(float const* input, /*out*/ uint8_t* output, size_t count) noexcept
+{
+#if BINUMS_X86
+    if (GetCpuFeatures().avx2)
+    {
+        return ConvertFloat32ToFloat8ArrayAvx2<FloatDefinition>(input, /*out*/ output, count);
+    }
+#endif
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        output[i] = FloatNumberDetails::ConvertFloat32ToFloat8Bits<FloatDefinition>(input[i]);
+    }
+}
+
+template <typename FloatDefinition>
+inline void ConvertFloat8ToFloat32Array(uint8_t const* input, /*out*/ float* output, size_t count) noexcept
+{
+#if BINUMS_X86
+    if (GetCpuFeatures().avx2)
+    {
+        return ConvertFloat8ToFloat32ArrayAvx2<FloatDefinition>(input, /*out*/ output, count);
+    }
+#endif
+
+    float const* decodeTable = FloatNumberDetails::g_float8CodecTables<FloatDefinition>.decode;
+    for (size_t i = 0; i < count; ++i)
+    {
+        output[i] = decodeTable[input[i]];
+    }
+}
+
+// float64 is narrowed with round to odd first, so the result matches rounding directly.
+template <typename FloatDefinition>
+inline void ConvertFloat64ToFloat8Array(double const* input, /*out*/ uint8_t* output, size_t count) noexcept
+{
+    float block[256];
+    for (size_t i = 0; i < count; i += std::size(block))
+    {
+        size_t const blockCount = std::min(count - i, std::size(block));
+        for (size_t j = 0; j < blockCount; ++j)
+        {
+            block[j] = FloatNumberDetails::ConvertFloat64ToFloat32RoundToOdd(input[i + j]);
+        }
+        ConvertFloat32ToFloat8Array<FloatDefinition>(block, /*out*/ output + i, blockCount);
+    }
+}
@@ -87,6 +87,7 @@ namespace FloatNumberDetails
     using Float32Definition         = FloatDefinition<uint32_t, 23, 8, true, true, true, true>;
     using Float64Definition         = FloatDefinition<uint64_t, 52, 11, true, true, true, true>;
     using Float16f10e5s1Definition  = FloatDefinition<uint16_t, 10, 5, true, true, true, true>;
+    using Float16f7e8s1Definition   = FloatDefinition<uint16_t, 7, 8, true, true, true, true>; // bfloat16
     // using Float128Definition = FloatDefinition<uint128_t, 112, 15, true, true, true>; Most compilers lack a uint128_t.
 
     // Minihelper shifts left if positive (right if negative).
@@ -96,71 +97,395 @@ namespace FloatNumberDetails
         return (shift >= 0) ? (t << shift) : (t >> -shift);
     }
 
+    // Branch-free helpers for the conversion below. Compilers happily turn std::min/max and ternaries
+    // into branches when the operands come from earlier comparisons, which mispredict on mixed data.
+    template <typename T>
+    inline T constexpr BitMaskIf(bool condition) noexcept
+    {
+        return T(T(0) - T(condition)); // All ones if true, else zero.
+    }
+
+    template <typename T>
+    inline T constexpr SelectIf(bool condition, T trueValue, T falseValue) noexcept
+    {
+        return T(falseValue ^ ((trueValue ^ falseValue) & BitMaskIf<T>(condition)));
+    }
+
+    inline int32_t constexpr BranchlessMinimum(int32_t a, int32_t b) noexcept
+    {
+        int32_t const difference = a - b;
+        return b + (difference & (difference >> 31));
+    }
+
+    inline int32_t constexpr BranchlessMaximum(int32_t a, int32_t b) noexcept
+    {
+        int32_t const difference = a - b;
+        return b + (difference & ~(difference >> 31));
+    }
+
+    // How to round values that fall between two representable ones, picked at compile time.
+    enum class RoundingMode
+    {
+        NearestEven,
+        TowardZero, // Truncate
+        Up,         // Toward positive infinity
+        Down,       // Toward negative infinity
+    };
+
+    // Wide enough for both the source and target bits.
     template <typename SourceFloatDefinition, typename TargetFloatDefinition>
+    using RawFloatIntermediateType = std::conditional_t<
+        (SourceFloatDefinition::totalBitCount > TargetFloatDefinition::totalBitCount),
+        typename SourceFloatDefinition::baseIntegerType,
+        typename TargetFloatDefinition::baseIntegerType
+    >;
+
+    // Widening between formats which differ only by extra low fraction bits (like bfloat16 to
+    // float32) is exactly a shift of the whole value.
+    template <typename SourceFloatDefinition, typename TargetFloatDefinition>
+    constexpr bool isShiftOnlyConversion =
+        TargetFloatDefinition::exponentBitCount == SourceFloatDefinition::exponentBitCount
+    &&  TargetFloatDefinition::hasSign          == SourceFloatDefinition::hasSign
+    &&  TargetFloatDefinition::hasSubnormals    == SourceFloatDefinition::hasSubnormals
+    &&  TargetFloatDefinition::hasInfinity      == SourceFloatDefinition::hasInfinity
+    &&  TargetFloatDefinition::hasNan           == SourceFloatDefinition::hasNan
+    &&  TargetFloatDefinition::fractionBitCount >= SourceFloatDefinition::fractionBitCount
+    &&  TargetFloatDefinition::fractionBitCount - SourceFloatDefinition::fractionBitCount == TargetFloatDefinition::totalBitCount - SourceFloatDefinition::totalBitCount;
+
+    template <
+        typename SourceFloatDefinition,
+        typename TargetFloatDefinition,
+        RoundingMode roundingMode = RoundingMode::NearestEven
+    >
     static constexpr typename TargetFloatDefinition::baseIntegerType ConvertRawFloatType(typename SourceFloatDefinition::baseIntegerType sourceValue) noexcept
     {
         // Shift the fraction, exponent, and sign from their respective locations in the float32
         // to the target type.
+        // Round the dropped fraction bits per the rounding mode, including into target subnormals.
         // Sature the exponent if greater than can be represented.
         // Flush subnormals to zero if denorms are not supported.
 
         using Source = SourceFloatDefinition;
         using Target = TargetFloatDefinition;
-        using IntermediateType = std::conditional_t<(Source::totalBitCount > Target::totalBitCount), typename Source::baseIntegerType, typename Target::baseIntegerType>;
+        using IntermediateType = RawFloatIntermediateType<Source, Target>;
 
-        if (Target::exponentBitCount == Source::exponentBitCount && Target::hasSign == Source::hasSign)
+        if constexpr (isShiftOnlyConversion<Source, Target>)
         {
-            // Optimized path can just shift. This applies to bfloat16 <-> IEEE float32.
+            // Optimized path can just shift. This applies to bfloat16 -> IEEE float32.
             IntermediateType const sourceIntermediate = IntermediateType(sourceValue);
             IntermediateType const targetValue = LeftRightShift(sourceIntermediate, int32_t(Target::totalBitCount - Source::totalBitCount));
-            return TargetFloatDefinition::baseIntegerType(targetValue);
+            return typename TargetFloatDefinition::baseIntegerType(targetValue);
         }
         else // More complex path.
         {
-            // TODO: Consider rounding when converting to smaller fraction bit count, rather than just truncating them.
-            int32_t constexpr sourceToTargetShift = int32_t(Target::fractionBitCount - Source::fractionBitCount);
-            IntermediateType constexpr exponentAdjustment = IntermediateType(Target::exponentBias - Source::exponentBias) << Target::fractionBitCount;
+            // Work on the significand with the leading one explicit at the top bit of the wider
+            // fraction. Narrowing shifts right by the fraction difference, plus however far below
+            // the target's normal range the value lies, which produces target subnormals (or zero)
+            // through the same rounding. Every case is a comparison, min, or max rather than a
+            // branch, including the final pick among NaN, infinity, zero, and saturation.
+            //
+            // Source subnormals need normalizing (counting leading zeros) only when the target has
+            // more exponent range, so they may become target normals. Otherwise they stay subnormal
+            // in the target, and the unnormalized significand with the minimum exponent is exact.
+            // Likewise, only when the target has less exponent range can results be subnormal and
+            // need the variable shift. Each is known at compile time, and no pair of the defined formats needs both.
+            int32_t constexpr sourceFractionBitCount = int32_t(Source::fractionBitCount);
+            int32_t constexpr targetFractionBitCount = int32_t(Target::fractionBitCount);
+            int32_t constexpr significandTopBit = std::max(sourceFractionBitCount, targetFractionBitCount);
+            int32_t constexpr maximumRightShift = significandTopBit + 2; // Any further rounds the same way.
+            static_assert(maximumRightShift < int32_t(std::max(sizeof(IntermediateType), sizeof(int)) * CHAR_BIT), "Shifts must stay within the type.");
+            bool constexpr isNormalizing = Source::hasSubnormals && (Target::exponentBias > Source::exponentBias);
+            int32_t constexpr smallestTargetExponent = (isNormalizing ? 1 - sourceFractionBitCount : 1) - Source::exponentBias + Target::exponentBias;
+            bool constexpr canBeSubnormal = smallestTargetExponent < 1;
+
             IntermediateType const sourceSign = IntermediateType(sourceValue & Source::signMask);
             IntermediateType const targetSign = LeftRightShift(sourceSign, Target::signBitOffset - Source::signBitOffset);
             IntermediateType const sourceFractionAndExponent = IntermediateType(sourceValue & Source::fractionAndExponentMask);
-            IntermediateType const unadjustedFractionAndExponent = LeftRightShift(sourceFractionAndExponent, sourceToTargetShift);
-            IntermediateType targetFractionAndExponent = unadjustedFractionAndExponent + exponentAdjustment;
-            bool constexpr targetHasSmallerExponent = Target::exponentBitCount < Source::exponentBitCount;
+            IntermediateType const sourceFraction = IntermediateType(sourceFractionAndExponent & Source::fractionMask);
+            int32_t const sourceExponent = int32_t(sourceFractionAndExponent >> Source::fractionBitCount);
+            bool const isNegative = sourceSign != 0;
+            bool const isSourceNormal = sourceExponent != 0;
 
-            // Preserve NaN when both source and target have the property.
-            // If only source or destination has NaN, fall through to saturation below.
-            // NaN is defined is having the maximum exponent and a nonzero fraction.
-            // So the fraction-and-exponent bit value is greater than the exponent mask alone.
-            if (Source::hasNan && Target::hasNan && (sourceFractionAndExponent >= Source::minimumNanBitValue))
+            // Shift subnormals up until their top bit lands where the implicit one would be.
+            // (Sources without subnormals just read them as zero.) Or'ing in one keeps the bit
+            // width from special casing zero, which is a zero significand either way.
+            int32_t normalizingShift = 0;
+            if constexpr (isNormalizing)
             {
-                // Preserve the remaining NaN payload, but ensure the quiet bit is set.
-                targetFractionAndExponent = (targetFractionAndExponent & Target::fractionMask) | Target::minimumNanBitValue | Target::quietNanMask;
+                int32_t const sourceFractionBitWidth = int32_t(std::bit_width(uint64_t(sourceFraction) | 1));
+                normalizingShift = (sourceFractionBitCount + 1 - sourceFractionBitWidth) & BitMaskIf<int32_t>(!isSourceNormal);
             }
-            else if (Source::hasInfinity && Target::hasInfinity && (sourceFractionAndExponent == Source::maximumLegalBitValue))
+            IntermediateType significand = IntermediateType(sourceFraction | (IntermediateType(isSourceNormal) << Source::fractionBitCount));
+            if constexpr (!Source::hasSubnormals)
             {
-                // Just set target to infinity, using the largest value that isn't NaN.
-                targetFractionAndExponent = Target::maximumLegalBitValue;
+                significand &= BitMaskIf<IntermediateType>(isSourceNormal);
+            }
+            significand = IntermediateType(IntermediateType(significand << normalizingShift) << (significandTopBit - sourceFractionBitCount));
+            bool const isZero = significand == 0;
+
+            // Biased target exponent of the significand's top bit, which is below 1 for target subnormals.
+            int32_t const targetExponent = (sourceExponent | !isSourceNormal) - normalizingShift - Source::exponentBias + Target::exponentBias;
+            int32_t rightShift = significandTopBit - targetFractionBitCount;
+            if constexpr (canBeSubnormal)
+            {
+                rightShift = BranchlessMinimum(rightShift + BranchlessMaximum(1 - targetExponent, 0), maximumRightShift);
+            }
+            IntermediateType const truncatedSignificand = IntermediateType(significand >> rightShift);
+            IntermediateType const shiftedOneBitValue = IntermediateType(IntermediateType(1) << rightShift);
+            IntermediateType const droppedBits = IntermediateType(significand & (shiftedOneBitValue - 1));
+
+            // Round by incrementing the truncated value, which carries into the exponent if the
+            // fraction was all ones. The increment is a comparison result (0 or 1), not a branch.
+            IntermediateType roundingIncrement = 0;
+            if constexpr (roundingMode == RoundingMode::NearestEven)
+            {
+                // Above halfway rounds up, as does exactly halfway when the kept lowest bit is odd.
+                // Doubling the dropped bits compares against half without a special case for no shift.
+                roundingIncrement = IntermediateType((droppedBits << 1) + (truncatedSignificand & 1)) > shiftedOneBitValue;
+            }
+            else if constexpr (roundingMode == RoundingMode::Up)
+            {
+                roundingIncrement = (droppedBits != 0) & !isNegative;
             }
-            else if (
-                (sourceFractionAndExponent == 0)
-            ||  (targetHasSmallerExponent && targetFractionAndExponent > unadjustedFractionAndExponent) // Underflow
-            ||  (!targetHasSmallerExponent && targetFractionAndExponent < unadjustedFractionAndExponent) // Underflow
-            ||  (!Target::hasSubnormals && targetFractionAndExponent <= Target::fractionMask) // Flush subnormals to zero
-                )
+            else if constexpr (roundingMode == RoundingMode::Down)
             {
-                targetFractionAndExponent = 0;
+                roundingIncrement = (droppedBits != 0) & isNegative;
             }
-            else if (targetFractionAndExponent > Target::maximumLegalBitValue)
+
+            // The significand's leading one adds one to the exponent field (except for subnormals,
+            // which have none), so add the clamped exponent less one.
+            int32_t const clampedTargetExponent = BranchlessMinimum(BranchlessMaximum(targetExponent, 1), Target::exponentMax);
+            IntermediateType targetFractionAndExponent = IntermediateType(
+                IntermediateType(IntermediateType(clampedTargetExponent - 1) << Target::fractionBitCount)
+                + truncatedSignificand + roundingIncrement
+            );
+
+            // Overflow rounds to infinity only when rounding away from zero, else to the largest finite value.
+            // (Formats without infinity saturate either way.)
+            bool const isRoundingAwayFromZero = (roundingMode == RoundingMode::NearestEven)
+                                             || (roundingMode == RoundingMode::Up && !isNegative)
+                                             || (roundingMode == RoundingMode::Down && isNegative);
+            IntermediateType constexpr largestFiniteBitValue = Target::hasInfinity ? Target::maximumLegalBitValue - 1 : Target::maximumLegalBitValue;
+            // NaN's have the maximum exponent, or are all ones in formats without infinity.
+            IntermediateType constexpr nanBitValue = Target::hasInfinity ? Target::exponentMask : Target::minimumNanBitValue;
+            // Source infinity and NaN which the target cannot represent saturate too.
+            IntermediateType constexpr sourceSpecialBitValue = Source::hasInfinity ? Source::exponentMask : Source::minimumNanBitValue;
+            bool const isSourceSpecial = (Source::hasInfinity || Source::hasNan) && (sourceFractionAndExponent >= sourceSpecialBitValue);
+            bool const isOverflow = isSourceSpecial
+                                  | (targetExponent > Target::exponentMax)
+                                  | (targetFractionAndExponent > largestFiniteBitValue);
+            bool const isUnderflow = isZero | (!Target::hasSubnormals && targetFractionAndExponent <= Target::fractionMask); // Flush subnormals to zero
+
+            // Select from the lowest priority case up: saturation, underflow, infinity, then NaN.
+            IntermediateType const saturatedValue = SelectIf<IntermediateType>(isRoundingAwayFromZero, Target::maximumLegalBitValue, largestFiniteBitValue);
+            targetFractionAndExponent = SelectIf(isOverflow, saturatedValue, targetFractionAndExponent);
+            targetFractionAndExponent &= BitMaskIf<IntermediateType>(!isUnderflow);
+
+            if constexpr (Source::hasInfinity && Target::hasInfinity)
             {
-                // Saturate to maximal positive value just before NaN.
-                targetFractionAndExponent = Target::maximumLegalBitValue;
+                // Just set target to infinity, using the largest value that isn't NaN.
+                bool const isInfinity = sourceFractionAndExponent == Source::maximumLegalBitValue;
+                targetFractionAndExponent = SelectIf<IntermediateType>(isInfinity, Target::maximumLegalBitValue, targetFractionAndExponent);
+            }
+
+            // Preserve NaN when both source and target have the property.
+            // If only source or destination has NaN, it saturates above.
+            // NaN is defined is having the maximum exponent and a nonzero fraction.
+            // So the fraction-and-exponent bit value is greater than the exponent mask alone.
+            if constexpr (Source::hasNan && Target::hasNan)
+            {
+                // Preserve the remaining NaN payload (truncated, not rounded), but ensure the quiet bit is set.
+                bool const isNan = sourceFractionAndExponent >= Source::minimumNanBitValue;
+                IntermediateType const nanPayload = IntermediateType(LeftRightShift(sourceFraction, targetFractionBitCount - sourceFractionBitCount) & Target::fractionMask);
+                targetFractionAndExponent = SelectIf<IntermediateType>(isNan, nanPayload | nanBitValue | Target::quietNanMask, targetFractionAndExponent);
             }
 
             IntermediateType targetValue = targetFractionAndExponent | targetSign;
-            return TargetFloatDefinition::baseIntegerType(targetValue);
+            return typename TargetFloatDefinition::baseIntegerType(targetValue);
         }
     }
 
+
+    // 8-bit formats have only 256 bit patterns, so decoding is a single table lookup.
+    // Encoding is a binary search over the rounding thresholds between adjacent
+    // magnitudes, compared as float32 bits (non-negative floats order like integers).
+    // The tables are computed directly from the bit fields rather than via
+    // ConvertRawFloatType, and rounding is to nearest with ties to even.
+    template <typename FloatDefinition>
+    struct Float8CodecTables
+    {
+        static_assert(FloatDefinition::totalBitCount == 8);
+
+        // Power of two capacity for the magnitudes, so the binary search needs no bounds checks.
+        static constexpr uint32_t magnitudeCapacity = 1u << (FloatDefinition::totalBitCount - FloatDefinition::hasSign);
+
+        float decode[256];                      // Indexed by raw bits.
+        int32_t thresholds[magnitudeCapacity];  // Smallest float32 bits rounding to each magnitude, ascending.
+        int32_t codes[magnitudeCapacity];       // Raw bits of each magnitude.
+        int32_t nanCode;                        // Raw bits of the quiet NaN, or zero if there is no NaN.
+    };
+
+    constexpr float MultiplyByPowerOfTwo(float value, int32_t exponent) noexcept
+    {
+        for (; exponent > 0; --exponent) value *= 2;
+        for (; exponent < 0; ++exponent) value /= 2;
+        return value;
+    }
+
+    template <typename FloatDefinition>
+    constexpr float DecodeFloat8BitsSlowly(uint32_t bits) noexcept
+    {
+        using Definition = FloatDefinition;
+        uint32_t const magnitude = bits & Definition::fractionAndExponentMask;
+        bool const isNegative = (bits & Definition::signMask) != 0;
+        uint32_t const signBits = isNegative ? 0x80000000 : 0;
+
+        if (Definition::hasNan && magnitude >= Definition::minimumNanBitValue)
+        {
+            // Quiet NaN, keeping the payload in the upper fraction bits.
+            uint32_t const payload = (magnitude & Definition::fractionMask) << (23 - Definition::fractionBitCount);
+            return std::bit_cast<float>(signBits | 0x7FC00000 | payload);
+        }
+        if (Definition::hasInfinity && magnitude >= Definition::exponentMask)
+        {
+            return std::bit_cast<float>(signBits | 0x7F800000);
+        }
+
+        int32_t const exponent = int32_t(magnitude >> Definition::fractionBitCount);
+        uint32_t fraction = magnitude & Definition::fractionMask;
+        if (exponent > 0)
+        {
+            fraction |= Definition::fractionMask + 1; // Hidden one.
+        }
+        else if (!Definition::hasSubnormals)
+        {
+            fraction = 0;
+        }
+        int32_t const scale = std::max(exponent, 1) - Definition::exponentBias - int32_t(Definition::fractionBitCount);
+        float const value = MultiplyByPowerOfTwo(float(fraction), scale);
+        return isNegative ? -value : value;
+    }
+
+    template <typename FloatDefinition>
+    constexpr Float8CodecTables<FloatDefinition> MakeFloat8CodecTables() noexcept
+    {
+        using Definition = FloatDefinition;
+        using Tables = Float8CodecTables<Definition>;
+        Tables tables = {};
+
+        for (uint32_t bits = 0; bits < 256; ++bits)
+        {
+            tables.decode[bits] = DecodeFloat8BitsSlowly<Definition>(bits);
+        }
+
+        // Collect the finite non-negative magnitudes in ascending order. The threshold of each
+        // is the midpoint from the previous one, where ties go to the even code.
+        uint32_t count = 0;
+        float previousValue = 0;
+        for (uint32_t bits = 0; bits < Tables::magnitudeCapacity; ++bits)
+        {
+            float const value = tables.decode[bits];
+            bool const isFinite = (std::bit_cast<uint32_t>(value) & 0x7F800000) != 0x7F800000;
+            if (!isFinite || (bits > 0 && value == 0))
+            {
+                continue; // Skip NaN, infinity, and flushed subnormals.
+            }
+            float const midpoint = (previousValue + value) / 2;
+            tables.thresholds[count] = (count == 0) ? 0 : std::bit_cast<int32_t>(midpoint) + int32_t(bits & 1);
+            tables.codes[count] = int32_t(bits);
+            previousValue = value;
+            ++count;
+        }
+
+        // Overflow rounds to infinity if the format has it (at the midpoint to the next binade,
+        // just like IEEE), else saturates to the largest finite value.
+        if (Definition::hasInfinity)
+        {
+            float const largestValue = previousValue;
+            float const secondLargestValue = tables.decode[tables.codes[count - 2]];
+            float const midpoint = largestValue + (largestValue - secondLargestValue) / 2;
+            tables.thresholds[count] = std::bit_cast<int32_t>(midpoint) + int32_t(Definition::exponentMask & 1);
+            tables.codes[count] = int32_t(Definition::exponentMask);
+            ++count;
+        }
+
+        for (uint32_t i = count; i < Tables::magnitudeCapacity; ++i)
+        {
+            tables.thresholds[i] = 0x7FFFFFFF; // Unreachable by any non-NaN.
+            tables.codes[i] = tables.codes[count - 1];
+        }
+
+        tables.nanCode = !Definition::hasNan    ? 0
+                       : Definition::hasInfinity ? int32_t(Definition::exponentMask | Definition::quietNanMask)
+                       : int32_t(Definition::minimumNanBitValue);
+
+        return tables;
+    }
+
+    template <typename FloatDefinition>
+    inline constexpr Float8CodecTables<FloatDefinition> g_float8CodecTables = MakeFloat8CodecTables<FloatDefinition>();
+
+    template <typename FloatDefinition>
+    inline float ConvertFloat8BitsToFloat32(uint8_t value) noexcept
+    {
+        return g_float8CodecTables<FloatDefinition>.decode[value];
+    }
+
+    template <typename FloatDefinition>
+    inline uint8_t ConvertFloat32ToFloat8Bits(float value) noexcept
+    {
+        using Definition = FloatDefinition;
+        using Tables = Float8CodecTables<Definition>;
+        Tables const& tables = g_float8CodecTables<Definition>;
+
+        uint32_t const bits = std::bit_cast<uint32_t>(value);
+        int32_t const absoluteBits = int32_t(bits & 0x7FFFFFFF);
+        bool const isNegative = (bits >> 31) != 0;
+        if (absoluteBits > 0x7F800000)
+        {
+            return uint8_t(tables.nanCode | (isNegative ? Definition::signMask : 0));
+        }
+
+        uint32_t index = 0;
+        for (uint32_t step = Tables::magnitudeCapacity / 2; step > 0; step /= 2)
+        {
+            index += (absoluteBits >= tables.thresholds[index + step]) ? step : 0;
+        }
+
+        int32_t const code = tables.codes[index];
+        if constexpr (Definition::hasSign)
+        {
+            return uint8_t(code | (isNegative ? Definition::signMask : 0));
+        }
+        else
+        {
+            return uint8_t(isNegative ? 0 : code); // Clamp negatives to zero.
+        }
+    }
+
+    // Narrow float64 to float32, rounding inexact results to odd. Rounding that again to any
+    // format with at least two fewer fraction bits gives the same result as rounding directly.
+    inline float ConvertFloat64ToFloat32RoundToOdd(double value) noexcept
+    {
+        float narrowedValue = float(value);
+        uint32_t bits = std::bit_cast<uint32_t>(narrowedValue);
+        if (std::abs(double(narrowedValue)) > std::abs(value))
+        {
+            --bits; // Round toward zero instead (including finite overflow from infinity).
+        }
+        if (double(std::bit_cast<float>(bits)) != value && value == value)
+        {
+            bits |= 1;
+        }
+        return std::bit_cast<float>(bits);
+    }
+
+    template <typename FloatDefinition>
+    inline uint8_t ConvertFloat64ToFloat8Bits(double value) noexcept
+    {
+        return ConvertFloat32ToFloat8Bits<FloatDefinition>(ConvertFloat64ToFloat32RoundToOdd(value));
+    }
+
 } // namespace FloatNumberDetails
 
 
@@ -199,14 +524,31 @@ struct FloatNumber
     FloatNumber(const FloatNumber&) = default;
     FloatNumber(FloatNumber&&) = default;
 
+    // 8-bit types use the lookup tables instead.
+    static constexpr bool usesFloat8CodecTables = (SelfDefinition::totalBitCount == 8);
+
     constexpr FloatNumber(float floatValue) noexcept
     {
-        value = FloatNumberDetails::ConvertRawFloatType<FloatNumberDetails::Float32Definition, SelfDefinition>(reinterpret_cast<uint32_t&>(floatValue));
+        if constexpr (usesFloat8CodecTables)
+        {
+            value = FloatNumberDetails::ConvertFloat32ToFloat8Bits<SelfDefinition>(floatValue);
+        }
+        else
+        {
+            value = FloatNumberDetails::ConvertRawFloatType<FloatNumberDetails::Float32Definition, SelfDefinition>(reinterpret_cast<uint32_t&>(floatValue));
+        }
     }
 
     constexpr FloatNumber(double floatValue) noexcept
     {
-        value = FloatNumberDetails::ConvertRawFloatType<FloatNumberDetails::Float64Definition, SelfDefinition>(reinterpret_cast<uint64_t&>(floatValue));
+        if constexpr (usesFloat8CodecTables)
+        {
+            value = FloatNumberDetails::ConvertFloat64ToFloat8Bits<SelfDefinition>(floatValue);
+        }
+        else
+        {
+            value = FloatNumberDetails::ConvertRawFloatType<FloatNumberDetails::Float64Definition, SelfDefinition>(reinterpret_cast<uint64_t&>(floatValue));
+        }
     }
 
     constexpr FloatNumber& operator =(const FloatNumber&) noexcept = default;
@@ -225,16 +567,30 @@ struct FloatNumber
 
     constexpr operator float() const noexcept
     {
-        float floatValue;
-        reinterpret_cast<uint32_t&>(floatValue) = FloatNumberDetails::ConvertRawFloatType<SelfDefinition, FloatNumberDetails::Float32Definition>(value);
-        return floatValue;
+        if constexpr (usesFloat8CodecTables)
+        {
+            return FloatNumberDetails::ConvertFloat8BitsToFloat32<SelfDefinition>(value);
+        }
+        else
+        {
+            float floatValue;
+            reinterpret_cast<uint32_t&>(floatValue) = FloatNumberDetails::ConvertRawFloatType<SelfDefinition, FloatNumberDetails::Float32Definition>(value);
+            return floatValue;
+        }
     }
 
     constexpr operator double() const noexcept
     {
-        double floatValue;
-        reinterpret_cast<uint64_t&>(floatValue) = FloatNumberDetails::ConvertRawFloatType<SelfDefinition, FloatNumberDetails::Float64Definition>(value);
-        return floatValue;
+        if constexpr (usesFloat8CodecTables)
+        {
+            return FloatNumberDetails::ConvertFloat8BitsToFloat32<SelfDefinition>(value);
+        }
+        else
+        {
+            double floatValue;
+            reinterpret_cast<uint64_t&>(floatValue) = FloatNumberDetails::ConvertRawFloatType<SelfDefinition, FloatNumberDetails::Float64Definition>(value);
+            return floatValue;
+        }
     }
 
     constexpr BaseIntegerType GetRawBits() const noexcept
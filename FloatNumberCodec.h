@@ -0,0 +1,447 @@
+//-----------------------------------------------------------------------------
+//
+//  Bulk conversion between any two FloatDefinitions.
+//
+//  ConvertRawFloatType (see FloatNumber.h) is the reference. The AVX2 kernel
+//  here is the same logic for a whole vector of lanes at once, with each of
+//  the NaN, infinity, underflow, and saturation cases computed for every lane
+//  and then blended in by priority. Since the masks and shifts all come from
+//  the FloatDefinitions, any pair of formats (including future ones) gets a
+//  vectorized path without a hand-written kernel. Rounding defaults to
+//  nearest even, and the other RoundingModes are chosen at compile time.
+//
+//  Subnormals on either side go through per-lane variable shifts, with the
+//  bit width for normalizing taken from a conversion to floating point, so
+//  lanes are 32 bits (64 for float64) even for the narrower formats.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#if BINUMS_X86
+
+namespace FloatNumberCodecDetails
+{
+    // Lanes are 32 bits, or 64 for 64-bit formats. Narrower formats are widened on load, since
+    // AVX2 has variable shifts only for 32 and 64-bit lanes, and converting to floating point
+    // (for the bit width) only from 32-bit lanes.
+    template <typename IntermediateType>
+    struct Avx2Lanes
+    {
+        using LaneType = std::conditional_t<sizeof(IntermediateType) == sizeof(uint64_t), uint64_t, uint32_t>;
+        static constexpr size_t laneBitCount = sizeof(LaneType) * CHAR_BIT;
+        static constexpr size_t laneCount = sizeof(__m256i) / sizeof(LaneType);
+
+        BINUMS_TARGET("avx2")
+        static __m256i Set(LaneType value) noexcept
+        {
+            if constexpr (laneBitCount == 64) return _mm256_set1_epi64x(int64_t(value));
+            if constexpr (laneBitCount == 32) return _mm256_set1_epi32(int32_t(value));
+        }
+
+        BINUMS_TARGET("avx2")
+        static __m256i Add(__m256i a, __m256i b) noexcept
+        {
+            if constexpr (laneBitCount == 64) return _mm256_add_epi64(a, b);
+            if constexpr (laneBitCount == 32) return _mm256_add_epi32(a, b);
+        }
+
+        BINUMS_TARGET("avx2")
+        static __m256i Subtract(__m256i a, __m256i b) noexcept
+        {
+            if constexpr (laneBitCount == 64) return _mm256_sub_epi64(a, b);
+            if constexpr (laneBitCount == 32) return _mm256_sub_epi32(a, b);
+        }
+
+        // Same as FloatNumberDetails::LeftRightShift.
+        template <int32_t shift>
+        BINUMS_TARGET("avx2")
+        static __m256i LeftRightShift(__m256i value) noexcept
+        {
+            if constexpr (shift > 0)
+            {
+                if constexpr (laneBitCount == 64) return _mm256_slli_epi64(value, shift);
+                if constexpr (laneBitCount == 32) return _mm256_slli_epi32(value, shift);
+            }
+            else if constexpr (shift < 0)
+            {
+                if constexpr (laneBitCount == 64) return _mm256_srli_epi64(value, -shift);
+                if constexpr (laneBitCount == 32) return _mm256_srli_epi32(value, -shift);
+            }
+            else
+            {
+                return value;
+            }
+        }
+
+        // Shift each lane by its own count.
+        BINUMS_TARGET("avx2")
+        static __m256i ShiftLeftVariable(__m256i value, __m256i count) noexcept
+        {
+            if constexpr (laneBitCount == 64) return _mm256_sllv_epi64(value, count);
+            if constexpr (laneBitCount == 32) return _mm256_sllv_epi32(value, count);
+        }
+
+        BINUMS_TARGET("avx2")
+        static __m256i ShiftRightVariable(__m256i value, __m256i count) noexcept
+        {
+            if constexpr (laneBitCount == 64) return _mm256_srlv_epi64(value, count);
+            if constexpr (laneBitCount == 32) return _mm256_srlv_epi32(value, count);
+        }
+
+        BINUMS_TARGET("avx2")
+        static __m256i CompareEqual(__m256i a, __m256i b) noexcept
+        {
+            if constexpr (laneBitCount == 64) return _mm256_cmpeq_epi64(a, b);
+            if constexpr (laneBitCount == 32) return _mm256_cmpeq_epi32(a, b);
+        }
+
+        // Unsigned a > b, by flipping the top bit for the signed compare.
+        BINUMS_TARGET("avx2")
+        static __m256i CompareGreater(__m256i a, __m256i b) noexcept
+        {
+            __m256i const topBit = Set(LaneType(LaneType(1) << (laneBitCount - 1)));
+            return CompareGreaterSigned(_mm256_xor_si256(a, topBit), _mm256_xor_si256(b, topBit));
+        }
+
+        // Signed a > b, for exponents which go below zero.
+        BINUMS_TARGET("avx2")
+        static __m256i CompareGreaterSigned(__m256i a, __m256i b) noexcept
+        {
+            if constexpr (laneBitCount == 64) return _mm256_cmpgt_epi64(a, b);
+            if constexpr (laneBitCount == 32) return _mm256_cmpgt_epi32(a, b);
+        }
+
+        // Select a where the mask is set, else b.
+        BINUMS_TARGET("avx2")
+        static __m256i Select(__m256i mask, __m256i a, __m256i b) noexcept
+        {
+            return _mm256_blendv_epi8(b, a, mask);
+        }
+
+        // Signed maximum.
+        BINUMS_TARGET("avx2")
+        static __m256i Maximum(__m256i a, __m256i b) noexcept
+        {
+            if constexpr (laneBitCount == 64) return Select(CompareGreaterSigned(a, b), a, b);
+            if constexpr (laneBitCount == 32) return _mm256_max_epi32(a, b);
+        }
+
+        // Signed minimum.
+        BINUMS_TARGET("avx2")
+        static __m256i Minimum(__m256i a, __m256i b) noexcept
+        {
+            if constexpr (laneBitCount == 64) return Select(CompareGreaterSigned(a, b), b, a);
+            if constexpr (laneBitCount == 32) return _mm256_min_epi32(a, b);
+        }
+
+        // Same as std::bit_width, for values which convert exactly to floating point (below 2^24
+        // in 32-bit lanes or 2^52 in 64-bit lanes), as any fraction does. The exponent field is
+        // then the position of the top bit, standing in for the count leading zeros AVX2 lacks.
+        BINUMS_TARGET("avx2")
+        static __m256i BitWidth(__m256i value) noexcept
+        {
+            if constexpr (laneBitCount == 64)
+            {
+                // Placing the value in the fraction of 2^52 and subtracting 2^52 converts it exactly.
+                __m256i const magicBits = _mm256_set1_epi64x(0x4330000000000000);
+                __m256d const converted = _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(value, magicBits)), _mm256_castsi256_pd(magicBits));
+                __m256i const exponent = _mm256_srli_epi64(_mm256_castpd_si256(converted), 52);
+                return Maximum(_mm256_sub_epi64(exponent, _mm256_set1_epi64x(1022)), _mm256_setzero_si256());
+            }
+            if constexpr (laneBitCount == 32)
+            {
+                __m256i const exponent = _mm256_srli_epi32(_mm256_castps_si256(_mm256_cvtepi32_ps(value)), 23);
+                return _mm256_max_epi32(_mm256_sub_epi32(exponent, _mm256_set1_epi32(126)), _mm256_setzero_si256());
+            }
+        }
+
+        // Read laneCount elements, zero extended.
+        template <typename T>
+        BINUMS_TARGET("avx2")
+        static __m256i Load(T const* input) noexcept
+        {
+            static_assert(sizeof(T) <= sizeof(LaneType));
+
+            if constexpr (sizeof(T) == sizeof(LaneType))
+            {
+                return _mm256_loadu_si256(reinterpret_cast<__m256i const*>(input));
+            }
+            else if constexpr (laneBitCount == 64)
+            {
+                if constexpr (sizeof(T) == sizeof(uint32_t)) return _mm256_cvtepu32_epi64(_mm_loadu_si128(reinterpret_cast<__m128i const*>(input)));
+                if constexpr (sizeof(T) == sizeof(uint16_t)) return _mm256_cvtepu16_epi64(_mm_loadl_epi64(reinterpret_cast<__m128i const*>(input)));
+                if constexpr (sizeof(T) == sizeof(uint8_t))
+                {
+                    int32_t bytes;
+                    memcpy(&bytes, input, sizeof(bytes));
+                    return _mm256_cvtepu8_epi64(_mm_cvtsi32_si128(bytes));
+                }
+            }
+            else
+            {
+                if constexpr (sizeof(T) == sizeof(uint16_t)) return _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<__m128i const*>(input)));
+                if constexpr (sizeof(T) == sizeof(uint8_t))  return _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<__m128i const*>(input)));
+            }
+        }
+
+        // Write laneCount elements, truncating each lane to T.
+        template <typename T>
+        BINUMS_TARGET("avx2")
+        static void Store(/*out*/ T* output, __m256i value) noexcept
+        {
+            static_assert(sizeof(T) <= sizeof(LaneType));
+
+            if constexpr (sizeof(T) == sizeof(LaneType))
+            {
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(output), value);
+                return;
+            }
+            else
+            {
+                // Clear the upper bits so the saturating packs below act as truncation.
+                value = _mm256_and_si256(value, Set(LaneType(T(~T(0)))));
+
+                __m128i packed; // Elements of uint16_t.
+                if constexpr (laneBitCount == 64)
+                {
+                    __m128i const packed32 = _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(value, _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6)));
+                    if constexpr (sizeof(T) == sizeof(uint32_t))
+                    {
+                        _mm_storeu_si128(reinterpret_cast<__m128i*>(output), packed32);
+                        return;
+                    }
+                    packed = _mm_packus_epi32(packed32, packed32);
+                }
+                else
+                {
+                    packed = _mm_packus_epi32(_mm256_castsi256_si128(value), _mm256_extracti128_si256(value, 1));
+                }
+
+                if constexpr (sizeof(T) == sizeof(uint16_t))
+                {
+                    if constexpr (laneBitCount == 64) _mm_storel_epi64(reinterpret_cast<__m128i*>(output), packed);
+                    else                              _mm_storeu_si128(reinterpret_cast<__m128i*>(output), packed);
+                }
+                else if constexpr (sizeof(T) == sizeof(uint8_t))
+                {
+                    packed = _mm_packus_epi16(packed, packed);
+                    if constexpr (laneBitCount == 64)
+                    {
+                        int32_t const bytes = _mm_cvtsi128_si32(packed);
+                        memcpy(output, &bytes, sizeof(bytes));
+                    }
+                    else
+                    {
+                        _mm_storel_epi64(reinterpret_cast<__m128i*>(output), packed);
+                    }
+                }
+            }
+        }
+    };
+
+    // Same logic as FloatNumberDetails::ConvertRawFloatType, just for a vector of lanes.
+    template <
+        typename SourceFloatDefinition,
+        typename TargetFloatDefinition,
+        FloatNumberDetails::RoundingMode roundingMode
+    >
+    BINUMS_TARGET("avx2")
+    inline __m256i ConvertRawFloatTypeAvx2(__m256i sourceValue) noexcept
+    {
+        using FloatNumberDetails::RoundingMode;
+        using Source = SourceFloatDefinition;
+        using Target = TargetFloatDefinition;
+        using IntermediateType = FloatNumberDetails::RawFloatIntermediateType<Source, Target>;
+        using Lanes = Avx2Lanes<IntermediateType>;
+        using LaneType = typename Lanes::LaneType;
+
+        if constexpr (FloatNumberDetails::isShiftOnlyConversion<Source, Target>)
+        {
+            return Lanes::template LeftRightShift<int32_t(Target::totalBitCount) - int32_t(Source::totalBitCount)>(sourceValue);
+        }
+        else
+        {
+            constexpr int32_t sourceFractionBitCount = int32_t(Source::fractionBitCount);
+            constexpr int32_t targetFractionBitCount = int32_t(Target::fractionBitCount);
+            constexpr int32_t significandTopBit = std::max(sourceFractionBitCount, targetFractionBitCount);
+            constexpr int32_t maximumRightShift = significandTopBit + 2;
+            constexpr bool isNormalizing = Source::hasSubnormals && (Target::exponentBias > Source::exponentBias);
+            constexpr int32_t smallestTargetExponent = (isNormalizing ? 1 - sourceFractionBitCount : 1) - Source::exponentBias + Target::exponentBias;
+            constexpr bool canBeSubnormal = smallestTargetExponent < 1;
+            static_assert(sourceFractionBitCount < (Lanes::laneBitCount == 64 ? 52 + 1 : 24), "BitWidth needs the fraction to convert exactly.");
+
+            __m256i const zero = _mm256_setzero_si256();
+            __m256i const one = Lanes::Set(1);
+            __m256i const sourceSign = _mm256_and_si256(sourceValue, Lanes::Set(Source::signMask));
+            __m256i const targetSign = Lanes::template LeftRightShift<int32_t(Target::signBitOffset) - int32_t(Source::signBitOffset)>(sourceSign);
+            __m256i const sourceFractionAndExponent = _mm256_and_si256(sourceValue, Lanes::Set(Source::fractionAndExponentMask));
+            __m256i const sourceFraction = _mm256_and_si256(sourceFractionAndExponent, Lanes::Set(Source::fractionMask));
+            __m256i const sourceExponent = Lanes::template LeftRightShift<-sourceFractionBitCount>(sourceFractionAndExponent);
+            __m256i const isNegative = _mm256_xor_si256(Lanes::CompareEqual(sourceSign, zero), _mm256_set1_epi32(-1));
+            __m256i const isSourceSubnormal = Lanes::CompareEqual(sourceExponent, zero);
+
+            __m256i significand = _mm256_or_si256(sourceFraction, _mm256_andnot_si256(isSourceSubnormal, Lanes::Set(LaneType(1) << sourceFractionBitCount)));
+            if constexpr (!Source::hasSubnormals)
+            {
+                significand = _mm256_andnot_si256(isSourceSubnormal, significand);
+            }
+            __m256i normalizingShift = zero;
+            if constexpr (isNormalizing)
+            {
+                normalizingShift = _mm256_and_si256(isSourceSubnormal, Lanes::Subtract(Lanes::Set(sourceFractionBitCount + 1), Lanes::BitWidth(sourceFraction)));
+                significand = Lanes::ShiftLeftVariable(significand, normalizingShift);
+            }
+            significand = Lanes::template LeftRightShift<significandTopBit - sourceFractionBitCount>(significand);
+            __m256i const isZero = Lanes::CompareEqual(significand, zero);
+
+            __m256i const targetExponent = Lanes::Add(
+                Lanes::Subtract(Lanes::Maximum(sourceExponent, one), normalizingShift),
+                Lanes::Set(LaneType(Target::exponentBias - Source::exponentBias))
+            );
+            __m256i truncatedSignificand, shiftedOneBitValue;
+            if constexpr (canBeSubnormal)
+            {
+                __m256i const rightShift = Lanes::Minimum(
+                    Lanes::Add(Lanes::Maximum(Lanes::Subtract(one, targetExponent), zero), Lanes::Set(significandTopBit - targetFractionBitCount)),
+                    Lanes::Set(maximumRightShift)
+                );
+                truncatedSignificand = Lanes::ShiftRightVariable(significand, rightShift);
+                shiftedOneBitValue = Lanes::ShiftLeftVariable(one, rightShift);
+            }
+            else
+            {
+                truncatedSignificand = Lanes::template LeftRightShift<targetFractionBitCount - significandTopBit>(significand);
+                shiftedOneBitValue = Lanes::Set(LaneType(1) << (significandTopBit - targetFractionBitCount));
+            }
+            __m256i const droppedBits = _mm256_and_si256(significand, Lanes::Subtract(shiftedOneBitValue, one));
+
+            // The rounding increment is the comparison mask (all ones) masked down to one.
+            __m256i isRoundingUp = zero;
+            if constexpr (roundingMode == RoundingMode::NearestEven)
+            {
+                __m256i const lowestBit = _mm256_and_si256(truncatedSignificand, one);
+                isRoundingUp = Lanes::CompareGreater(Lanes::Add(Lanes::template LeftRightShift<1>(droppedBits), lowestBit), shiftedOneBitValue);
+            }
+            else if constexpr (roundingMode == RoundingMode::Up || roundingMode == RoundingMode::Down)
+            {
+                __m256i const hasDroppedBits = _mm256_xor_si256(Lanes::CompareEqual(droppedBits, zero), _mm256_set1_epi32(-1));
+                isRoundingUp = (roundingMode == RoundingMode::Up)
+                             ? _mm256_andnot_si256(isNegative, hasDroppedBits)
+                             : _mm256_and_si256(isNegative, hasDroppedBits);
+            }
+
+            __m256i const clampedTargetExponent = Lanes::Minimum(Lanes::Maximum(targetExponent, one), Lanes::Set(Target::exponentMax));
+            __m256i const targetFractionAndExponent = Lanes::Add(
+                Lanes::template LeftRightShift<targetFractionBitCount>(Lanes::Subtract(clampedTargetExponent, one)),
+                Lanes::Add(truncatedSignificand, _mm256_and_si256(isRoundingUp, one))
+            );
+
+            // Blend from the lowest priority case up: saturation, zero, infinity, then NaN.
+            constexpr IntermediateType largestFiniteBitValue = Target::hasInfinity ? Target::maximumLegalBitValue - 1 : Target::maximumLegalBitValue;
+            __m256i saturatedValue = Lanes::Set(Target::maximumLegalBitValue);
+            if constexpr (roundingMode == RoundingMode::TowardZero)
+            {
+                saturatedValue = Lanes::Set(largestFiniteBitValue);
+            }
+            else if constexpr (roundingMode == RoundingMode::Up)
+            {
+                saturatedValue = Lanes::Select(isNegative, Lanes::Set(largestFiniteBitValue), saturatedValue);
+            }
+            else if constexpr (roundingMode == RoundingMode::Down)
+            {
+                saturatedValue = Lanes::Select(isNegative, saturatedValue, Lanes::Set(largestFiniteBitValue));
+            }
+            __m256i isOverflow = _mm256_or_si256(
+                Lanes::CompareGreaterSigned(targetExponent, Lanes::Set(Target::exponentMax)),
+                Lanes::CompareGreater(targetFractionAndExponent, Lanes::Set(largestFiniteBitValue))
+            );
+            if constexpr (Source::hasInfinity || Source::hasNan)
+            {
+                constexpr IntermediateType sourceSpecialBitValue = Source::hasInfinity ? Source::exponentMask : Source::minimumNanBitValue;
+                isOverflow = _mm256_or_si256(isOverflow, Lanes::CompareGreater(sourceFractionAndExponent, Lanes::Set(sourceSpecialBitValue - 1)));
+            }
+            __m256i result = Lanes::Select(isOverflow, saturatedValue, targetFractionAndExponent);
+
+            __m256i isUnderflow = isZero;
+            if constexpr (!Target::hasSubnormals)
+            {
+                __m256i const isSubnormal = Lanes::CompareGreater(Lanes::Set(Target::fractionMask + 1), targetFractionAndExponent);
+                isUnderflow = _mm256_or_si256(isUnderflow, isSubnormal);
+            }
+            result = _mm256_andnot_si256(isUnderflow, result);
+
+            if constexpr (Source::hasInfinity && Target::hasInfinity)
+            {
+                __m256i const isInfinity = Lanes::CompareEqual(sourceFractionAndExponent, Lanes::Set(Source::maximumLegalBitValue));
+                result = Lanes::Select(isInfinity, Lanes::Set(Target::maximumLegalBitValue), result);
+            }
+
+            if constexpr (Source::hasNan && Target::hasNan)
+            {
+                __m256i const isNan = Lanes::CompareGreater(sourceFractionAndExponent, Lanes::Set(Source::minimumNanBitValue - 1));
+                __m256i const nan = _mm256_or_si256(
+                    _mm256_and_si256(Lanes::template LeftRightShift<targetFractionBitCount - sourceFractionBitCount>(sourceFraction), Lanes::Set(Target::fractionMask)),
+                    Lanes::Set((Target::hasInfinity ? Target::exponentMask : Target::minimumNanBitValue) | Target::quietNanMask)
+                );
+                result = Lanes::Select(isNan, nan, result);
+            }
+
+            return _mm256_or_si256(result, targetSign);
+        }
+    }
+} // namespace FloatNumberCodecDetails
+
+template <
+    typename SourceFloatDefinition,
+    typename TargetFloatDefinition,
+    FloatNumberDetails::RoundingMode roundingMode = FloatNumberDetails::RoundingMode::NearestEven
+>
+BINUMS_TARGET("avx2")
+inline void ConvertRawFloatTypeArrayAvx2(
+    typename SourceFloatDefinition::baseIntegerType const* input,
+    /*out*/ typename TargetFloatDefinition::baseIntegerType* output,
+    size_t count
+    ) noexcept
+{
+    using namespace FloatNumberCodecDetails;
+    using IntermediateType = FloatNumberDetails::RawFloatIntermediateType<SourceFloatDefinition, TargetFloatDefinition>;
+    using Lanes = Avx2Lanes<IntermediateType>;
+
+    size_t i = 0;
+    for (; i + Lanes::laneCount <= count; i += Lanes::laneCount)
+    {
+        __m256i const sourceValue = Lanes::Load(input + i);
+        Lanes::Store(/*out*/ output + i, ConvertRawFloatTypeAvx2<SourceFloatDefinition, TargetFloatDefinition, roundingMode>(sourceValue));
+    }
+    for (; i < count; ++i)
+    {
+        output[i] = FloatNumberDetails::ConvertRawFloatType<SourceFloatDefinition, TargetFloatDefinition, roundingMode>(input[i]);
+    }
+}
+
+#endif // BINUMS_X86
+
+template <
+    typename SourceFloatDefinition,
+    typename TargetFloatDefinition,
+    FloatNumberDetails::RoundingMode roundingMode = FloatNumberDetails::RoundingMode::NearestEven
+>
+inline void ConvertRawFloatTypeArray(
+    typename SourceFloatDefinition::baseIntegerType const* input,
+    /*out*/ typename TargetFloatDefinition::baseIntegerType* output,
+    size_t count
+    ) noexcept
+{
+#if BINUMS_X86
+    if (GetCpuFeatures().avx2)
+    {
+        return ConvertRawFloatTypeArrayAvx2<SourceFloatDefinition, TargetFloatDefinition, roundingMode>(input, /*out*/ output, count);
+    }
+#endif
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        output[i] = FloatNumberDetails::ConvertRawFloatType<SourceFloatDefinition, TargetFloatDefinition, roundingMode>(input[i]);
+    }
+}
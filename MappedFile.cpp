@@ -0,0 +1,154 @@
+﻿// Memory mapped files, kept apart from BiNums.cpp so the system headers stay out of the rest.
+
+#include "precomp.h"
+#if _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+extern std::string GetFormatted(char const* formatString, ...);
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+:   data_(std::exchange(other.data_, nullptr)),
+    size_(std::exchange(other.size_, 0))
+{
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+    if (this != &other)
+    {
+        Close();
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+    }
+    return *this;
+}
+
+#if _WIN32
+
+int MappedFile::Open(char const* path, /*out*/ std::string& errorMessage)
+{
+    Close();
+
+    // Windows only backs pagefile sections with large pages, so the sequential scan is the only hint.
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        errorMessage = GetFormatted("Could not open file \"%s\": error %lu", path, GetLastError());
+        return EXIT_FAILURE;
+    }
+
+    LARGE_INTEGER fileSize = {};
+    if (!GetFileSizeEx(file, &fileSize) || uint64_t(fileSize.QuadPart) > SIZE_MAX)
+    {
+        errorMessage = GetFormatted("Could not get the size of file \"%s\"", path);
+        CloseHandle(file);
+        return EXIT_FAILURE;
+    }
+    if (fileSize.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return EXIT_SUCCESS;
+    }
+
+    // The view keeps the section (and file) open once mapped, so the handles can go.
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    void const* data = (mapping != nullptr) ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    DWORD const lastError = GetLastError();
+    if (mapping != nullptr)
+    {
+        CloseHandle(mapping);
+    }
+    CloseHandle(file);
+    if (data == nullptr)
+    {
+        errorMessage = GetFormatted("Could not map file \"%s\": error %lu", path, lastError);
+        return EXIT_FAILURE;
+    }
+
+    data_ = data;
+    size_ = size_t(fileSize.QuadPart);
+    return EXIT_SUCCESS;
+}
+
+void MappedFile::Close() noexcept
+{
+    if (data_ != nullptr)
+    {
+        UnmapViewOfFile(data_);
+    }
+    data_ = nullptr;
+    size_ = 0;
+}
+
+#else
+
+int MappedFile::Open(char const* path, /*out*/ std::string& errorMessage)
+{
+    Close();
+
+    int const file = open(path, O_RDONLY | O_CLOEXEC);
+    if (file < 0)
+    {
+        errorMessage = GetFormatted("Could not open file \"%s\": %s", path, strerror(errno));
+        return EXIT_FAILURE;
+    }
+
+    struct stat fileStatus = {};
+    if (fstat(file, &fileStatus) != 0 || uint64_t(fileStatus.st_size) > SIZE_MAX)
+    {
+        errorMessage = GetFormatted("Could not get the size of file \"%s\"", path);
+        close(file);
+        return EXIT_FAILURE;
+    }
+    if (fileStatus.st_size == 0)
+    {
+        close(file);
+        return EXIT_SUCCESS;
+    }
+
+    size_t const size = size_t(fileStatus.st_size);
+    void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+    int const mapError = errno;
+    close(file); // The mapping keeps the file open.
+    if (data == MAP_FAILED)
+    {
+        errorMessage = GetFormatted("Could not map file \"%s\": %s", path, strerror(mapError));
+        return EXIT_FAILURE;
+    }
+
+    // Only hints, so failures (like huge pages unsupported for this file system) are ignored.
+    madvise(data, size, MADV_SEQUENTIAL);
+    #ifdef MADV_HUGEPAGE
+    madvise(data, size, MADV_HUGEPAGE);
+    #endif
+
+    data_ = data;
+    size_ = size;
+    return EXIT_SUCCESS;
+}
+
+void MappedFile::Close() noexcept
+{
+    if (data_ != nullptr)
+    {
+        munmap(const_cast<void*>(data_), size_);
+    }
+    data_ = nullptr;
+    size_ = 0;
+}
+
+#endif
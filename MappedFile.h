@@ -0,0 +1,34 @@
+//-----------------------------------------------------------------------------
+//
+//  Read only memory mapped files, for operands too large to parse as text.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+// A read only view of a whole file. Pages are only read in as they are touched, and the mapping
+// is hinted as sequential (and huge page backed, where the system allows it for files), which
+// suits reductions streaming through multi-gigabyte arrays once.
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(MappedFile const&) = delete;
+    MappedFile& operator=(MappedFile const&) = delete;
+
+    // Map the file at the null terminated path, replacing any current mapping. An empty file maps
+    // successfully with no data.
+    int Open(char const* path, /*out*/ std::string& errorMessage);
+    void Close() noexcept;
+
+    void const* data() const noexcept { return data_; }
+    size_t size() const noexcept { return size_; }
+
+private:
+    void const* data_ = nullptr;
+    size_t size_ = 0;
+};
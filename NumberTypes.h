@@ -0,0 +1,120 @@
+//-----------------------------------------------------------------------------
+//
+//  The element types and the union holding a number of any of them.
+//
+//  Shared with the benchmarks, which call the parsing, casting, and formatting
+//  functions directly rather than through whole command lines.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+using Fixed24f12i12 = FixedNumber<int24_t, 12, 12>;
+using Fixed32f16i16 = FixedNumber<int32_t, 16, 16>;
+using Fixed32f24i8  = FixedNumber<int32_t, 8, 24>;
+
+union NumberUnion
+{
+    uint8_t         buffer[8];
+    uint8_t         ui8;
+    uint16_t        ui16;
+    uint32_t        ui32;
+    uint64_t        ui64;
+    int8_t          i8;
+    int16_t         i16;
+    int32_t         i32;
+    int64_t         i64;
+    float8m3e4s1_t  f3e4s1;
+    float8m2e5s1_t  f2e5s1;
+    float16_t       f16;
+    float16m7e8s1_t f16m7e8s1;
+    float32_t       f32;
+    float64_t       f64;
+    Fixed24f12i12   x24f12i12;
+    Fixed32f16i16   x32f16i16;
+    Fixed32f24i8    x32f24i8;
+
+    NumberUnion() : ui64(0) {}
+};
+
+enum class ElementType : uint32_t
+{
+    Undefined = 0,
+    Float32 = 1,    // starting from bit 0 - mantissa:23 exponent:8 sign:1
+    Uint8 = 2,
+    Int8 = 3,
+    Uint16 = 4,
+    Int16 = 5,
+    Int32 = 6,
+    Int64 = 7,
+    StringChar8 = 8,
+    Bool8 = 9,
+    Float16m10e5s1 = 10, // mantissa:10 exponent:5 sign:1
+    Float16 = Float16m10e5s1,
+    Float64 = 11,   // mantissa:52 exponent:11 sign:1
+    Uint32 = 12,
+    Uint64 = 13,
+    Complex64 = 14,
+    Complex128 = 15,
+    Float16m7e8s1 = 16,   // mantissa:7 exponent:8 sign:1
+    Bfloat16 = Float16m7e8s1,
+    Fixed24f12i12 = 17, // TODO: Make naming more consistent. Fixed24f12i12 vs Fixed12_12
+    Fixed32f16i16 = 18,
+    Fixed32f24i8 = 19,
+    Float8m3e4s1 = 20, // mantissa:3 exponent:4 sign:1
+    Float8m2e5s1 = 21, // mantissa:2 exponent:5 sign:1
+    Total = 22,
+};
+
+enum class NumericOperationType : uint32_t
+{
+    None,       // Invalid value
+    Nothing,    // No result, taking N outputs, returning 0 outputs
+    Nop,            // No operation, taking N inputs, returning N outputs (identity)
+    Identity = Nop,
+    Add,
+    Subtract,
+    Multiply,
+    Divide,
+    Dot,
+    Truncate,
+    Total
+};
+
+enum class NumericPrintingFlags : uint32_t
+{
+    ShowNumericType = 1 << 0,
+    ShowNumericValue = 1 << 1,
+    ShowBinaryValue = 1 << 2,
+
+    ShowRawHex = 0 << 4,
+    ShowRawBinary = 1 << 4,
+    ShowRawDecimal = 2 << 4,
+    ShowRawOctal = 3 << 4,
+    ShowDataMask = 3 << 4,
+
+    ShowFloatDecimal = 0 << 6,
+    ShowFloatHex = 1 << 6,
+    ShowFloatMask = 1 << 6,
+
+    HideRawFields = 0 << 7,
+    ShowRawFields = 1 << 7,
+    ShowRawFieldsMask = 1 << 7,
+
+    ShowRawBinaryFields = ShowRawBinary | ShowRawFields,
+
+    Default = ShowBinaryValue | ShowNumericValue | ShowNumericType,
+};
+
+inline constexpr NumericPrintingFlags operator ~ (NumericPrintingFlags lhs) { return NumericPrintingFlags(~uint32_t(lhs)); }
+inline constexpr NumericPrintingFlags operator & (NumericPrintingFlags lhs, NumericPrintingFlags rhs) { return NumericPrintingFlags(uint32_t(lhs) & uint32_t(rhs)); }
+inline constexpr NumericPrintingFlags operator | (NumericPrintingFlags lhs, NumericPrintingFlags rhs) { return NumericPrintingFlags(uint32_t(lhs) & uint32_t(rhs)); }
+inline constexpr bool operator == (NumericPrintingFlags lhs, uint32_t rhs) { return uint32_t(lhs) == rhs; }
+inline constexpr bool operator != (NumericPrintingFlags lhs, uint32_t rhs) { return uint32_t(lhs) != rhs; }
+
+struct NumberUnionAndType
+{
+    NumberUnion numberUnion;
+    ElementType elementType;
+    NumericPrintingFlags printingFlags = NumericPrintingFlags::Default;
+};
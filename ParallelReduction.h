@@ -0,0 +1,291 @@
+//-----------------------------------------------------------------------------
+//
+//  Deterministic parallel reductions over long arrays.
+//
+//  The array is split into chunks of a fixed size, each chunk is reduced on
+//  the shared thread pool, and the partial results are combined in a fixed
+//  tree order. Neither the chunking nor the tree depend on the thread count
+//  (or on which thread ran which chunk), so results are bit-identical for any
+//  thread count, including one.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+// Workers wait for a job, claim its tasks from an atomic counter alongside the calling
+// thread, and go back to waiting once the tasks run out. Only one job runs at a time,
+// so tasks must not start another job themselves. Callers arriving while a job runs
+// (like concurrent requests to a server) run their tasks alone rather than queue.
+class ThreadPool
+{
+public:
+    explicit ThreadPool(uint32_t workerCount)
+    {
+        workers_.reserve(workerCount);
+        for (uint32_t i = 0; i < workerCount; ++i)
+        {
+            workers_.emplace_back([this]() { WorkerLoop(); });
+        }
+    }
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            isStopping_ = true;
+        }
+        jobStarted_.notify_all();
+        for (std::thread& worker : workers_)
+        {
+            worker.join();
+        }
+    }
+
+    ThreadPool(ThreadPool const&) = delete;
+    ThreadPool& operator=(ThreadPool const&) = delete;
+
+    // The process wide pool, with a worker for every hardware thread besides the caller's.
+    static ThreadPool& GetShared()
+    {
+        static ThreadPool pool(std::max(std::thread::hardware_concurrency(), 1u) - 1);
+        return pool;
+    }
+
+    // The calling thread plus the workers.
+    uint32_t GetThreadCount() const noexcept
+    {
+        return uint32_t(workers_.size()) + 1;
+    }
+
+    // The threads a job asking for threadCount of them (0 = all) may run on.
+    uint32_t GetThreadCount(uint32_t threadCount) const noexcept
+    {
+        return (threadCount == 0) ? GetThreadCount() : std::min(threadCount, GetThreadCount());
+    }
+
+    // Call function(i) for every i in [0, taskCount), on up to threadCount threads including
+    // the calling one (0 = all of them), returning once every task is done. The first exception
+    // thrown by a task is rethrown here after the rest finish. A function taking (i, threadIndex)
+    // is also told which thread runs it, numbered below GetThreadCount(threadCount) with the
+    // caller as 0, like for indexing per thread scratch memory.
+    template <typename Function>
+    void ParallelFor(size_t taskCount, uint32_t threadCount, Function&& function)
+    {
+        threadCount = GetThreadCount(threadCount);
+        if (threadCount <= 1 || taskCount <= 1)
+        {
+            RunTasksAlone(function, taskCount);
+            return;
+        }
+
+        // Waiting out another caller's job could take longer than running alone, and the results
+        // are the same for any thread count.
+        std::unique_lock<std::mutex> jobLock(jobMutex_, std::try_to_lock);
+        if (!jobLock.owns_lock())
+        {
+            RunTasksAlone(function, taskCount);
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            job_.runTask = [&function](size_t i, uint32_t threadIndex) { RunTask(function, i, threadIndex); };
+            job_.taskCount = taskCount;
+            job_.nextTask = 0;
+            job_.openWorkerSlotCount = std::min(size_t(threadCount - 1), taskCount - 1);
+            job_.joinedWorkerCount = 0;
+            job_.exception = nullptr;
+            ++jobGeneration_;
+        }
+        jobStarted_.notify_all();
+
+        RunTasks(0);
+
+        // Close the job to late workers, and wait for those that joined to finish.
+        std::unique_lock<std::mutex> lock(mutex_);
+        job_.openWorkerSlotCount = 0;
+        jobFinished_.wait(lock, [this]() { return job_.activeWorkerCount == 0; });
+        job_.runTask = nullptr;
+        if (job_.exception != nullptr)
+        {
+            std::rethrow_exception(job_.exception);
+        }
+    }
+
+private:
+    struct Job
+    {
+        std::function<void(size_t, uint32_t)> runTask;
+        size_t taskCount = 0;
+        std::atomic<size_t> nextTask = 0;
+        size_t openWorkerSlotCount = 0; // How many more workers may join, guarded by mutex_.
+        size_t activeWorkerCount = 0; // Workers running tasks of the job, guarded by mutex_.
+        uint32_t joinedWorkerCount = 0; // Numbers the workers' thread indices, guarded by mutex_.
+        std::exception_ptr exception;
+    };
+
+    template <typename Function>
+    static void RunTask(Function& function, size_t i, uint32_t threadIndex)
+    {
+        if constexpr (std::is_invocable_v<Function&, size_t, uint32_t>)
+        {
+            function(i, threadIndex);
+        }
+        else
+        {
+            function(i);
+        }
+    }
+
+    // Run every task on the calling thread, rethrowing the first exception after the rest finish
+    // like a job does.
+    template <typename Function>
+    static void RunTasksAlone(Function& function, size_t taskCount)
+    {
+        std::exception_ptr exception;
+        for (size_t i = 0; i < taskCount; ++i)
+        {
+            try
+            {
+                RunTask(function, i, 0);
+            }
+            catch (...)
+            {
+                if (exception == nullptr)
+                {
+                    exception = std::current_exception();
+                }
+            }
+        }
+        if (exception != nullptr)
+        {
+            std::rethrow_exception(exception);
+        }
+    }
+
+    void RunTasks(uint32_t threadIndex) noexcept
+    {
+        for (size_t i; (i = job_.nextTask.fetch_add(1, std::memory_order_relaxed)) < job_.taskCount; )
+        {
+            try
+            {
+                job_.runTask(i, threadIndex);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (job_.exception == nullptr)
+                {
+                    job_.exception = std::current_exception();
+                }
+            }
+        }
+    }
+
+    void WorkerLoop()
+    {
+        uint64_t lastJobGeneration = 0;
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true)
+        {
+            // Workers beyond the job's thread count keep waiting, as do those that already ran it.
+            jobStarted_.wait(lock, [&]()
+            {
+                return isStopping_ || (jobGeneration_ != lastJobGeneration && job_.openWorkerSlotCount > 0);
+            });
+            if (isStopping_)
+            {
+                return;
+            }
+
+            lastJobGeneration = jobGeneration_;
+            --job_.openWorkerSlotCount;
+            ++job_.activeWorkerCount;
+            uint32_t const threadIndex = ++job_.joinedWorkerCount;
+            lock.unlock();
+            RunTasks(threadIndex);
+            lock.lock();
+
+            if (--job_.activeWorkerCount == 0)
+            {
+                jobFinished_.notify_one();
+            }
+        }
+    }
+
+    std::vector<std::thread> workers_;
+    std::mutex jobMutex_; // Held by the caller whose job is running.
+    std::mutex mutex_;
+    std::condition_variable jobStarted_;
+    std::condition_variable jobFinished_;
+    Job job_;
+    uint64_t jobGeneration_ = 0;
+    bool isStopping_ = false;
+};
+
+// Fixed regardless of the thread count, so the chunk boundaries (and the results) are too.
+// Large enough to amortize the task overhead, and even so dot's pairs never straddle chunks.
+constexpr size_t g_reductionChunkSize = size_t(1) << 16;
+
+// Combine the partials as a balanced binary tree: neighbors, then neighboring pairs, and so on.
+template <typename T, typename CombineFunction>
+T CombineInTreeOrder(/*inout*/ std::pmr::vector<T>& partials, CombineFunction combine)
+{
+    assert(!partials.empty());
+    for (size_t stride = 1; stride < partials.size(); stride *= 2)
+    {
+        for (size_t i = 0; i + stride < partials.size(); i += stride * 2)
+        {
+            partials[i] = combine(partials[i], partials[i + stride]);
+        }
+    }
+    return partials.front();
+}
+
+// Reduce [0, count) by calling reduceChunk(begin, chunkCount) on each fixed size chunk across up
+// to threadCount threads (0 = all), then combineAll(partials) in a fixed order, or just the one
+// chunk directly. The partials are indexed by chunk, so which thread reduced a chunk is irrelevant.
+// Like ParallelFor, a reduceChunk taking (begin, chunkCount, threadIndex) is told the thread.
+// A null threadPool means the shared one, which is only created once there are several chunks.
+template <typename T, typename ReduceChunkFunction, typename CombineAllFunction>
+T ReduceInChunks(
+    size_t count,
+    uint32_t threadCount,
+    ReduceChunkFunction reduceChunk,
+    CombineAllFunction combineAll,
+    size_t chunkSize = g_reductionChunkSize,
+    ThreadPool* threadPool = nullptr,
+    std::pmr::memory_resource* memoryResource = std::pmr::get_default_resource()
+    )
+{
+    auto reduce = [&](size_t begin, size_t chunkCount, uint32_t threadIndex) -> T
+    {
+        if constexpr (std::is_invocable_v<ReduceChunkFunction&, size_t, size_t, uint32_t>)
+        {
+            return reduceChunk(begin, chunkCount, threadIndex);
+        }
+        else
+        {
+            return reduceChunk(begin, chunkCount);
+        }
+    };
+
+    size_t const chunkCount = (count + chunkSize - 1) / chunkSize;
+    if (chunkCount <= 1)
+    {
+        return reduce(size_t(0), count, 0);
+    }
+
+    std::pmr::vector<T> partials(chunkCount, memoryResource);
+    ThreadPool& chunkThreadPool = (threadPool != nullptr) ? *threadPool : ThreadPool::GetShared();
+    chunkThreadPool.ParallelFor(
+        chunkCount,
+        threadCount,
+        [&](size_t chunkIndex, uint32_t threadIndex)
+        {
+            size_t const begin = chunkIndex * chunkSize;
+            partials[chunkIndex] = reduce(begin, std::min(chunkSize, count - begin), threadIndex);
+        }
+    );
+    return combineAll(/*inout*/ partials);
+}
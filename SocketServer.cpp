@@ -0,0 +1,388 @@
+﻿// Unix domain socket server, kept apart from BiNums.cpp so the system headers stay out of the rest.
+
+#include "precomp.h"
+#if __linux__
+#include <cerrno>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+extern std::string GetFormatted(char const* formatString, ...);
+extern int ServeCommandLine(std::string_view line, EvaluationContext& context, /*out*/ std::string& stringOutput);
+
+SocketServer::~SocketServer()
+{
+    Stop();
+    Wait();
+}
+
+#if __linux__
+
+// Requests received but not yet answered, up to a complete line, and answers not yet sent.
+struct SocketServer::Connection
+{
+    int socket;
+    std::string input;
+    std::string output;
+    size_t sentOutputByteCount; // From the front of output.
+    bool isEndOfInput; // The client sent its last request.
+
+    // Held while serving through to rearming. Hardly ever contended, as one-shot events already hand
+    // a connection to one worker at a time, but makes the handoff visible to race detectors, which
+    // cannot see it through the event queue.
+    std::mutex mutex;
+};
+
+// Longer lines are more likely a misbehaving client than a command line.
+constexpr size_t g_maximumServedLineByteSize = size_t(1) << 26;
+
+// Answers queued for a client before sending them, and before answering more of its lines.
+constexpr size_t g_maximumQueuedOutputByteSize = size_t(1) << 20;
+
+int SocketServer::Start(char const* socketPath, uint32_t workerCount, /*out*/ std::string& errorMessage)
+{
+    Stop();
+    Wait();
+    isStopping_ = false;
+
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (strlen(socketPath) >= sizeof(address.sun_path))
+    {
+        errorMessage = GetFormatted("Socket path is too long: \"%s\"", socketPath);
+        return EXIT_FAILURE;
+    }
+    strcpy(address.sun_path, socketPath);
+
+    // Replace a socket left behind by an earlier server, never a regular file given by mistake.
+    struct stat fileStatus = {};
+    if (lstat(socketPath, &fileStatus) == 0 && S_ISSOCK(fileStatus.st_mode))
+    {
+        unlink(socketPath);
+    }
+
+    listeningSocket_ = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listeningSocket_ < 0
+    ||  bind(listeningSocket_, reinterpret_cast<sockaddr const*>(&address), sizeof(address)) != 0
+    ||  listen(listeningSocket_, SOMAXCONN) != 0)
+    {
+        errorMessage = GetFormatted("Could not listen on socket \"%s\": %s", socketPath, strerror(errno));
+        Close();
+        return EXIT_FAILURE;
+    }
+    socketPath_ = socketPath;
+
+    // The listening socket and connections are one-shot, so exactly one worker wakes for each, and
+    // rearms it once done. The stop event stays signaled, waking every worker.
+    eventQueue_ = epoll_create1(EPOLL_CLOEXEC);
+    stopEvent_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    epoll_event listeningEvent = {.events = EPOLLIN | EPOLLONESHOT, .data = {.ptr = nullptr}};
+    epoll_event stopEvent = {.events = EPOLLIN, .data = {.ptr = this}};
+    if (eventQueue_ < 0
+    ||  stopEvent_ < 0
+    ||  epoll_ctl(eventQueue_, EPOLL_CTL_ADD, listeningSocket_, &listeningEvent) != 0
+    ||  epoll_ctl(eventQueue_, EPOLL_CTL_ADD, stopEvent_, &stopEvent) != 0)
+    {
+        errorMessage = GetFormatted("Could not wait on socket \"%s\": %s", socketPath, strerror(errno));
+        Close();
+        return EXIT_FAILURE;
+    }
+
+    workerCount = (workerCount == 0) ? std::max(std::thread::hardware_concurrency(), 1u) : workerCount;
+    workers_.reserve(workerCount);
+    for (uint32_t i = 0; i < workerCount; ++i)
+    {
+        workers_.emplace_back([this]() { WorkerLoop(); });
+    }
+
+    return EXIT_SUCCESS;
+}
+
+void SocketServer::Wait()
+{
+    for (std::thread& worker : workers_)
+    {
+        worker.join();
+    }
+    workers_.clear();
+    Close();
+}
+
+void SocketServer::Stop() noexcept
+{
+    isStopping_ = true;
+    if (stopEvent_ >= 0)
+    {
+        uint64_t const signal = 1;
+        [[maybe_unused]] ssize_t const writtenByteCount = write(stopEvent_, &signal, sizeof(signal));
+    }
+}
+
+// Once no worker holds any connection.
+void SocketServer::Close()
+{
+    for (Connection* connection : connections_)
+    {
+        close(connection->socket);
+        delete connection;
+    }
+    connections_.clear();
+
+    for (int* handle : {&listeningSocket_, &eventQueue_, &stopEvent_})
+    {
+        if (*handle >= 0)
+        {
+            close(*handle);
+            *handle = -1;
+        }
+    }
+    if (!socketPath_.empty())
+    {
+        unlink(socketPath_.c_str());
+        socketPath_.clear();
+    }
+}
+
+void SocketServer::WorkerLoop()
+{
+    // Reused for every request this worker answers.
+    EvaluationContext context;
+    context.inputStream = nullptr;
+    context.outputStream = nullptr;
+    std::string stringOutput;
+
+    while (!isStopping_)
+    {
+        epoll_event event;
+        int const eventCount = epoll_wait(eventQueue_, &event, 1, -1);
+        if (eventCount <= 0 || isStopping_ || event.data.ptr == this)
+        {
+            continue; // Interrupted, or stopping.
+        }
+
+        if (event.data.ptr == nullptr)
+        {
+            AcceptConnections();
+            epoll_event listeningEvent = {.events = EPOLLIN | EPOLLONESHOT, .data = {.ptr = nullptr}};
+            epoll_ctl(eventQueue_, EPOLL_CTL_MOD, listeningSocket_, &listeningEvent);
+            continue;
+        }
+
+        // A client with answers still queued waits until it reads them, and only then sends more.
+        Connection* connection = static_cast<Connection*>(event.data.ptr);
+        std::unique_lock<std::mutex> connectionLock(connection->mutex);
+        if (ServeConnection(*connection, context, /*inout*/ stringOutput))
+        {
+            uint32_t const events = connection->output.empty() ? (EPOLLIN | EPOLLRDHUP) : EPOLLOUT;
+            epoll_event connectionEvent = {.events = events | EPOLLONESHOT, .data = {.ptr = connection}};
+            epoll_ctl(eventQueue_, EPOLL_CTL_MOD, connection->socket, &connectionEvent);
+        }
+        else
+        {
+            connectionLock.unlock();
+            CloseConnection(connection);
+        }
+    }
+}
+
+void SocketServer::AcceptConnections()
+{
+    while (true)
+    {
+        // Connections never block, so a client that stops reading cannot hold up a worker.
+        int const connectionSocket = accept4(listeningSocket_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (connectionSocket < 0)
+        {
+            return; // No more pending, or out of descriptors until a client disconnects.
+        }
+
+        Connection* connection = new Connection{
+            .socket = connectionSocket,
+            .input = {},
+            .output = {},
+            .sentOutputByteCount = 0,
+            .isEndOfInput = false,
+            .mutex = {},
+        };
+        {
+            std::lock_guard<std::mutex> lock(connectionsMutex_);
+            connections_.push_back(connection);
+        }
+        bool isWaiting;
+        {
+            std::lock_guard<std::mutex> connectionLock(connection->mutex);
+            epoll_event connectionEvent = {.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT, .data = {.ptr = connection}};
+            isWaiting = (epoll_ctl(eventQueue_, EPOLL_CTL_ADD, connectionSocket, &connectionEvent) == 0);
+        }
+        if (!isWaiting)
+        {
+            CloseConnection(connection);
+        }
+    }
+}
+
+// Send queued answers, answer complete lines, and read more, until the client has to read its
+// answers or send more. Returns false once the client is gone (after answering a last line
+// without a line ending), or misbehaving. Answers left queued wait for the socket to be writable.
+bool SocketServer::ServeConnection(Connection& connection, EvaluationContext& context, /*inout*/ std::string& stringOutput)
+{
+    bool hasRead = false;
+    while (true)
+    {
+        if (!SendOutput(connection))
+        {
+            return false;
+        }
+        if (!connection.output.empty())
+        {
+            return true;
+        }
+        if (AnswerLines(connection, context, /*inout*/ stringOutput))
+        {
+            continue;
+        }
+        if (connection.isEndOfInput)
+        {
+            return false;
+        }
+
+        // Read once per wakeup, so a client sending nonstop still takes turns with the others.
+        if (hasRead)
+        {
+            return true;
+        }
+        hasRead = true;
+        if (!ReadInput(connection))
+        {
+            return false;
+        }
+    }
+}
+
+// Read what the client sent, up to the first complete line. Returns false on a line too long.
+bool SocketServer::ReadInput(Connection& connection)
+{
+    char readBuffer[4096];
+    while (true)
+    {
+        ssize_t const readByteCount = recv(connection.socket, readBuffer, sizeof(readBuffer), 0);
+        if (readByteCount > 0)
+        {
+            connection.input.append(readBuffer, size_t(readByteCount));
+            if (memchr(readBuffer, '\n', size_t(readByteCount)) != nullptr)
+            {
+                return true;
+            }
+            if (connection.input.size() > g_maximumServedLineByteSize)
+            {
+                return false;
+            }
+            continue;
+        }
+        if (readByteCount < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        connection.isEndOfInput = (readByteCount == 0 || (errno != EAGAIN && errno != EWOULDBLOCK));
+        return true;
+    }
+}
+
+// Answer the complete lines received (and the last one at the end of input), queuing the output
+// until enough is queued to send. Returns whether any line was answered.
+bool SocketServer::AnswerLines(Connection& connection, EvaluationContext& context, /*inout*/ std::string& stringOutput)
+{
+    auto answer = [&](std::string_view line)
+    {
+        int const exitCode = ServeCommandLine(line, context, /*out*/ stringOutput);
+        char header[32];
+        int const headerByteSize = snprintf(header, sizeof(header), "%d %zu\n", exitCode, stringOutput.size());
+        connection.output.append(header, size_t(headerByteSize)).append(stringOutput);
+    };
+
+    size_t lineBegin = 0;
+    for (size_t lineEnd;
+         connection.output.size() < g_maximumQueuedOutputByteSize && (lineEnd = connection.input.find('\n', lineBegin)) != std::string::npos;
+         lineBegin = lineEnd + 1)
+    {
+        answer(std::string_view(connection.input).substr(lineBegin, lineEnd - lineBegin));
+    }
+    connection.input.erase(0, lineBegin);
+
+    if (connection.isEndOfInput && !connection.input.empty() && connection.input.find('\n') == std::string::npos)
+    {
+        answer(connection.input);
+        connection.input.clear();
+        return true;
+    }
+    return lineBegin > 0;
+}
+
+// Send as much of the queued output as the socket takes. Returns false once the client is gone.
+bool SocketServer::SendOutput(Connection& connection)
+{
+    while (connection.sentOutputByteCount < connection.output.size())
+    {
+        ssize_t const sentByteCount = send(
+            connection.socket,
+            connection.output.data() + connection.sentOutputByteCount,
+            connection.output.size() - connection.sentOutputByteCount,
+            MSG_NOSIGNAL
+        );
+        if (sentByteCount >= 0)
+        {
+            connection.sentOutputByteCount += size_t(sentByteCount);
+            continue;
+        }
+        if (errno == EINTR)
+        {
+            continue;
+        }
+        return (errno == EAGAIN || errno == EWOULDBLOCK);
+    }
+
+    connection.output.clear();
+    connection.sentOutputByteCount = 0;
+    return true;
+}
+
+void SocketServer::CloseConnection(Connection* connection)
+{
+    {
+        std::lock_guard<std::mutex> lock(connectionsMutex_);
+        auto it = std::find(connections_.begin(), connections_.end(), connection);
+        if (it != connections_.end())
+        {
+            *it = connections_.back();
+            connections_.pop_back();
+        }
+    }
+    close(connection->socket); // Also removes it from the event queue.
+    delete connection;
+}
+
+#else
+
+struct SocketServer::Connection
+{
+};
+
+int SocketServer::Start(char const* /*socketPath*/, uint32_t /*workerCount*/, /*out*/ std::string& errorMessage)
+{
+    errorMessage = "Serving on a socket is not supported on this platform";
+    return EXIT_FAILURE;
+}
+
+void SocketServer::Wait()
+{
+}
+
+void SocketServer::Stop() noexcept
+{
+}
+
+#endif
@@ -0,0 +1,55 @@
+//-----------------------------------------------------------------------------
+//
+//  A server answering command lines from many local clients at once.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+// Listens on a Unix domain socket, answering each line a client sends the same way as "--serve":
+// the exit code and output byte count on a line, then the output. Each worker thread has its own
+// evaluation context and buffers, and waits on the same readiness queue, taking whichever client
+// has a request. A client is only ever handled by one worker at a time, so its responses arrive
+// in order, while different clients are answered in parallel. Sockets never block: answers a client
+// has not read yet are queued, and its further requests wait until it does, so a client that
+// stops reading holds up only itself. Only implemented for Linux (epoll).
+class SocketServer
+{
+public:
+    SocketServer() = default;
+    ~SocketServer();
+
+    SocketServer(SocketServer const&) = delete;
+    SocketServer& operator=(SocketServer const&) = delete;
+
+    // Listen at the socket path with the given number of workers (0 = one per hardware thread).
+    // A stale socket already at the path is replaced, but not any other kind of file.
+    int Start(char const* socketPath, uint32_t workerCount, /*out*/ std::string& errorMessage);
+
+    // Wait for the workers to end once stopped, then close the socket and every client connection.
+    void Wait();
+
+    // Wake the workers to end. Safe to call from another thread, or a signal handler, while waiting.
+    void Stop() noexcept;
+
+private:
+    struct Connection;
+
+    void Close();
+    void WorkerLoop();
+    void AcceptConnections();
+    bool ServeConnection(Connection& connection, EvaluationContext& context, /*inout*/ std::string& stringOutput);
+    bool ReadInput(Connection& connection);
+    bool AnswerLines(Connection& connection, EvaluationContext& context, /*inout*/ std::string& stringOutput);
+    bool SendOutput(Connection& connection);
+    void CloseConnection(Connection* connection);
+
+    std::vector<std::thread> workers_;
+    std::mutex connectionsMutex_;
+    std::vector<Connection*> connections_; // Open connections, guarded by connectionsMutex_.
+    std::string socketPath_;
+    int listeningSocket_ = -1;
+    int eventQueue_ = -1;
+    int stopEvent_ = -1;
+    std::atomic<bool> isStopping_ = false;
+};
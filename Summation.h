@@ -0,0 +1,513 @@
+//-----------------------------------------------------------------------------
+//
+//  Summation of long float arrays with bounded error growth.
+//
+//  - Sequential adds one value at a time, so the error grows linearly.
+//    BiNums sums long arrays in parallel chunks (see ParallelReduction.h), so
+//    there it is only front to back within each chunk, and the chunk sums are
+//    added as a tree.
+//  - Pairwise splits the array in halves recursively down to small blocks,
+//    so the error grows with the log of the count, at nearly the same cost.
+//  - Kahan carries the rounding error of each add into the next one.
+//  - Neumaier is Kahan that also handles a value larger than the running sum.
+//
+//  The scalar versions take a rounding function so emulated types like float16
+//  can compute in float32 while rounding every operation to their precision.
+//  float32 and float64 instead run the same algorithms per lane, four vectors
+//  of 32 bytes at a time, then combine the lanes (and their compensations) in
+//  a fixed order. AVX2 hosts run the lanes as vectors, and others run the same
+//  lanes in plain code, so a mode gives the same bits on every machine.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+enum class SummationMode
+{
+    Sequential,
+    Pairwise,
+    Kahan,
+    Neumaier,
+};
+
+namespace SummationDetails
+{
+    // Small enough to stay in L1 and to keep the block's own sequential error small.
+    constexpr size_t pairwiseBlockSize = 128;
+
+    template <typename AccumulatorType, typename RoundFunction>
+    struct KahanSum
+    {
+        AccumulatorType sum = 0;
+        AccumulatorType compensation = 0; // Pending error, subtracted from the next value.
+        RoundFunction round;
+
+        void Add(AccumulatorType value) noexcept
+        {
+            AccumulatorType const y = round(value - compensation);
+            AccumulatorType const t = round(sum + y);
+            compensation = round(round(t - sum) - y);
+            sum = t;
+        }
+
+        AccumulatorType Result() const noexcept
+        {
+            return sum;
+        }
+    };
+
+    template <typename AccumulatorType, typename RoundFunction>
+    struct NeumaierSum
+    {
+        AccumulatorType sum = 0;
+        AccumulatorType compensation = 0; // Lost low order bits, added at the end.
+        RoundFunction round;
+
+        void Add(AccumulatorType value) noexcept
+        {
+            AccumulatorType const t = round(sum + value);
+            AccumulatorType const error = (std::abs(sum) >= std::abs(value))
+                                        ? round(round(sum - t) + value)
+                                        : round(round(value - t) + sum);
+            compensation = round(compensation + error);
+            sum = t;
+        }
+
+        AccumulatorType Result() const noexcept
+        {
+            return round(sum + compensation);
+        }
+    };
+
+    template <typename AccumulatorType, typename ValueType, typename DecodeFunction, typename RoundFunction>
+    AccumulatorType SumSequential(ValueType const* values, size_t count, DecodeFunction decode, RoundFunction round) noexcept
+    {
+        AccumulatorType sum = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            sum = round(sum + decode(values[i]));
+        }
+        return sum;
+    }
+
+    template <typename AccumulatorType, typename ValueType, typename DecodeFunction, typename RoundFunction>
+    AccumulatorType SumPairwise(ValueType const* values, size_t count, DecodeFunction decode, RoundFunction round) noexcept
+    {
+        if (count <= pairwiseBlockSize)
+        {
+            return SumSequential<AccumulatorType>(values, count, decode, round);
+        }
+
+        // Split on a block boundary so the recursion bottoms out in whole blocks.
+        size_t const half = (count / 2 + pairwiseBlockSize - 1) / pairwiseBlockSize * pairwiseBlockSize;
+        return round(
+            SumPairwise<AccumulatorType>(values, half, decode, round) +
+            SumPairwise<AccumulatorType>(values + half, count - half, decode, round)
+        );
+    }
+
+    template <typename Summer, typename ValueType, typename DecodeFunction>
+    void AddAll(/*inout*/ Summer& summer, ValueType const* values, size_t count, DecodeFunction decode) noexcept
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            summer.Add(decode(values[i]));
+        }
+    }
+
+    template <typename T>
+    T Identity(T value) noexcept
+    {
+        return value;
+    }
+
+    // The lane layout: independent chains per step, enough to hide the add latency, each one
+    // vector of 32 bytes. Value c of each step goes to lane c % laneCount of chain c / laneCount,
+    // which is just chain c of the step for the plain code.
+    constexpr size_t accumulatorCount = 4;
+    constexpr size_t vectorByteCount = 32;
+
+    template <typename ValueType>
+    constexpr size_t vectorLaneCount = vectorByteCount / sizeof(ValueType);
+
+    // Add the pairwise lane sums pairwise, then the values past the last whole step.
+    template <typename ValueType>
+    ValueType FinishPairwiseLanes(ValueType const (&lanes)[vectorLaneCount<ValueType>], ValueType const* values, size_t count) noexcept
+    {
+        ValueType const laneSum = SumPairwise<ValueType>(lanes, vectorLaneCount<ValueType>, &Identity<ValueType>, &Identity<ValueType>);
+        return laneSum + SumSequential<ValueType>(values, count, &Identity<ValueType>, &Identity<ValueType>);
+    }
+
+    // Fold the lane sums and their pending compensations into one scalar sum, then the values
+    // past the last whole step.
+    template <typename ValueType>
+    ValueType FinishKahanLanes(
+        ValueType const* laneSums,
+        ValueType const* laneCompensations,
+        size_t laneCount,
+        ValueType const* values,
+        size_t count
+        ) noexcept
+    {
+        KahanSum<ValueType, ValueType(*)(ValueType)> summer{.round = &Identity<ValueType>};
+        AddAll(/*inout*/ summer, laneSums, laneCount, &Identity<ValueType>);
+        for (size_t i = 0; i < laneCount; ++i)
+        {
+            summer.Add(-laneCompensations[i]);
+        }
+        AddAll(/*inout*/ summer, values, count, &Identity<ValueType>);
+        return summer.Result();
+    }
+
+    template <typename ValueType>
+    ValueType FinishNeumaierLanes(
+        ValueType const* laneSums,
+        ValueType const* laneCompensations,
+        size_t laneCount,
+        ValueType const* values,
+        size_t count
+        ) noexcept
+    {
+        NeumaierSum<ValueType, ValueType(*)(ValueType)> summer{.round = &Identity<ValueType>};
+        AddAll(/*inout*/ summer, laneSums, laneCount, &Identity<ValueType>);
+        AddAll(/*inout*/ summer, laneCompensations, laneCount, &Identity<ValueType>);
+        AddAll(/*inout*/ summer, values, count, &Identity<ValueType>);
+        return summer.Result();
+    }
+
+    // The lanes in plain code, for hosts without the vector kernels. The count must be a
+    // multiple of the step size.
+    template <typename ValueType>
+    void SumPairwiseLanes(ValueType const* values, size_t count, /*out*/ ValueType (&laneSums)[vectorLaneCount<ValueType>]) noexcept
+    {
+        constexpr size_t laneCount = vectorLaneCount<ValueType>;
+        constexpr size_t stepSize = laneCount * accumulatorCount;
+        static_assert(pairwiseBlockSize % stepSize == 0);
+
+        if (count <= pairwiseBlockSize)
+        {
+            ValueType sums[stepSize] = {};
+            for (size_t i = 0; i < count; i += stepSize)
+            {
+                for (size_t c = 0; c < stepSize; ++c)
+                {
+                    sums[c] += values[i + c];
+                }
+            }
+            for (size_t lane = 0; lane < laneCount; ++lane)
+            {
+                laneSums[lane] = (sums[lane] + sums[laneCount + lane]) + (sums[laneCount * 2 + lane] + sums[laneCount * 3 + lane]);
+            }
+            return;
+        }
+
+        size_t const half = (count / 2 + pairwiseBlockSize - 1) / pairwiseBlockSize * pairwiseBlockSize;
+        ValueType highLaneSums[laneCount];
+        SumPairwiseLanes(values, half, /*out*/ laneSums);
+        SumPairwiseLanes(values + half, count - half, /*out*/ highLaneSums);
+        for (size_t lane = 0; lane < laneCount; ++lane)
+        {
+            laneSums[lane] += highLaneSums[lane];
+        }
+    }
+
+    template <typename ValueType>
+    ValueType SumArrayLanes(ValueType const* values, size_t count, SummationMode mode) noexcept
+    {
+        constexpr size_t stepSize = vectorLaneCount<ValueType> * accumulatorCount;
+        size_t const stepCount = count / stepSize * stepSize;
+
+        switch (mode)
+        {
+        case SummationMode::Pairwise:
+            {
+                ValueType laneSums[vectorLaneCount<ValueType>];
+                SumPairwiseLanes(values, stepCount, /*out*/ laneSums);
+                return FinishPairwiseLanes(laneSums, values + stepCount, count - stepCount);
+            }
+
+        case SummationMode::Kahan:
+            {
+                ValueType sums[stepSize] = {}, compensations[stepSize] = {};
+                for (size_t i = 0; i < stepCount; i += stepSize)
+                {
+                    for (size_t c = 0; c < stepSize; ++c)
+                    {
+                        ValueType const y = values[i + c] - compensations[c];
+                        ValueType const t = sums[c] + y;
+                        compensations[c] = (t - sums[c]) - y;
+                        sums[c] = t;
+                    }
+                }
+                return FinishKahanLanes(sums, compensations, stepSize, values + stepCount, count - stepCount);
+            }
+
+        case SummationMode::Neumaier:
+            {
+                // TwoSum like the kernels, which gives the same exact error as NeumaierSum.
+                ValueType sums[stepSize] = {}, compensations[stepSize] = {};
+                for (size_t i = 0; i < stepCount; i += stepSize)
+                {
+                    for (size_t c = 0; c < stepSize; ++c)
+                    {
+                        ValueType const value = values[i + c];
+                        ValueType const t = sums[c] + value;
+                        ValueType const valuePart = t - sums[c];
+                        ValueType const sumPart = t - valuePart;
+                        compensations[c] += (sums[c] - sumPart) + (value - valuePart);
+                        sums[c] = t;
+                    }
+                }
+                return FinishNeumaierLanes(sums, compensations, stepSize, values + stepCount, count - stepCount);
+            }
+
+        case SummationMode::Sequential:
+        default:
+            return SumSequential<ValueType>(values, count, &Identity<ValueType>, &Identity<ValueType>);
+        }
+    }
+} // namespace SummationDetails
+
+// Sum the values in the given mode, decoding each to the accumulator type and rounding
+// the result of every operation with the given function.
+template <typename AccumulatorType, typename ValueType, typename DecodeFunction, typename RoundFunction>
+AccumulatorType SumArrayScalar(
+    ValueType const* values,
+    size_t count,
+    SummationMode mode,
+    DecodeFunction decode,
+    RoundFunction round
+    ) noexcept
+{
+    using namespace SummationDetails;
+
+    switch (mode)
+    {
+    case SummationMode::Pairwise:
+        return SumPairwise<AccumulatorType>(values, count, decode, round);
+
+    case SummationMode::Kahan:
+        {
+            KahanSum<AccumulatorType, RoundFunction> summer{.round = round};
+            AddAll(/*inout*/ summer, values, count, decode);
+            return summer.Result();
+        }
+
+    case SummationMode::Neumaier:
+        {
+            NeumaierSum<AccumulatorType, RoundFunction> summer{.round = round};
+            AddAll(/*inout*/ summer, values, count, decode);
+            return summer.Result();
+        }
+
+    case SummationMode::Sequential:
+    default:
+        return SumSequential<AccumulatorType>(values, count, decode, round);
+    }
+}
+
+#if BINUMS_X86
+
+namespace SummationDetails
+{
+    struct Float32Avx2Lanes
+    {
+        using ValueType = float;
+        using Vector = __m256;
+        static constexpr size_t laneCount = 8;
+
+        BINUMS_TARGET("avx2")
+        static __m256 Load(float const* values) noexcept { return _mm256_loadu_ps(values); }
+
+        BINUMS_TARGET("avx2")
+        static __m256 Add(__m256 a, __m256 b) noexcept { return _mm256_add_ps(a, b); }
+
+        BINUMS_TARGET("avx2")
+        static __m256 Subtract(__m256 a, __m256 b) noexcept { return _mm256_sub_ps(a, b); }
+    };
+
+    struct Float64Avx2Lanes
+    {
+        using ValueType = double;
+        using Vector = __m256d;
+        static constexpr size_t laneCount = 4;
+
+        BINUMS_TARGET("avx2")
+        static __m256d Load(double const* values) noexcept { return _mm256_loadu_pd(values); }
+
+        BINUMS_TARGET("avx2")
+        static __m256d Add(__m256d a, __m256d b) noexcept { return _mm256_add_pd(a, b); }
+
+        BINUMS_TARGET("avx2")
+        static __m256d Subtract(__m256d a, __m256d b) noexcept { return _mm256_sub_pd(a, b); }
+    };
+
+    // The kernels below spell out each chain rather than looping over an array of them, which
+    // kept the chains in memory.
+
+    template <typename Lanes>
+    BINUMS_TARGET("avx2")
+    inline void KahanStep(/*inout*/ typename Lanes::Vector& sum, /*inout*/ typename Lanes::Vector& compensation, typename Lanes::Vector value) noexcept
+    {
+        typename Lanes::Vector const y = Lanes::Subtract(value, compensation);
+        typename Lanes::Vector const t = Lanes::Add(sum, y);
+        compensation = Lanes::Subtract(Lanes::Subtract(t, sum), y);
+        sum = t;
+    }
+
+    // Neumaier's error term computed branch free with Knuth's TwoSum, which gives the same
+    // exact error as comparing magnitudes but without the compare and blends.
+    template <typename Lanes>
+    BINUMS_TARGET("avx2")
+    inline void NeumaierStep(/*inout*/ typename Lanes::Vector& sum, /*inout*/ typename Lanes::Vector& compensation, typename Lanes::Vector value) noexcept
+    {
+        typename Lanes::Vector const t = Lanes::Add(sum, value);
+        typename Lanes::Vector const valuePart = Lanes::Subtract(t, sum);
+        typename Lanes::Vector const sumPart = Lanes::Subtract(t, valuePart);
+        typename Lanes::Vector const error = Lanes::Add(Lanes::Subtract(sum, sumPart), Lanes::Subtract(value, valuePart));
+        compensation = Lanes::Add(compensation, error);
+        sum = t;
+    }
+
+    template <typename Lanes>
+    void StoreLanes(typename Lanes::Vector const* vectors, size_t vectorCount, /*out*/ typename Lanes::ValueType* lanes) noexcept
+    {
+        std::memcpy(lanes, vectors, vectorCount * sizeof(*vectors));
+    }
+
+    // Pairwise over whole steps, keeping the lanes apart until the very end, so each block is
+    // just the naive vector loop. The count must be a multiple of the step size.
+    template <typename Lanes>
+    BINUMS_TARGET("avx2")
+    typename Lanes::Vector SumPairwiseLanesAvx2(typename Lanes::ValueType const* values, size_t count) noexcept
+    {
+        constexpr size_t stepSize = Lanes::laneCount * accumulatorCount;
+        static_assert(Lanes::laneCount == vectorLaneCount<typename Lanes::ValueType>);
+        static_assert(pairwiseBlockSize % stepSize == 0);
+
+        if (count <= pairwiseBlockSize)
+        {
+            typename Lanes::Vector sum0 = {}, sum1 = {}, sum2 = {}, sum3 = {};
+            for (size_t i = 0; i < count; i += stepSize)
+            {
+                sum0 = Lanes::Add(sum0, Lanes::Load(values + i));
+                sum1 = Lanes::Add(sum1, Lanes::Load(values + i + Lanes::laneCount));
+                sum2 = Lanes::Add(sum2, Lanes::Load(values + i + Lanes::laneCount * 2));
+                sum3 = Lanes::Add(sum3, Lanes::Load(values + i + Lanes::laneCount * 3));
+            }
+            return Lanes::Add(Lanes::Add(sum0, sum1), Lanes::Add(sum2, sum3));
+        }
+
+        size_t const half = (count / 2 + pairwiseBlockSize - 1) / pairwiseBlockSize * pairwiseBlockSize;
+        return Lanes::Add(SumPairwiseLanesAvx2<Lanes>(values, half), SumPairwiseLanesAvx2<Lanes>(values + half, count - half));
+    }
+
+    template <typename Lanes>
+    BINUMS_TARGET("avx2")
+    typename Lanes::ValueType SumPairwiseAvx2(typename Lanes::ValueType const* values, size_t count) noexcept
+    {
+        using ValueType = typename Lanes::ValueType;
+        constexpr size_t stepSize = Lanes::laneCount * accumulatorCount;
+
+        size_t const stepCount = count / stepSize * stepSize;
+        typename Lanes::Vector const sum = SumPairwiseLanesAvx2<Lanes>(values, stepCount);
+        ValueType lanes[Lanes::laneCount];
+        StoreLanes<Lanes>(&sum, 1, /*out*/ lanes);
+        return FinishPairwiseLanes(lanes, values + stepCount, count - stepCount);
+    }
+
+    template <typename Lanes>
+    BINUMS_TARGET("avx2")
+    typename Lanes::ValueType SumKahanAvx2(typename Lanes::ValueType const* values, size_t count) noexcept
+    {
+        using ValueType = typename Lanes::ValueType;
+        using Vector = typename Lanes::Vector;
+        constexpr size_t stepSize = Lanes::laneCount * accumulatorCount;
+
+        Vector sum0 = {}, sum1 = {}, sum2 = {}, sum3 = {};
+        Vector compensation0 = {}, compensation1 = {}, compensation2 = {}, compensation3 = {};
+        size_t i = 0;
+        for (; i + stepSize <= count; i += stepSize)
+        {
+            KahanStep<Lanes>(/*inout*/ sum0, /*inout*/ compensation0, Lanes::Load(values + i));
+            KahanStep<Lanes>(/*inout*/ sum1, /*inout*/ compensation1, Lanes::Load(values + i + Lanes::laneCount));
+            KahanStep<Lanes>(/*inout*/ sum2, /*inout*/ compensation2, Lanes::Load(values + i + Lanes::laneCount * 2));
+            KahanStep<Lanes>(/*inout*/ sum3, /*inout*/ compensation3, Lanes::Load(values + i + Lanes::laneCount * 3));
+        }
+
+        ValueType laneSums[stepSize], laneCompensations[stepSize];
+        Vector const sums[] = {sum0, sum1, sum2, sum3};
+        Vector const compensations[] = {compensation0, compensation1, compensation2, compensation3};
+        StoreLanes<Lanes>(sums, accumulatorCount, /*out*/ laneSums);
+        StoreLanes<Lanes>(compensations, accumulatorCount, /*out*/ laneCompensations);
+        return FinishKahanLanes(laneSums, laneCompensations, stepSize, values + i, count - i);
+    }
+
+    template <typename Lanes>
+    BINUMS_TARGET("avx2")
+    typename Lanes::ValueType SumNeumaierAvx2(typename Lanes::ValueType const* values, size_t count) noexcept
+    {
+        using ValueType = typename Lanes::ValueType;
+        using Vector = typename Lanes::Vector;
+        constexpr size_t stepSize = Lanes::laneCount * accumulatorCount;
+
+        Vector sum0 = {}, sum1 = {}, sum2 = {}, sum3 = {};
+        Vector compensation0 = {}, compensation1 = {}, compensation2 = {}, compensation3 = {};
+        size_t i = 0;
+        for (; i + stepSize <= count; i += stepSize)
+        {
+            NeumaierStep<Lanes>(/*inout*/ sum0, /*inout*/ compensation0, Lanes::Load(values + i));
+            NeumaierStep<Lanes>(/*inout*/ sum1, /*inout*/ compensation1, Lanes::Load(values + i + Lanes::laneCount));
+            NeumaierStep<Lanes>(/*inout*/ sum2, /*inout*/ compensation2, Lanes::Load(values + i + Lanes::laneCount * 2));
+            NeumaierStep<Lanes>(/*inout*/ sum3, /*inout*/ compensation3, Lanes::Load(values + i + Lanes::laneCount * 3));
+        }
+
+        ValueType laneSums[stepSize], laneCompensations[stepSize];
+        Vector const sums[] = {sum0, sum1, sum2, sum3};
+        Vector const compensations[] = {compensation0, compensation1, compensation2, compensation3};
+        StoreLanes<Lanes>(sums, accumulatorCount, /*out*/ laneSums);
+        StoreLanes<Lanes>(compensations, accumulatorCount, /*out*/ laneCompensations);
+        return FinishNeumaierLanes(laneSums, laneCompensations, stepSize, values + i, count - i);
+    }
+
+    template <typename Lanes>
+    typename Lanes::ValueType SumArrayAvx2(typename Lanes::ValueType const* values, size_t count, SummationMode mode) noexcept
+    {
+        using ValueType = typename Lanes::ValueType;
+
+        switch (mode)
+        {
+        case SummationMode::Pairwise:   return SumPairwiseAvx2<Lanes>(values, count);
+        case SummationMode::Kahan:      return SumKahanAvx2<Lanes>(values, count);
+        case SummationMode::Neumaier:   return SumNeumaierAvx2<Lanes>(values, count);
+        case SummationMode::Sequential:
+        default:                        return SumSequential<ValueType>(values, count, &Identity<ValueType>, &Identity<ValueType>);
+        }
+    }
+} // namespace SummationDetails
+
+#endif // BINUMS_X86
+
+inline float SumFloat32Array(float const* values, size_t count, SummationMode mode) noexcept
+{
+#if BINUMS_X86
+    if (GetCpuFeatures().avx2)
+    {
+        return SummationDetails::SumArrayAvx2<SummationDetails::Float32Avx2Lanes>(values, count, mode);
+    }
+#endif
+
+    return SummationDetails::SumArrayLanes(values, count, mode);
+}
+
+inline double SumFloat64Array(double const* values, size_t count, SummationMode mode) noexcept
+{
+#if BINUMS_X86
+    if (GetCpuFeatures().avx2)
+    {
+        return SummationDetails::SumArrayAvx2<SummationDetails::Float64Avx2Lanes>(values, count, mode);
+    }
+#endif
+
+    return SummationDetails::SumArrayLanes(values, count, mode);
+}
@@ -8,7 +8,33 @@
 #include <string_view>
 #include <cassert>
 #include <vector>
+#include <array>
+#include <utility>
+#include <bit>
+#include <cstring>
+#include <cmath>
+#include <optional>
+#include <charconv>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <new>
+#include <memory_resource>
+#include <mutex>
+#include <thread>
 
+#include "BiNums.h"
+#include "CpuFeatures.h"
+#include "Float16Codec.h"
+#include "Bfloat16Codec.h"
+#include "DotProduct.h"
+#include "Summation.h"
+#include "ParallelReduction.h"
+#include "EvaluationContext.h"
+#include "MappedFile.h"
+#include "SocketServer.h"
 #include "Half.h"
 #include "Int24.h"
 #include "FixedNumber.h"
@@ -16,6 +42,8 @@
 #include "Float16m7e8s1.h"
 #include "Float8m3e4s1.h"
 #include "Float8m2e5s1.h"
+#include "Float8Codec.h"
+#include "FloatNumberCodec.h"
 #include "Common.h"
 
 using float32_t = float;
@@ -35,4 +63,6 @@ static_assert(sizeof(bfloat16_t) == 2);
 #define _Null_terminated_
 #endif
 
+#include "NumberTypes.h"
+
 #endif //PCH_H